@@ -28,15 +28,16 @@ void PrintTuplesAsTable(const std::vector<storage::Tuple> &tuples) {
         widths[c] = std::max(widths[c], columns[c].name.size());
     }
 
+    // Every field is formatted once, then padded to its column's width when printed.
+    std::vector<std::string> cells;
+    cells.reserve(tuples.size() * col_count);
+    std::ostringstream oss;
     for (auto &t : tuples) {
         for (size_t c = 0; c < col_count; c++) {
-            std::string val_str = std::visit([](auto &&val) {
-                std::ostringstream oss;
-                oss << val;
-                return oss.str();
-            }, t.GetField(c));
-
-            widths[c] = std::max(widths[c], val_str.size());
+            oss.str("");
+            std::visit([&oss](auto &&val) { oss << val; }, t.GetField(c));
+            cells.push_back(oss.str());
+            widths[c] = std::max(widths[c], cells.back().size());
         }
     }
 
@@ -52,15 +53,9 @@ void PrintTuplesAsTable(const std::vector<storage::Tuple> &tuples) {
     }
     std::cout << "\n";
 
-    for (auto &t : tuples) {
+    for (size_t row = 0; row < tuples.size(); row++) {
         for (size_t c = 0; c < col_count; c++) {
-            std::string val_str = std::visit([](auto &&val) {
-                std::ostringstream oss;
-                oss << val;
-                return oss.str();
-            }, t.GetField(c));
-
-            std::cout << std::setw(static_cast<int>(widths[c])) << val_str;
+            std::cout << std::setw(static_cast<int>(widths[c])) << cells[row * col_count + c];
             if (c + 1 < col_count) std::cout << " | ";
         }
         std::cout << "\n";
@@ -69,10 +64,12 @@ void PrintTuplesAsTable(const std::vector<storage::Tuple> &tuples) {
 }
 
 
-int main() {
+int main(int argc, char* argv[]) {
     using_history();
 
-    auto catalog = std::make_shared<catalog::Catalog>();
+    std::string data_dir = argc > 1 ? argv[1] : "vovinquity_data";
+    size_t buffer_pool_size = argc > 2 ? std::stoul(argv[2]) : storage::DEFAULT_BUFFER_POOL_SIZE;
+    auto catalog = std::make_shared<catalog::Catalog>(data_dir, buffer_pool_size);
 
     planner::Planner planner(catalog);
 
@@ -115,9 +112,7 @@ int main() {
 
             auto physical_plan = planner.CreatePlan(std::move(logical_plan));
 
-            auto executor_node = executor.CreateExecutor(physical_plan.get());
-
-            auto result = executor_node->Execute();
+            auto result = executor.Execute(physical_plan.get());
 
             if (!result.empty()) PrintTuplesAsTable(result);
             else std::cout << "(no rows)\n";
@@ -1,15 +1,149 @@
 #include "catalog.h"
+#include "column_table.h"
+#include "tuple_serializer.h"
+#include "table_file.h"
+#include "crc32.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <stdexcept>
+#include <system_error>
+#include <unordered_set>
 
 namespace catalog {
-    Catalog::Catalog()
-            : next_table_id_(0), next_column_id_(0), next_index_id_(0),
+    namespace {
+        std::string PrepareDataFile(const std::string& data_dir) {
+            if (data_dir.empty()) return "";
+            std::filesystem::create_directories(data_dir);
+            return (std::filesystem::path(data_dir) / "heap.db").string();
+        }
+
+        constexpr char CHECKPOINT_MAGIC[8] = {'V', 'V', 'Q', 'C', 'K', 'P', 'T', '1'};
+
+        // The system tables are snapshotted with every checkpoint; user tables only when loaded.
+        struct CheckpointManifest {
+            uint32_t segment = 0;
+            storage::lsn_t lsn = storage::INVALID_LSN;
+            // Table name and snapshot file name, relative to the checkpoint directory.
+            std::vector<std::pair<std::string, std::string>> tables;
+        };
+
+        void AppendString(std::string& out, const std::string& value) {
+            auto length = static_cast<uint32_t>(value.size());
+            out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.append(value);
+        }
+
+        void WriteManifest(const std::filesystem::path& dir, const CheckpointManifest& manifest) {
+            std::string data(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+            auto table_count = static_cast<uint32_t>(manifest.tables.size());
+            data.append(reinterpret_cast<const char*>(&manifest.segment), sizeof(manifest.segment));
+            data.append(reinterpret_cast<const char*>(&manifest.lsn), sizeof(manifest.lsn));
+            data.append(reinterpret_cast<const char*>(&table_count), sizeof(table_count));
+            for (const auto& [table_name, file_name] : manifest.tables) {
+                AppendString(data, table_name);
+                AppendString(data, file_name);
+            }
+            uint32_t crc = common::Crc32(data.data(), data.size());
+            data.append(reinterpret_cast<const char*>(&crc), sizeof(crc));
+
+            std::string file_name = (dir / "MANIFEST").string();
+            std::string temp_file_name = file_name + ".tmp";
+            int fd = open(temp_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) throw std::system_error(errno, std::generic_category(), "Failed to write " + temp_file_name);
+            size_t done = 0;
+            while (done < data.size()) {
+                ssize_t n = write(fd, data.data() + done, data.size() - done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) {
+                    close(fd);
+                    throw std::system_error(errno, std::generic_category(), "Failed to write " + temp_file_name);
+                }
+                done += static_cast<size_t>(n);
+            }
+            if (fsync(fd) != 0) {
+                close(fd);
+                throw std::system_error(errno, std::generic_category(), "Failed to sync " + temp_file_name);
+            }
+            close(fd);
+            if (rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to rename " + temp_file_name);
+            }
+            int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+            if (dir_fd >= 0) {
+                fsync(dir_fd);
+                close(dir_fd);
+            }
+        }
+
+        bool ReadManifest(const std::filesystem::path& dir, CheckpointManifest& manifest) {
+            std::ifstream file(dir / "MANIFEST", std::ios::binary);
+            if (!file) return false;
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            const size_t fixed_size = sizeof(CHECKPOINT_MAGIC) + sizeof(uint32_t) + sizeof(storage::lsn_t) + sizeof(uint32_t);
+            uint32_t crc;
+            if (data.size() < fixed_size + sizeof(crc) || std::memcmp(data.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+                throw std::runtime_error("Corrupted checkpoint manifest");
+            }
+            std::memcpy(&crc, data.data() + data.size() - sizeof(crc), sizeof(crc));
+            data.resize(data.size() - sizeof(crc));
+            if (common::Crc32(data.data(), data.size()) != crc) throw std::runtime_error("Corrupted checkpoint manifest");
+
+            size_t pos = sizeof(CHECKPOINT_MAGIC);
+            auto take = [&](void* out, size_t size) {
+                if (pos + size > data.size()) throw std::runtime_error("Corrupted checkpoint manifest");
+                std::memcpy(out, data.data() + pos, size);
+                pos += size;
+            };
+            auto take_string = [&]() {
+                uint32_t length;
+                take(&length, sizeof(length));
+                std::string value(length, '\0');
+                take(value.data(), length);
+                return value;
+            };
+
+            uint32_t table_count;
+            take(&manifest.segment, sizeof(manifest.segment));
+            take(&manifest.lsn, sizeof(manifest.lsn));
+            take(&table_count, sizeof(table_count));
+            for (uint32_t i = 0; i < table_count; ++i) {
+                std::string table_name = take_string();
+                manifest.tables.emplace_back(table_name, take_string());
+            }
+            return true;
+        }
+
+        std::shared_ptr<storage::Table> MakeTable(const storage::Schema& schema, storage::TableStorage storage,
+                                                  std::shared_ptr<storage::BufferPoolManager> buffer_pool) {
+            if (storage == storage::TableStorage::COLUMN) return std::make_shared<storage::ColumnTable>(schema, std::move(buffer_pool));
+            return std::make_shared<storage::Table>(schema, std::move(buffer_pool));
+        }
+
+        std::string SystemTableFileName(const std::string& name, uint32_t segment) {
+            return "system_" + name + "_" + std::to_string(segment) + ".sys";
+        }
+    }
+
+    Catalog::Catalog(const std::string& data_dir, size_t buffer_pool_size, storage::LogManagerOptions log_options,
+                     CheckpointerOptions checkpoint_options)
+            : data_dir_(data_dir),
+              buffer_pool_(std::make_shared<storage::BufferPoolManager>(
+                      buffer_pool_size, std::make_shared<storage::DiskManager>(PrepareDataFile(data_dir)))),
+              checkpoint_lsn_(storage::INVALID_LSN), next_table_id_(0), next_column_id_(0), next_index_id_(0),
               tables_system_table_([]() {
                   storage::Schema schema;
                   schema.InsertColumn("table_id", storage::DataType::INTEGER);
                   schema.InsertColumn("table_name", storage::DataType::VARCHAR);
+                  schema.InsertColumn("storage", storage::DataType::INTEGER);
                   return schema;
-              }()),
+              }(), buffer_pool_),
               columns_system_table_([]() {
                   storage::Schema schema;
                   schema.InsertColumn("column_id", storage::DataType::INTEGER);
@@ -17,52 +151,247 @@ namespace catalog {
                   schema.InsertColumn("column_name", storage::DataType::VARCHAR);
                   schema.InsertColumn("data_type", storage::DataType::INTEGER);
                   return schema;
-              }()),
+              }(), buffer_pool_),
               indexes_system_table_([]() {
                   storage::Schema schema;
                   schema.InsertColumn("index_id", storage::DataType::INTEGER);
                   schema.InsertColumn("index_name", storage::DataType::VARCHAR);
                   schema.InsertColumn("table_id", storage::DataType::INTEGER);
+                  schema.InsertColumn("index_type", storage::DataType::INTEGER);
+                  schema.InsertColumn("key_column_count", storage::DataType::INTEGER);
                   return schema;
-              }()),
+              }(), buffer_pool_),
               index_columns_system_table_([]() {
                   storage::Schema schema;
                   schema.InsertColumn("index_id", storage::DataType::INTEGER);
                   schema.InsertColumn("column_id", storage::DataType::INTEGER);
                   schema.InsertColumn("ordinal_position", storage::DataType::INTEGER);
                   return schema;
-              }()) {
+              }(), buffer_pool_),
+              partitioned_tables_system_table_([]() {
+                  storage::Schema schema;
+                  schema.InsertColumn("table_id", storage::DataType::INTEGER);
+                  schema.InsertColumn("strategy", storage::DataType::INTEGER);
+                  schema.InsertColumn("column_id", storage::DataType::INTEGER);
+                  return schema;
+              }(), buffer_pool_),
+              partitions_system_table_([]() {
+                  storage::Schema schema;
+                  schema.InsertColumn("table_id", storage::DataType::INTEGER);
+                  schema.InsertColumn("parent_table_id", storage::DataType::INTEGER);
+                  schema.InsertColumn("partition_name", storage::DataType::VARCHAR);
+                  schema.InsertColumn("ordinal_position", storage::DataType::INTEGER);
+                  schema.InsertColumn("upper_bound", storage::DataType::VARCHAR);
+                  return schema;
+              }(), buffer_pool_) {
         LoadSystemTables();
+        if (!data_dir_.empty()) {
+            Recover(log_options);
+            if (checkpoint_options.interval.count() > 0) checkpointer_ = std::make_unique<Checkpointer>(*this, checkpoint_options);
+        }
     }
 
-    void Catalog::CreateTable(const std::string& table_name, const storage::Schema& schema) {
+    Catalog::~Catalog() {
+        checkpointer_.reset();
+    }
+
+    void Catalog::CreateTable(const std::string& table_name, const storage::Schema& schema, storage::TableStorage storage) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
         if (HasTable(table_name)) throw std::invalid_argument("Table already exists: " + table_name);
 
-        auto table = std::make_shared<storage::Table>(schema);
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::CREATE_TABLE;
+        record.table_name = table_name;
+        record.schema = schema;
+        record.storage = static_cast<uint8_t>(storage);
+        Log(record);
+        AddTable(table_name, schema, storage);
+    }
+
+    int Catalog::AddTable(const std::string& table_name, const storage::Schema& schema, storage::TableStorage storage) {
+        auto table = MakeTable(schema, storage, buffer_pool_);
         tables_[table_name] = table;
+        if (log_manager_) table->SetLogManager(log_manager_, table_name);
 
         int table_id = next_table_id_++;
-        tables_system_table_.AddRecord({table_id, table_name});
+        tables_system_table_.AddRecord({table_id, table_name, static_cast<int>(storage)});
 
         for (size_t i = 0; i < schema.GetColumnCount(); ++i) {
             const auto& column = schema.GetColumn(i);
             columns_system_table_.AddRecord({next_column_id_++, table_id, column.name, static_cast<int>(column.type)});
         }
+        return table_id;
+    }
+
+    void Catalog::CreatePartitionedTable(const std::string& table_name, const storage::Schema& schema,
+                                         storage::TableStorage storage, storage::PartitionScheme scheme) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        if (HasTable(table_name)) throw std::invalid_argument("Table already exists: " + table_name);
+        scheme.Validate(schema);
+        for (const auto& partition : scheme.partitions) {
+            std::string partition_table = storage::PartitionedTable::PartitionTableName(table_name, partition.name);
+            if (HasTable(partition_table)) throw std::invalid_argument("Table already exists: " + partition_table);
+        }
+
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::CREATE_TABLE;
+        record.table_name = table_name;
+        record.schema = schema;
+        record.storage = static_cast<uint8_t>(storage);
+        scheme.Serialize(record.payload);
+        Log(record);
+
+        int table_id = next_table_id_++;
+        tables_system_table_.AddRecord({table_id, table_name, static_cast<int>(storage)});
+        int partition_column_id = 0;
+        for (size_t i = 0; i < schema.GetColumnCount(); ++i) {
+            const auto& column = schema.GetColumn(i);
+            if (i == scheme.column_index) partition_column_id = next_column_id_;
+            columns_system_table_.AddRecord({next_column_id_++, table_id, column.name, static_cast<int>(column.type)});
+        }
+        partitioned_tables_system_table_.AddRecord({table_id, static_cast<int>(scheme.strategy), partition_column_id});
+
+        auto& info = partitioned_tables_[table_name];
+        info = {schema, storage, scheme, nullptr};
+        for (size_t i = 0; i < scheme.partitions.size(); ++i) {
+            AddPartitionTable(table_name, table_id, info, scheme.partitions[i], static_cast<int>(i));
+        }
+    }
+
+    void Catalog::AddPartitionTable(const std::string& table_name, int table_id, const PartitionedTableInfo& info,
+                                    const storage::PartitionDefinition& partition, int ordinal_position) {
+        std::string partition_table = storage::PartitionedTable::PartitionTableName(table_name, partition.name);
+        int partition_table_id = AddTable(partition_table, info.schema, info.storage);
+        partitions_system_table_.AddRecord({partition_table_id, table_id, partition.name, ordinal_position,
+                                            storage::FormatPartitionBound(partition.upper_bound)});
+    }
+
+    void Catalog::AddPartition(const std::string& table_name, storage::PartitionDefinition partition) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        auto it = partitioned_tables_.find(table_name);
+        if (it == partitioned_tables_.end()) throw std::invalid_argument("Table is not partitioned: " + table_name);
+        auto& info = it->second;
+        if (info.scheme.strategy != storage::PartitionStrategy::RANGE) {
+            throw std::invalid_argument("Partitions can only be added to RANGE partitioned tables");
+        }
+        std::string partition_table = storage::PartitionedTable::PartitionTableName(table_name, partition.name);
+        if (HasTable(partition_table)) throw std::invalid_argument("Table already exists: " + partition_table);
+        storage::PartitionScheme scheme = info.scheme;
+        scheme.partitions.push_back(std::move(partition));
+        scheme.Validate(info.schema);
+        const auto& added = scheme.partitions.back();
+
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::ADD_PARTITION;
+        record.table_name = table_name;
+        record.partition_name = added.name;
+        record.payload = storage::FormatPartitionBound(added.upper_bound);
+        Log(record);
+
+        int table_id = GetTableId(table_name);
+        int ordinal_position = 0;
+        for (const auto& existing : partitions_system_table_.FindRecords([&](const storage::PartitionRecord& r) {
+            return r.parent_table_id == table_id;
+        })) {
+            ordinal_position = std::max(ordinal_position, existing.ordinal_position + 1);
+        }
+        AddPartitionTable(table_name, table_id, info, added, ordinal_position);
+
+        // The new partition gets the indexes every other partition has.
+        auto partition_table_ptr = GetTable(partition_table);
+        for (const auto& index : GetTable(storage::PartitionedTable::PartitionTableName(table_name, info.scheme.partitions.front().name))
+                ->GetIndexDefinitions()) {
+            partition_table_ptr->CreateIndex(index.name, index.column_indexes, index.degree, index.type, index.include_column_indexes);
+        }
+        info.scheme = std::move(scheme);
+        info.table = nullptr;
+    }
+
+    void Catalog::DropPartition(const std::string& table_name, const std::string& partition_name) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        auto it = partitioned_tables_.find(table_name);
+        if (it == partitioned_tables_.end()) throw std::invalid_argument("Table is not partitioned: " + table_name);
+        auto& info = it->second;
+        if (info.scheme.strategy != storage::PartitionStrategy::RANGE) {
+            throw std::invalid_argument("Partitions can only be dropped from RANGE partitioned tables");
+        }
+        auto partition = info.scheme.FindPartition(partition_name);
+        if (!partition) throw std::invalid_argument("Partition not found: " + partition_name);
+        if (info.scheme.partitions.size() == 1) throw std::invalid_argument("Cannot drop the last partition of " + table_name);
+
+        std::string partition_table = storage::PartitionedTable::PartitionTableName(table_name, partition_name);
+        int partition_table_id = GetTableId(partition_table);
+        partitions_system_table_.RemoveRecords([&](const storage::PartitionRecord& record) {
+            return record.table_id == partition_table_id;
+        });
+        RemoveTable(partition_table);
+        info.scheme.partitions.erase(info.scheme.partitions.begin() + static_cast<std::ptrdiff_t>(*partition));
+        info.table = nullptr;
+
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::DROP_PARTITION;
+        record.table_name = table_name;
+        record.partition_name = partition_name;
+        Log(record);
+    }
+
+    std::shared_ptr<storage::PartitionedTable> Catalog::GetPartitionedTable(const std::string& table_name) const {
+        auto it = partitioned_tables_.find(table_name);
+        if (it == partitioned_tables_.end()) return nullptr;
+        auto& info = it->second;
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        if (!info.table) {
+            info.table = std::make_shared<storage::PartitionedTable>(
+                    info.schema, table_name, info.storage, info.scheme,
+                    [this](const std::string& partition_table) { return GetTable(partition_table); }, buffer_pool_);
+        }
+        return info.table;
     }
 
     std::shared_ptr<storage::Table> Catalog::GetTable(const std::string& table_name) const {
+        if (auto partitioned = GetPartitionedTable(table_name)) return partitioned;
         auto it = tables_.find(table_name);
         if (it == tables_.end()) throw std::invalid_argument("Table not found: " + table_name);
+        if (!it->second) LoadTable(table_name);
         return it->second;
     }
 
-    bool Catalog::HasTable(const std::string& table_name) const {
-        return tables_.find(table_name) != tables_.end();
+    storage::lsn_t Catalog::LoadTable(const std::string& table_name) const {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        auto file = snapshot_files_.find(table_name);
+        if (file == snapshot_files_.end()) return storage::INVALID_LSN;
+
+        auto table_records = tables_system_table_.FindRecords([&](const storage::TableRecord& record) {
+            return record.table_name == table_name;
+        });
+        if (table_records.empty()) throw std::runtime_error("Table not found in system tables: " + table_name);
+
+        storage::Schema schema = GetStoredSchema(table_records.front().table_id);
+        auto table = MakeTable(schema, static_cast<storage::TableStorage>(table_records.front().storage), buffer_pool_);
+        storage::lsn_t lsn = table->LoadFromFile((std::filesystem::path(data_dir_) / "checkpoint" / file->second).string());
+        if (log_manager_) table->SetLogManager(log_manager_, table_name);
+        tables_[table_name] = table;
+        snapshot_files_.erase(file);
+        return lsn;
     }
 
-    void catalog::Catalog::DropTable(const std::string& table_name) {
-        if (!HasTable(table_name)) throw std::runtime_error("Table does not exist: " + table_name);
+    storage::Schema Catalog::GetStoredSchema(int table_id) const {
+        auto column_records = columns_system_table_.FindRecords([&](const storage::ColumnRecord& record) {
+            return record.table_id == table_id;
+        });
+        std::sort(column_records.begin(), column_records.end(), [](const auto& a, const auto& b) {
+            return a.column_id < b.column_id;
+        });
+        storage::Schema schema;
+        for (const auto& column : column_records) schema.InsertColumn(column.column_name, static_cast<storage::DataType>(column.data_type));
+        return schema;
+    }
 
+    bool Catalog::HasTable(const std::string& table_name) const {
+        return tables_.find(table_name) != tables_.end() || partitioned_tables_.find(table_name) != partitioned_tables_.end();
+    }
+
+    int Catalog::GetTableId(const std::string& table_name) const {
         auto table_records = tables_system_table_.FindRecords(
                 [&](const storage::TableRecord& record) {
                     return record.table_name == table_name;
@@ -70,9 +399,50 @@ namespace catalog {
         );
 
         if (table_records.empty()) throw std::runtime_error("Table not found in system tables: " + table_name);
+        return table_records.front().table_id;
+    }
+
+    void catalog::Catalog::DropTable(const std::string& table_name) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
+        if (!HasTable(table_name)) throw std::runtime_error("Table does not exist: " + table_name);
+
+        int table_id = GetTableId(table_name);
+        if (!partitions_system_table_.FindRecords([&](const storage::PartitionRecord& record) {
+            return record.table_id == table_id;
+        }).empty()) {
+            throw std::invalid_argument(table_name + " is a partition; drop it with ALTER TABLE ... DROP PARTITION");
+        }
+
+        auto partitioned = partitioned_tables_.find(table_name);
+        if (partitioned != partitioned_tables_.end()) {
+            for (const auto& partition : partitioned->second.scheme.partitions) {
+                RemoveTable(storage::PartitionedTable::PartitionTableName(table_name, partition.name));
+            }
+            partitions_system_table_.RemoveRecords([&](const storage::PartitionRecord& record) {
+                return record.parent_table_id == table_id;
+            });
+            partitioned_tables_system_table_.RemoveRecords([&](const storage::PartitionedTableRecord& record) {
+                return record.table_id == table_id;
+            });
+            partitioned_tables_.erase(partitioned);
+        }
+        RemoveTable(table_name);
+
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::DROP_TABLE;
+        record.table_name = table_name;
+        Log(record);
+    }
 
-        int table_id = table_records[0].table_id;
+    void Catalog::RemoveTable(const std::string& table_name) {
+        int table_id = GetTableId(table_name);
 
+        std::unordered_set<int> index_ids;
+        for (const auto& index_record : indexes_system_table_.FindRecords([&](const storage::IndexRecord& record) {
+            return record.table_id == table_id;
+        })) {
+            index_ids.insert(index_record.index_id);
+        }
         indexes_system_table_.RemoveRecords(
                 [&](const storage::IndexRecord& record) {
                     return record.table_id == table_id;
@@ -80,7 +450,12 @@ namespace catalog {
         );
         index_columns_system_table_.RemoveRecords(
                 [&](const storage::IndexColumnRecord& record) {
-                    return record.index_id == table_id;
+                    return index_ids.count(record.index_id) > 0;
+                }
+        );
+        columns_system_table_.RemoveRecords(
+                [&](const storage::ColumnRecord& record) {
+                    return record.table_id == table_id;
                 }
         );
         tables_system_table_.RemoveRecords(
@@ -89,15 +464,40 @@ namespace catalog {
                 }
         );
         tables_.erase(table_name);
+        snapshot_files_.erase(table_name);
     }
 
 
-    template<typename KeyType>
-    void Catalog::CreateIndex(const std::string& index_name, const std::string& table_name, size_t column_index, int degree) {
+    void Catalog::CreateIndex(const std::string& index_name, const std::string& table_name, const std::vector<size_t>& column_indexes,
+                              int degree, storage::IndexType type, const std::vector<size_t>& include_columns) {
+        std::lock_guard<std::recursive_mutex> lock(latch_);
         if (!HasTable(table_name)) throw std::invalid_argument("Table not found: " + table_name);
 
+        if (auto partitioned = GetPartitionedTable(table_name)) {
+            for (size_t partition = 0; partition < partitioned->GetPartitionCount(); ++partition) {
+                partitioned->GetPartition(partition)->CreateIndex(index_name, column_indexes, degree, type, include_columns);
+            }
+        } else {
+            GetTable(table_name)->CreateIndex(index_name, column_indexes, degree, type, include_columns);
+        }
+        RegisterIndex(index_name, table_name, column_indexes, include_columns, type);
+
+        storage::LogRecord record;
+        record.type = storage::LogRecordType::CREATE_INDEX;
+        record.table_name = table_name;
+        record.index_name = index_name;
+        record.column_indexes = column_indexes;
+        record.include_column_indexes = include_columns;
+        record.degree = degree;
+        record.index_type = type;
+        Log(record);
+    }
+
+    void Catalog::RegisterIndex(const std::string& index_name, const std::string& table_name, const std::vector<size_t>& key_columns,
+                                const std::vector<size_t>& include_columns, storage::IndexType type) {
+        std::vector<size_t> column_indexes = key_columns;
+        column_indexes.insert(column_indexes.end(), include_columns.begin(), include_columns.end());
         auto table = GetTable(table_name);
-        table->CreateIndex<KeyType>(index_name, column_index, degree);
         int index_id = next_index_id_++;
 
         auto table_records = tables_system_table_.FindRecords([&](const storage::TableRecord& record) {
@@ -107,17 +507,19 @@ namespace catalog {
         if (table_records.empty()) throw std::invalid_argument("Table not found in system table: " + table_name);
 
         int table_id = table_records.front().table_id;
-        indexes_system_table_.AddRecord({index_id, index_name, table_id});
-        const auto& column = table->GetSchema().GetColumn(column_index);
+        indexes_system_table_.AddRecord({index_id, index_name, table_id, static_cast<int>(type), static_cast<int>(key_columns.size())});
+        for (size_t position = 0; position < column_indexes.size(); ++position) {
+            const auto& column = table->GetSchema().GetColumn(column_indexes[position]);
 
-        auto column_records = columns_system_table_.FindRecords([&](const storage::ColumnRecord& record) {
-            return record.table_id == table_id && record.column_name == column.name;
-        });
+            auto column_records = columns_system_table_.FindRecords([&](const storage::ColumnRecord& record) {
+                return record.table_id == table_id && record.column_name == column.name;
+            });
 
-        if (column_records.empty()) throw std::invalid_argument("Column not found in system table: " + column.name);
+            if (column_records.empty()) throw std::invalid_argument("Column not found in system table: " + column.name);
 
-        int column_id = column_records.front().column_id;
-        index_columns_system_table_.AddRecord({index_id, column_id, 1});
+            int column_id = column_records.front().column_id;
+            index_columns_system_table_.AddRecord({index_id, column_id, static_cast<int>(position) + 1});
+        }
     }
 
     std::vector<std::pair<storage::IndexRecord, std::vector<std::string>>> Catalog::GetIndexesForTable(const std::string &table_name) const {
@@ -143,6 +545,10 @@ namespace catalog {
                     [&](const storage::IndexColumnRecord& record) {
                         return record.index_id == index_id;
                     });
+            std::sort(index_columns.begin(), index_columns.end(),
+                      [](const storage::IndexColumnRecord& a, const storage::IndexColumnRecord& b) {
+                          return a.ordinal_position < b.ordinal_position;
+                      });
             std::vector<std::string> column_names;
             for (const auto& index_column : index_columns) {
                 int column_id = index_column.column_id;
@@ -175,16 +581,221 @@ namespace catalog {
         return index_columns_system_table_;
     }
 
+    const storage::GenericSystemTable<storage::PartitionedTableRecord>& Catalog::GetPartitionedTablesSystemTable() const {
+        return partitioned_tables_system_table_;
+    }
+
+    const storage::GenericSystemTable<storage::PartitionRecord>& Catalog::GetPartitionsSystemTable() const {
+        return partitions_system_table_;
+    }
+
+
+    std::shared_ptr<storage::BufferPoolManager> Catalog::GetBufferPool() const {
+        return buffer_pool_;
+    }
+
+    std::shared_ptr<storage::LogManager> Catalog::GetLogManager() const {
+        return log_manager_;
+    }
+
+    void Catalog::Commit() const {
+        if (log_manager_) log_manager_->Commit(log_manager_->GetLastLsn());
+    }
+
+    void Catalog::Log(storage::LogRecord& record) {
+        if (log_manager_) log_manager_->Append(record);
+    }
+
+    storage::lsn_t Catalog::Checkpoint() {
+        if (!log_manager_) throw std::runtime_error("Checkpoints require a data directory");
+        std::lock_guard<std::mutex> checkpoint_lock(checkpoint_latch_);
+
+        // Every record before the new segment is either DDL covered by the table set below
+        // or a change to a table that its snapshot already contains.
+        CheckpointManifest manifest;
+        std::vector<std::pair<std::string, std::shared_ptr<storage::Table>>> tables;
+        {
+            std::lock_guard<std::recursive_mutex> lock(latch_);
+            manifest.segment = log_manager_->Rotate();
+            manifest.lsn = log_manager_->GetLastLsn();
+            SaveSystemTables(manifest.segment);
+            for (const auto& [table_name, table] : tables_) {
+                if (!table) {
+                    // Never loaded, so its previous snapshot is still current.
+                    manifest.tables.emplace_back(table_name, snapshot_files_.at(table_name));
+                    continue;
+                }
+                table->BeginSnapshot();
+                tables.emplace_back(table_name, table);
+            }
+        }
+
+        std::filesystem::path dir = std::filesystem::path(data_dir_) / "checkpoint";
+        size_t written = 0;
+        try {
+            for (; written < tables.size(); ++written) {
+                const auto& [table_name, table] = tables[written];
+                std::string file_name = table_name + "_" + std::to_string(manifest.segment) + ".tbl";
+                table->WriteSnapshot((dir / file_name).string());
+                table->EndSnapshot();
+                manifest.tables.emplace_back(table_name, file_name);
+            }
+        } catch (...) {
+            for (; written < tables.size(); ++written) tables[written].second->EndSnapshot();
+            throw;
+        }
+        WriteManifest(dir, manifest);
+
+        std::unordered_set<std::string> current_files = {"MANIFEST"};
+        for (const char* name : {"tables", "columns", "indexes", "index_columns", "partitioned_tables", "partitions"}) current_files.insert(SystemTableFileName(name, manifest.segment));
+        for (const auto& [table_name, file_name] : manifest.tables) current_files.insert(file_name);
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (!current_files.count(entry.path().filename().string())) std::filesystem::remove(entry.path());
+        }
+        log_manager_->RemoveSegmentsBefore(manifest.segment);
+        return manifest.lsn;
+    }
+
+    void Catalog::Recover(const storage::LogManagerOptions& log_options) {
+        std::unordered_map<std::string, storage::lsn_t> table_lsns;
+        storage::lsn_t last_lsn = checkpoint_lsn_;
+        for (uint32_t segment : storage::LogManager::ListSegments(data_dir_)) {
+            std::string log_file = storage::LogManager::SegmentFileName(data_dir_, segment);
+            storage::lsn_t segment_lsn = storage::LogManager::ReadLog(log_file, [&](const storage::LogRecord& record) {
+                if (record.lsn <= checkpoint_lsn_) return;
+                if (record.type == storage::LogRecordType::DROP_TABLE) {
+                    table_lsns.erase(record.table_name);
+                } else if (record.type != storage::LogRecordType::CREATE_TABLE) {
+                    // Only tables the log touches are loaded here; the rest wait for their first access.
+                    if (snapshot_files_.count(record.table_name)) table_lsns[record.table_name] = LoadTable(record.table_name);
+                    auto it = table_lsns.find(record.table_name);
+                    if (it != table_lsns.end() && record.lsn <= it->second) return;
+                }
+                ApplyLogRecord(record);
+            });
+            last_lsn = std::max(last_lsn, segment_lsn);
+        }
+
+        log_manager_ = std::make_shared<storage::LogManager>(data_dir_, last_lsn + 1, log_options);
+        for (auto& [table_name, table] : tables_) {
+            if (table) table->SetLogManager(log_manager_, table_name);
+        }
+    }
+
+    void Catalog::ApplyLogRecord(const storage::LogRecord& record) {
+        switch (record.type) {
+            case storage::LogRecordType::CREATE_TABLE:
+                if (!record.payload.empty()) {
+                    CreatePartitionedTable(record.table_name, record.schema, static_cast<storage::TableStorage>(record.storage),
+                                           storage::PartitionScheme::Deserialize(record.payload, record.schema));
+                    return;
+                }
+                CreateTable(record.table_name, record.schema, static_cast<storage::TableStorage>(record.storage));
+                return;
+            case storage::LogRecordType::DROP_TABLE:
+                DropTable(record.table_name);
+                return;
+            case storage::LogRecordType::CREATE_INDEX:
+                CreateIndex(record.index_name, record.table_name, record.column_indexes, record.degree, record.index_type,
+                            record.include_column_indexes);
+                return;
+            case storage::LogRecordType::ADD_PARTITION: {
+                const auto& info = partitioned_tables_.at(record.table_name);
+                storage::DataType type = info.schema.GetColumn(info.scheme.column_index).type;
+                AddPartition(record.table_name, {record.partition_name, storage::ParsePartitionBound(record.payload, type)});
+                return;
+            }
+            case storage::LogRecordType::DROP_PARTITION:
+                DropPartition(record.table_name, record.partition_name);
+                return;
+            default:
+                break;
+        }
+
+        auto table = GetTable(record.table_name);
+        const auto& schema = table->GetSchema();
+        switch (record.type) {
+            case storage::LogRecordType::INSERT: {
+                auto fields = storage::TupleSerializer::Deserialize(schema, record.payload.data(), record.payload.size());
+                table->InsertTupleAt(record.rid, fields);
+                break;
+            }
+            case storage::LogRecordType::UPDATE: {
+                auto fields = storage::TupleSerializer::Deserialize(schema, record.payload.data(), record.payload.size());
+                table->UpdateTuple(record.rid, fields);
+                break;
+            }
+            case storage::LogRecordType::DELETE:
+                table->RemoveTuple(record.rid);
+                break;
+            default:
+                break;
+        }
+    }
 
     void Catalog::LoadSystemTables() {
-        // todo
+        if (data_dir_.empty()) return;
+        std::filesystem::path dir = std::filesystem::path(data_dir_) / "checkpoint";
+        CheckpointManifest manifest;
+        if (!ReadManifest(dir, manifest)) return;
+
+        tables_system_table_.LoadFromFile((dir / SystemTableFileName("tables", manifest.segment)).string());
+        columns_system_table_.LoadFromFile((dir / SystemTableFileName("columns", manifest.segment)).string());
+        indexes_system_table_.LoadFromFile((dir / SystemTableFileName("indexes", manifest.segment)).string());
+        index_columns_system_table_.LoadFromFile((dir / SystemTableFileName("index_columns", manifest.segment)).string());
+        // Checkpoints taken before tables could be partitioned have no partition system tables.
+        if (std::filesystem::exists(dir / SystemTableFileName("partitions", manifest.segment))) {
+            partitioned_tables_system_table_.LoadFromFile((dir / SystemTableFileName("partitioned_tables", manifest.segment)).string());
+            partitions_system_table_.LoadFromFile((dir / SystemTableFileName("partitions", manifest.segment)).string());
+        }
+
+        for (const auto& record : tables_system_table_.GetAllRecords()) next_table_id_ = std::max(next_table_id_, record.table_id + 1);
+        for (const auto& record : columns_system_table_.GetAllRecords()) next_column_id_ = std::max(next_column_id_, record.column_id + 1);
+        for (const auto& record : indexes_system_table_.GetAllRecords()) next_index_id_ = std::max(next_index_id_, record.index_id + 1);
+
+        for (const auto& [table_name, file_name] : manifest.tables) {
+            tables_[table_name] = nullptr;
+            snapshot_files_[table_name] = file_name;
+        }
+
+        for (const auto& partitioned : partitioned_tables_system_table_.GetAllRecords()) {
+            auto table_records = tables_system_table_.FindRecords([&](const storage::TableRecord& record) {
+                return record.table_id == partitioned.table_id;
+            });
+            if (table_records.empty()) throw std::runtime_error("Partitioned table not found in system tables");
+
+            PartitionedTableInfo info{GetStoredSchema(partitioned.table_id),
+                                      static_cast<storage::TableStorage>(table_records.front().storage), {}, nullptr};
+            info.scheme.strategy = static_cast<storage::PartitionStrategy>(partitioned.strategy);
+            auto column_records = columns_system_table_.FindRecords([&](const storage::ColumnRecord& record) {
+                return record.table_id == partitioned.table_id && record.column_id < partitioned.column_id;
+            });
+            info.scheme.column_index = column_records.size();
+
+            auto partition_records = partitions_system_table_.FindRecords([&](const storage::PartitionRecord& record) {
+                return record.parent_table_id == partitioned.table_id;
+            });
+            std::sort(partition_records.begin(), partition_records.end(), [](const auto& a, const auto& b) {
+                return a.ordinal_position < b.ordinal_position;
+            });
+            storage::DataType type = info.schema.GetColumn(info.scheme.column_index).type;
+            for (const auto& partition : partition_records) {
+                info.scheme.partitions.push_back({partition.partition_name, storage::ParsePartitionBound(partition.upper_bound, type)});
+            }
+            partitioned_tables_[table_records.front().table_name] = std::move(info);
+        }
+        checkpoint_lsn_ = manifest.lsn;
     }
 
-    void Catalog::SaveSystemTables() const {
-        // todo
+    void Catalog::SaveSystemTables(uint32_t segment) const {
+        std::filesystem::path dir = std::filesystem::path(data_dir_) / "checkpoint";
+        std::filesystem::create_directories(dir);
+        tables_system_table_.SaveToFile((dir / SystemTableFileName("tables", segment)).string());
+        columns_system_table_.SaveToFile((dir / SystemTableFileName("columns", segment)).string());
+        indexes_system_table_.SaveToFile((dir / SystemTableFileName("indexes", segment)).string());
+        index_columns_system_table_.SaveToFile((dir / SystemTableFileName("index_columns", segment)).string());
+        partitioned_tables_system_table_.SaveToFile((dir / SystemTableFileName("partitioned_tables", segment)).string());
+        partitions_system_table_.SaveToFile((dir / SystemTableFileName("partitions", segment)).string());
     }
 
-    template void Catalog::CreateIndex<int>(const std::string&, const std::string&, size_t, int);
-    template void Catalog::CreateIndex<double>(const std::string&, const std::string&, size_t, int);
-    template void Catalog::CreateIndex<std::string>(const std::string&, const std::string&, size_t, int);
 }
@@ -3,45 +3,123 @@
 #include "generic_system_table.h"
 #include "schema.h"
 #include "table.h"
+#include "partitioned_table.h"
+#include "log_manager.h"
+#include "checkpointer.h"
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace catalog {
     class Catalog {
     public:
-        Catalog();
-        ~Catalog() = default;
+        // An empty data directory keeps everything in memory without a write-ahead log.
+        explicit Catalog(const std::string& data_dir = "", size_t buffer_pool_size = storage::DEFAULT_BUFFER_POOL_SIZE,
+                         storage::LogManagerOptions log_options = {}, CheckpointerOptions checkpoint_options = {});
+        ~Catalog();
 
-        void CreateTable(const std::string& table_name, const storage::Schema& schema);
+        void CreateTable(const std::string& table_name, const storage::Schema& schema,
+                         storage::TableStorage storage = storage::TableStorage::ROW);
         std::shared_ptr<storage::Table> GetTable(const std::string& table_name) const;
         bool HasTable(const std::string& table_name) const;
         void DropTable(const std::string& table_name);
 
-        template<typename KeyType>
-        void CreateIndex(const std::string& index_name, const std::string& table_name, size_t column_index, int degree);
+        /*
+         * A partitioned table is created together with its partitions, each a table named
+         * <table_name>.<partition> (see PartitionedTable). Partitions can be added to and dropped
+         * from RANGE partitioned tables; dropping one releases its storage instead of deleting
+         * its rows. Indexes of a partitioned table are kept per partition.
+         */
+        void CreatePartitionedTable(const std::string& table_name, const storage::Schema& schema,
+                                    storage::TableStorage storage, storage::PartitionScheme scheme);
+        void AddPartition(const std::string& table_name, storage::PartitionDefinition partition);
+        void DropPartition(const std::string& table_name, const std::string& partition_name);
+        // Null when the table is not partitioned.
+        std::shared_ptr<storage::PartitionedTable> GetPartitionedTable(const std::string& table_name) const;
+
+        // column_indexes are the key columns in key order; entries are ordered by them lexicographically.
+        // include_columns are stored in the entries as well, after the key.
+        void CreateIndex(const std::string& index_name, const std::string& table_name, const std::vector<size_t>& column_indexes,
+                         int degree, storage::IndexType type = storage::IndexType::BTREE,
+                         const std::vector<size_t>& include_columns = {});
+        // Each index with all of its columns in ordinal order: the key columns first, then the included ones.
         std::vector<std::pair<storage::IndexRecord, std::vector<std::string>>> GetIndexesForTable(const std::string& table_name) const;
 
         const storage::GenericSystemTable<storage::TableRecord>& GetTablesSystemTable() const;
         const storage::GenericSystemTable<storage::ColumnRecord>& GetColumnsSystemTable() const;
         const storage::GenericSystemTable<storage::IndexRecord>& GetIndexesSystemTable() const;
         const storage::GenericSystemTable<storage::IndexColumnRecord>& GetIndexColumnsSystemTable() const;
+        const storage::GenericSystemTable<storage::PartitionedTableRecord>& GetPartitionedTablesSystemTable() const;
+        const storage::GenericSystemTable<storage::PartitionRecord>& GetPartitionsSystemTable() const;
+
 
+        std::shared_ptr<storage::BufferPoolManager> GetBufferPool() const;
+        std::shared_ptr<storage::LogManager> GetLogManager() const;
+        void Commit() const;
 
+        /*
+         * Snapshots every table into <data_dir>/checkpoint and deletes the log segments
+         * the snapshots make redundant. Tables are copied page by page while inserts,
+         * updates and deletes keep running; only DDL waits. Returns the checkpoint LSN.
+         */
+        storage::lsn_t Checkpoint();
+
+        // The system tables are persisted with each checkpoint, see Checkpoint().
         void LoadSystemTables();
-        void SaveSystemTables() const;
+        void SaveSystemTables(uint32_t segment) const;
 
     private:
+        std::string data_dir_;
+        std::shared_ptr<storage::BufferPoolManager> buffer_pool_;
+        std::shared_ptr<storage::LogManager> log_manager_;
+
         storage::GenericSystemTable<storage::TableRecord> tables_system_table_;
         storage::GenericSystemTable<storage::ColumnRecord> columns_system_table_;
         storage::GenericSystemTable<storage::IndexRecord> indexes_system_table_;
         storage::GenericSystemTable<storage::IndexColumnRecord> index_columns_system_table_;
+        storage::GenericSystemTable<storage::PartitionedTableRecord> partitioned_tables_system_table_;
+        storage::GenericSystemTable<storage::PartitionRecord> partitions_system_table_;
 
-        std::unordered_map<std::string, std::shared_ptr<storage::Table>> tables_;
+        // A null entry is a table whose rows are still only in its checkpoint snapshot.
+        mutable std::unordered_map<std::string, std::shared_ptr<storage::Table>> tables_;
+        mutable std::unordered_map<std::string, std::string> snapshot_files_;
+
+        // Partitioned tables hold no rows and are not checkpointed; their partitions are in tables_.
+        struct PartitionedTableInfo {
+            storage::Schema schema;
+            storage::TableStorage storage;
+            storage::PartitionScheme scheme;
+            // Built on first use and again after every change to the partitions.
+            std::shared_ptr<storage::PartitionedTable> table;
+        };
+        mutable std::unordered_map<std::string, PartitionedTableInfo> partitioned_tables_;
+        storage::lsn_t checkpoint_lsn_;
 
         int next_table_id_;
         int next_column_id_;
         int next_index_id_;
+
+        // Held by DDL, lazy table loads and a checkpoint while it fixes the set of tables to snapshot.
+        mutable std::recursive_mutex latch_;
+        std::mutex checkpoint_latch_;
+        std::unique_ptr<Checkpointer> checkpointer_;
+
+        void Recover(const storage::LogManagerOptions& log_options);
+        // Loads a table from its checkpoint snapshot and returns the snapshot's LSN.
+        storage::lsn_t LoadTable(const std::string& table_name) const;
+        // Creates the table and its system table records without logging; returns the table id.
+        int AddTable(const std::string& table_name, const storage::Schema& schema, storage::TableStorage storage);
+        // Drops the table and its system table records without logging.
+        void RemoveTable(const std::string& table_name);
+        int GetTableId(const std::string& table_name) const;
+        storage::Schema GetStoredSchema(int table_id) const;
+        void AddPartitionTable(const std::string& table_name, int table_id, const PartitionedTableInfo& info,
+                               const storage::PartitionDefinition& partition, int ordinal_position);
+        void RegisterIndex(const std::string& index_name, const std::string& table_name, const std::vector<size_t>& column_indexes,
+                           const std::vector<size_t>& include_columns, storage::IndexType type);
+        void ApplyLogRecord(const storage::LogRecord& record);
+        void Log(storage::LogRecord& record);
     };
 
 }
@@ -0,0 +1,40 @@
+#include "checkpointer.h"
+#include "catalog.h"
+#include <exception>
+#include <iostream>
+
+namespace catalog {
+    Checkpointer::Checkpointer(Catalog& catalog, CheckpointerOptions options)
+            : catalog_(catalog), options_(options), stop_(false) {
+        thread_ = std::thread(&Checkpointer::Run, this);
+    }
+
+    Checkpointer::~Checkpointer() {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            stop_ = true;
+        }
+        stop_cv_.notify_one();
+        thread_.join();
+    }
+
+    void Checkpointer::Run() {
+        auto last_checkpoint = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(latch_);
+        while (!stop_cv_.wait_for(lock, options_.poll_interval, [this] { return stop_; })) {
+            auto stats = catalog_.GetLogManager()->GetStats();
+            bool log_grown = stats.segment_bytes >= options_.log_size_threshold;
+            bool interval_elapsed = std::chrono::steady_clock::now() - last_checkpoint >= options_.interval;
+            if (stats.segment_bytes == 0 || (!log_grown && !interval_elapsed)) continue;
+
+            lock.unlock();
+            try {
+                catalog_.Checkpoint();
+            } catch (const std::exception& e) {
+                std::cerr << "Checkpoint failed: " << e.what() << std::endl;
+            }
+            last_checkpoint = std::chrono::steady_clock::now();
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace catalog {
+    class Catalog;
+
+    struct CheckpointerOptions {
+        // A zero interval disables the background thread; CHECKPOINT still works.
+        std::chrono::milliseconds interval{60000};
+        uint64_t log_size_threshold = 64ull << 20;
+        std::chrono::milliseconds poll_interval{1000};
+    };
+
+    // Checkpoints the catalog periodically, or sooner once the log has grown past the threshold.
+    class Checkpointer {
+    public:
+        Checkpointer(Catalog& catalog, CheckpointerOptions options);
+        ~Checkpointer();
+
+        Checkpointer(const Checkpointer&) = delete;
+        Checkpointer& operator=(const Checkpointer&) = delete;
+
+    private:
+        Catalog& catalog_;
+        CheckpointerOptions options_;
+        bool stop_;
+        std::mutex latch_;
+        std::condition_variable stop_cv_;
+        std::thread thread_;
+
+        void Run();
+    };
+}
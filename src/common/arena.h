@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace common {
+    /*
+     * Bump allocator: memory is carved from large blocks and only given back all at once, by Release()
+     * or the destructor. Freeing a single allocation is a no-op, so pmr containers built on an arena
+     * never call free in the loops that fill them.
+     * Not thread-safe; memory already handed out may be read concurrently while another thread allocates.
+     */
+    class Arena : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            auto address = reinterpret_cast<uintptr_t>(cursor_);
+            size_t padding = (alignment - address % alignment) % alignment;
+            if (blocks_.empty() || padding + size > static_cast<size_t>(end_ - cursor_)) {
+                NewBlock(size + alignment);
+                address = reinterpret_cast<uintptr_t>(cursor_);
+                padding = (alignment - address % alignment) % alignment;
+            }
+            char* result = cursor_ + padding;
+            cursor_ = result + size;
+            bytes_used_ += size;
+            return result;
+        }
+
+        // Copies value into the arena; the view stays valid until the arena is released.
+        std::string_view CopyString(std::string_view value) {
+            if (value.empty()) return {};
+            char* data = static_cast<char*>(Allocate(value.size(), 1));
+            std::memcpy(data, value.data(), value.size());
+            return {data, value.size()};
+        }
+
+        // Frees everything allocated so far. The first block is kept for reuse.
+        void Release() {
+            if (blocks_.size() > 1) blocks_.erase(blocks_.begin() + 1, blocks_.end());
+            if (!blocks_.empty()) {
+                cursor_ = blocks_.front().data.get();
+                end_ = cursor_ + blocks_.front().size;
+            }
+            bytes_used_ = 0;
+        }
+
+        [[nodiscard]] size_t GetBytesUsed() const { return bytes_used_; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override { return Allocate(bytes, alignment); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    private:
+        struct Block {
+            std::unique_ptr<char[]> data;
+            size_t size;
+        };
+
+        size_t block_size_;
+        std::vector<Block> blocks_;
+        char* cursor_ = nullptr;
+        char* end_ = nullptr;
+        size_t bytes_used_ = 0;
+
+        void NewBlock(size_t min_size) {
+            // Blocks grow with the arena so large queries need few of them.
+            size_t size = std::max({block_size_, min_size, blocks_.empty() ? 0 : blocks_.back().size * 2});
+            blocks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+            cursor_ = blocks_.back().data.get();
+            end_ = cursor_ + size;
+        }
+    };
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace common {
+    namespace detail {
+        constexpr std::array<uint32_t, 256> MakeCrc32Table() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        inline constexpr std::array<uint32_t, 256> CRC32_TABLE = MakeCrc32Table();
+    }
+
+    // Standard CRC-32 (IEEE 802.3). Pass the previous result as `crc` to checksum data in pieces.
+    inline uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) crc = detail::CRC32_TABLE[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+        return ~crc;
+    }
+}
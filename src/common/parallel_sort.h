@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace common {
+    /*
+     * Sorts runs of the vector on separate threads, then merges neighbouring runs in rounds, each
+     * round's merges again running in parallel. Not stable. Small inputs are sorted on the calling thread.
+     */
+    template<typename T>
+    void ParallelSort(std::vector<T>& values, size_t threads = 0) {
+        static constexpr size_t MIN_RUN = 1 << 16;
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, values.size() / MIN_RUN);
+        if (threads <= 1) {
+            std::sort(values.begin(), values.end());
+            return;
+        }
+
+        std::vector<size_t> bounds;
+        for (size_t i = 0; i <= threads; ++i) bounds.push_back(values.size() * i / threads);
+
+        auto begin = values.begin();
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([&, i] { std::sort(begin + bounds[i], begin + bounds[i + 1]); });
+        }
+        for (auto& worker : workers) worker.join();
+
+        while (bounds.size() > 2) {
+            std::vector<size_t> merged{0};
+            workers.clear();
+            for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+                workers.emplace_back([&, i] { std::inplace_merge(begin + bounds[i], begin + bounds[i + 1], begin + bounds[i + 2]); });
+                merged.push_back(bounds[i + 2]);
+            }
+            if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+            for (auto& worker : workers) worker.join();
+            bounds = std::move(merged);
+        }
+    }
+}
@@ -15,12 +15,12 @@ namespace executor {
             case planner::SORT_STATEMENT: {
                 auto sort_plan = dynamic_cast<planner::SortNode*>(plan);
                 auto child_executor = CreateExecutor(sort_plan->GetChildren()[0].get());
-                return std::make_unique<SortExecutor>(sort_plan, std::move(child_executor));
+                return std::make_unique<SortExecutor>(sort_plan, std::move(child_executor), query_arena_);
             }
             case planner::AGGREGATE_STATEMENT: {
                 auto agg_plan = dynamic_cast<planner::AggregateNode*>(plan);
                 auto child_executor = CreateExecutor(agg_plan->GetChildren()[0].get());
-                return std::make_unique<AggregateExecutor>(agg_plan, std::move(child_executor), catalog_);
+                return std::make_unique<AggregateExecutor>(agg_plan, std::move(child_executor), catalog_, query_arena_);
             }
             case planner::CREATE_TABLE_STATEMENT: {
                 auto create_table_plan = dynamic_cast<planner::CreateTableNode*>(plan);
@@ -30,9 +30,53 @@ namespace executor {
                 auto insert_plan = dynamic_cast<planner::InsertNode*>(plan);
                 return std::make_unique<InsertExecutor>(insert_plan, catalog_);
             }
+            case planner::SHOW_BUFFER_POOL_STATEMENT: {
+                auto show_plan = dynamic_cast<planner::ShowBufferPoolNode*>(plan);
+                return std::make_unique<ShowBufferPoolExecutor>(show_plan, catalog_);
+            }
+            case planner::CHECKPOINT_STATEMENT: {
+                auto checkpoint_plan = dynamic_cast<planner::CheckpointNode*>(plan);
+                return std::make_unique<CheckpointExecutor>(checkpoint_plan, catalog_);
+            }
+            case planner::VACUUM_STATEMENT: {
+                auto vacuum_plan = dynamic_cast<planner::VacuumNode*>(plan);
+                return std::make_unique<VacuumExecutor>(vacuum_plan, catalog_);
+            }
+            case planner::ALTER_TABLE_STATEMENT: {
+                auto alter_plan = dynamic_cast<planner::AlterTableNode*>(plan);
+                return std::make_unique<AlterTableExecutor>(alter_plan, catalog_);
+            }
+            case planner::COPY_STATEMENT: {
+                auto copy_plan = dynamic_cast<planner::CopyNode*>(plan);
+                return std::make_unique<CopyExecutor>(copy_plan, catalog_);
+            }
+            case planner::INDEX_SCAN_STATEMENT: {
+                auto index_scan_plan = dynamic_cast<planner::IndexScanNode*>(plan);
+                return std::make_unique<IndexScanExecutor>(index_scan_plan, catalog_);
+            }
+            case planner::CREATE_INDEX_STATEMENT: {
+                auto create_index_plan = dynamic_cast<planner::CreateIndexNode*>(plan);
+                return std::make_unique<CreateIndexExecutor>(create_index_plan, catalog_);
+            }
+            case planner::COPY_TO_STATEMENT: {
+                auto copy_plan = dynamic_cast<planner::CopyToNode*>(plan);
+                auto child_executor = CreateExecutor(copy_plan->GetChildren()[0].get());
+                return std::make_unique<CopyToExecutor>(copy_plan, std::move(child_executor), catalog_);
+            }
             default:
                 throw std::runtime_error("Unsupported plan node type");
         }
     }
 
+    std::vector<storage::Tuple> Executor::Execute(planner::PlanNode* plan) {
+        try {
+            auto result = CreateExecutor(plan)->Execute();
+            query_arena_.Release();
+            return result;
+        } catch (...) {
+            query_arena_.Release();
+            throw;
+        }
+    }
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "arena.h"
 #include "planner.h"
 #include "executor_nodes.h"
 #include "catalog.h"
@@ -11,9 +12,13 @@ namespace executor {
         explicit Executor(std::shared_ptr<catalog::Catalog> catalog)
                 : catalog_(std::move(catalog)) {}
         std::unique_ptr<ExecutorNode> CreateExecutor(planner::PlanNode* plan);
+        // Runs plan to completion. Scratch memory its operators took from the query arena is
+        // released in one go once the result is built.
+        std::vector<storage::Tuple> Execute(planner::PlanNode* plan);
 
     private:
         std::shared_ptr<catalog::Catalog> catalog_;
+        common::Arena query_arena_;
     };
 
 }
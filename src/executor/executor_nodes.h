@@ -1,16 +1,23 @@
 #pragma once
 
+#include "arena.h"
 #include "planner.h"
 #include "tuple.h"
-#include "regex"
 #include "bplus_index.h"
+#include "index_key.h"
 #include "schema.h"
 #include <stdexcept>
 #include <limits>
 #include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <unordered_map>
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <optional>
 #include <iostream>
+#include <thread>
 
 namespace executor {
     class ExecutorNode {
@@ -28,51 +35,118 @@ namespace executor {
         SelectExecutor(planner::SelectNode *plan, std::shared_ptr<catalog::Catalog> catalog)
                 : ExecutorNode(plan), catalog_(catalog) {}
         std::vector<storage::Tuple> Execute() override {
-            auto select_node = dynamic_cast<planner::SelectNode*>(plan_);
-            std::string table_name = select_node->GetTableName();
-            if (!catalog_->HasTable(table_name)) throw std::runtime_error("Table not found " + table_name);
-            auto table = catalog_->GetTable(table_name);
+            return ScanTable(*catalog_, *dynamic_cast<planner::SelectNode*>(plan_), nullptr);
+        }
+
+        // Scans the selected columns of the table. With a filter, its predicate is pushed into the
+        // scan, its conditions are checked on the batches, and only the rows that satisfy both are
+        // turned into tuples.
+        static std::vector<storage::Tuple> ScanTable(catalog::Catalog &catalog, const planner::SelectNode &select_node,
+                                                     const planner::FilterNode *filter) {
+            const std::string &table_name = select_node.GetTableName();
+            if (!catalog.HasTable(table_name)) throw std::runtime_error("Table not found " + table_name);
+            auto table = catalog.GetTable(table_name);
+
+            const auto &full_schema = table->GetSchema();
+            std::vector<size_t> column_indexes = SelectedColumns(full_schema, select_node);
+            storage::SchemaRef select_schema_ref = storage::InternSchema(SelectSchema(full_schema, column_indexes));
+
+            std::optional<storage::ColumnPredicate> predicate;
+            if (filter) predicate = storage::ColumnPredicate::Parse(filter->GetPredicate(), full_schema.GetColumnIndex(filter->GetColumnName()));
+
+            // Columns that only conditions refer to are scanned after the selected ones; each condition
+            // is paired with the position of its column in the batch.
+            std::vector<size_t> scan_columns = column_indexes;
+            std::vector<std::pair<storage::ColumnPredicate, size_t>> conditions;
+            if (filter) {
+                for (const auto& condition : filter->GetConditions()) {
+                    size_t column_index = full_schema.GetColumnIndex(condition.column_name);
+                    auto it = std::find(scan_columns.begin(), scan_columns.end(), column_index);
+                    conditions.emplace_back(storage::ColumnPredicate::Parse(condition.predicate, column_index), it - scan_columns.begin());
+                    if (it == scan_columns.end()) scan_columns.push_back(column_index);
+                }
+            }
 
-            auto full_schema = table->GetSchema();
+            auto scan = [&](const storage::Table& source, std::vector<storage::Tuple>& out) {
+                std::vector<uint32_t> rows;
+                source.Scan(scan_columns, predicate ? &*predicate : nullptr, [&](const storage::ColumnBatch& batch) {
+                    rows.resize(batch.Size());
+                    std::iota(rows.begin(), rows.end(), 0);
+                    for (const auto& [condition, position] : conditions) condition.Select(batch.columns[position], rows);
+
+                    for (uint32_t row : rows) {
+                        std::vector<storage::Field> selected_fields;
+                        selected_fields.reserve(column_indexes.size());
+
+                        for (size_t column = 0; column < column_indexes.size(); ++column)
+                            std::visit([&](const auto& values) { selected_fields.emplace_back(values[row]); }, batch.columns[column]);
+
+                        out.emplace_back(select_schema_ref, std::move(selected_fields), storage::TYPE_CHECKED);
+                    }
+                });
+            };
+
+            std::vector<storage::Tuple> result;
+            auto partitioned = std::dynamic_pointer_cast<storage::PartitionedTable>(table);
+            if (!partitioned) {
+                if (!predicate) result.reserve(table->GetRowCount());
+                scan(*table, result);
+                return result;
+            }
+
+            // Partitions left after pruning are scanned in parallel, each into its own result, and the results
+            // are concatenated in partition order. They are resolved here since resolving may load them.
+            std::vector<size_t> partitions = select_node.GetPartitions()
+                    ? *select_node.GetPartitions() : partitioned->GetScheme().Prune(predicate ? &*predicate : nullptr);
+            std::vector<std::shared_ptr<storage::Table>> sources;
+            for (size_t partition : partitions) sources.push_back(partitioned->GetPartition(partition));
+            std::vector<std::vector<storage::Tuple>> partial(sources.size());
+            std::atomic<size_t> next{0};
+            size_t worker_count = std::min<size_t>(sources.size(), std::max(1u, std::thread::hardware_concurrency()));
+            std::vector<std::future<void>> workers;
+            for (size_t worker = 0; worker < worker_count; ++worker) {
+                workers.push_back(std::async(std::launch::async, [&] {
+                    for (size_t i = next++; i < sources.size(); i = next++) scan(*sources[i], partial[i]);
+                }));
+            }
+            for (auto& worker : workers) worker.get();
+
+            size_t total = 0;
+            for (const auto& tuples : partial) total += tuples.size();
+            result.reserve(total);
+            for (auto& tuples : partial) std::move(tuples.begin(), tuples.end(), std::back_inserter(result));
+            return result;
+        }
 
-            std::vector<storage::Column> selected_columns;
-            selected_columns.reserve(select_node->GetColumns().size());
+        // Positions in the table schema of the columns a SELECT returns, in output order.
+        static std::vector<size_t> SelectedColumns(const storage::Schema &full_schema, const planner::SelectNode &select_node) {
+            return SelectedColumns(full_schema, select_node.GetColumns());
+        }
+
+        static std::vector<size_t> SelectedColumns(const storage::Schema &full_schema, const std::vector<std::string> &columns) {
             std::vector<size_t> column_indexes;
-            column_indexes.reserve(select_node->GetColumns().size());
+            column_indexes.reserve(columns.size());
 
-            for (const auto &col_name : select_node->GetColumns()) {
+            for (const auto &col_name : columns) {
                 if (col_name == "*") {
                     for (size_t i = 0; i < full_schema.GetColumnCount(); i++) {
-                        selected_columns.push_back(full_schema.GetColumn(i));
                         column_indexes.push_back(i);
                     }
                     break;
                 } else {
-                    size_t idx = full_schema.GetColumnIndex(col_name);
-                    selected_columns.push_back(full_schema.GetColumn(idx));
-                    column_indexes.push_back(idx);
+                    column_indexes.push_back(full_schema.GetColumnIndex(col_name));
                 }
             }
+            return column_indexes;
+        }
 
-
+        static storage::Schema SelectSchema(const storage::Schema &full_schema, const std::vector<size_t> &column_indexes) {
             storage::Schema select_schema;
-            for (auto& select_column : selected_columns) {
-                select_schema.InsertColumn(select_column.name, select_column.type);
-            }
-
-            std::vector<storage::Tuple> result;
-            for (const auto &rid: table->GetAllRID()) {
-                auto tuple = table->GetTuple(rid);
-                if (!tuple) continue;
-                std::vector<storage::Field> selected_fields;
-                selected_fields.reserve(column_indexes.size());
-
-                for (auto idx : column_indexes)
-                    selected_fields.push_back(tuple->GetField(idx));
-
-                result.emplace_back(select_schema, std::move(selected_fields));
+            for (auto idx : column_indexes) {
+                const auto &column = full_schema.GetColumn(idx);
+                select_schema.InsertColumn(column.name, column.type);
             }
-            return result;
+            return select_schema;
         }
 
     private:
@@ -87,122 +161,278 @@ namespace executor {
 
         std::vector<storage::Tuple> Execute() override {
             auto filter_node = dynamic_cast<planner::FilterNode*>(plan_);
-            auto input = child_executor_->Execute();
-            auto [op, value] = ParsePredicate(filter_node->GetPredicate());
             auto table = catalog_->GetTable(filter_node->GetTableName());
+            const auto &schema = table->GetSchema();
+            auto predicate = storage::ColumnPredicate::Parse(filter_node->GetPredicate(), schema.GetColumnIndex(filter_node->GetColumnName()));
+            auto conditions = ParseConditions(schema, filter_node->GetConditions());
             std::vector<storage::Tuple> result;
             if (!filter_node->GetIndexName().empty()) {
-                std::vector<storage::RID> rids;
-                switch (value.index()) {
-                    case 0: {
-                        auto index = table->GetIndex<int>(filter_node->GetIndexName());
-                        rids = PerformSearch(op, std::get<int>(value), index);
-                        break;
-                    }
-                    case 1: {
-                        auto index = table->GetIndex<double>(filter_node->GetIndexName());
-                        rids = PerformSearch(op, std::get<double>(value), index);
-                        break;
-                    }
-                    case 2: {
-                        auto index = table->GetIndex<std::string>(filter_node->GetIndexName());
-                        rids = PerformSearch(op, std::get<std::string>(value), index);
-                        break;
-                    }
-                    default:
-                        throw std::runtime_error("Unsupported index type");
-                }
-                for (auto rid: rids) {
-                    auto tuple = table->GetTuple(rid);
-                    result.push_back(*tuple);
+                auto prefix = ParseConditions(schema, filter_node->GetIndexPrefix());
+                // Tuples read through an index have every column, at its position in the schema.
+                std::vector<size_t> positions;
+                for (const auto &condition : conditions) positions.push_back(condition.column_index);
+                for (const auto &source : IndexSources(table, predicate)) {
+                    ForEachIndexMatch(*source, filter_node->GetIndexName(), prefix, predicate, [&](storage::RID rid, const auto &) {
+                        auto tuple = source->GetTuple(rid);
+                        if (MatchesAll(conditions, positions, *tuple)) result.push_back(std::move(*tuple));
+                    });
                 }
+            } else if (auto &child = filter_node->GetChildren().front(); child->GetType() == planner::SELECT_STATEMENT) {
+                return SelectExecutor::ScanTable(*catalog_, dynamic_cast<planner::SelectNode&>(*child), filter_node);
             } else {
-                for (const auto &tuple: input) {
-                    auto a = filter_node->GetColumnName();
+                std::vector<size_t> positions;
+                for (auto &tuple: child_executor_->Execute()) {
+                    if (positions.size() < conditions.size()) {
+                        for (const auto &condition : filter_node->GetConditions()) positions.push_back(tuple.GetFieldIndex(condition.column_name));
+                    }
                     auto index = tuple.GetFieldIndex(filter_node->GetColumnName());
-                    auto field = tuple.GetField(index);
-                    if (EvaluatePredicate(field, op, value)) result.push_back(tuple);
+                    if (predicate.Matches(tuple.GetField(index)) && MatchesAll(conditions, positions, tuple)) result.push_back(std::move(tuple));
                 }
             }
             return result;
         }
 
+        // A partitioned table keeps one index per partition; only the ones left after pruning are searched.
+        static std::vector<std::shared_ptr<storage::Table>> IndexSources(const std::shared_ptr<storage::Table> &table,
+                                                                         const storage::ColumnPredicate &predicate) {
+            auto partitioned = std::dynamic_pointer_cast<storage::PartitionedTable>(table);
+            if (!partitioned) return {table};
+            std::vector<std::shared_ptr<storage::Table>> sources;
+            for (size_t partition : partitioned->GetScheme().Prune(&predicate)) sources.push_back(partitioned->GetPartition(partition));
+            return sources;
+        }
+
+        static std::vector<storage::ColumnPredicate> ParseConditions(const storage::Schema &schema,
+                                                                     const std::vector<planner::FilterNode::Condition> &conditions) {
+            std::vector<storage::ColumnPredicate> result;
+            result.reserve(conditions.size());
+            for (const auto &condition : conditions) {
+                result.push_back(storage::ColumnPredicate::Parse(condition.predicate, schema.GetColumnIndex(condition.column_name)));
+            }
+            return result;
+        }
+
+        // positions[i] is the position of the column conditions[i] refers to in fields.
+        template<typename Fields>
+        static bool MatchesAll(const std::vector<storage::ColumnPredicate> &conditions, const std::vector<size_t> &positions,
+                               const Fields &fields) {
+            for (size_t i = 0; i < conditions.size(); ++i) {
+                if (!conditions[i].Matches(GetField(fields, positions[i]))) return false;
+            }
+            return true;
+        }
+
+        /*
+         * Calls consumer(rid, key) for every entry of the index that matches the "=" prefix on its leading
+         * columns and the predicate on the next one. key is the entry's key: the column value for an index
+         * on one column, the encoded tuple (see storage::index_key) for an index on several. Literals of
+         * another type than their column match no row, as in a scan.
+         */
+        template<typename Consumer>
+        static void ForEachIndexMatch(const storage::Table &table, const std::string &index_name,
+                                      const std::vector<storage::ColumnPredicate> &prefix, const storage::ColumnPredicate &predicate,
+                                      Consumer &&consumer) {
+            if (table.GetIndexColumns(index_name).size() > 1) {
+                ForEachCompositeMatch(table, index_name, prefix, predicate, consumer);
+                return;
+            }
+            const auto &value = predicate.value;
+            if (value.index() != static_cast<size_t>(table.GetSchema().GetColumn(predicate.column_index).type)) return;
+            switch (value.index()) {
+                case 0:
+                    ForEachMatch(table, index_name, predicate.op, std::get<int>(value), consumer);
+                    break;
+                case 1:
+                    ForEachMatch(table, index_name, predicate.op, std::get<double>(value), consumer);
+                    break;
+                case 2:
+                    ForEachMatch(table, index_name, predicate.op, std::get<std::string>(value), consumer);
+                    break;
+                default:
+                    throw std::runtime_error("Unsupported index type");
+            }
+        }
+
     private:
         std::unique_ptr<ExecutorNode> child_executor_;
         std::shared_ptr<catalog::Catalog> catalog_;
 
-        std::pair<std::string, storage::Field> ParsePredicate(const std::string &predicate) {
-            std::regex pattern(R"(^(\S+)\s*(<=|>=|<|>|=)\s*(\S+)$)");
-            std::smatch matches;
-            if (std::regex_match(predicate, matches, pattern)) {
-                std::string col = matches[1].str();
-                std::string op = matches[2].str();
-                std::string value_str = matches[3].str();
-
-                if (std::regex_match(value_str, std::regex(R"(\d+\.\d+)"))) {
-                    return {op, std::stod(value_str)};
-                } else if (std::regex_match(value_str, std::regex(R"(\d+)"))) {
-                    return {op, std::stoi(value_str)};
-                } else {
-                    return {op, value_str};
-                }
+        static const storage::Field &GetField(const storage::Tuple &tuple, size_t position) { return tuple.GetField(position); }
+        static const storage::Field &GetField(const std::vector<storage::Field> &fields, size_t position) { return fields[position]; }
+
+        /*
+         * An index on several columns is keyed by the encoded tuple of its columns (see storage::index_key),
+         * so the entries whose leading columns equal the prefix values form one run of keys starting with
+         * their encoding, ordered within it by the next column. A hash index is probed for the whole tuple;
+         * a B+tree run is walked from the first key that can match to the first one past the predicate.
+         * Literals of another type than their column match no row, as in a scan.
+         */
+        template<typename Consumer>
+        static void ForEachCompositeMatch(const storage::Table &table, const std::string &index_name,
+                                          const std::vector<storage::ColumnPredicate> &prefix, const storage::ColumnPredicate &predicate,
+                                          Consumer &&consumer) {
+            const auto &schema = table.GetSchema();
+            auto has_column_type = [&schema](const storage::ColumnPredicate &p) {
+                return p.value.index() == static_cast<size_t>(schema.GetColumn(p.column_index).type);
+            };
+            std::string run;
+            for (const auto &p : prefix) {
+                if (!has_column_type(p)) return;
+                storage::index_key::Append(p.value, run);
+            }
+            if (!has_column_type(predicate)) return;
+            std::string bound = run;
+            storage::index_key::Append(predicate.value, bound);
+
+            const auto &op = predicate.op;
+            if (table.GetIndexType(index_name) == storage::IndexType::HASH) {
+                if (op != "=") throw std::invalid_argument("Hash index " + index_name + " only supports =");
+                for (storage::RID rid : table.GetHashIndex<std::string>(index_name)->Search(bound)) consumer(rid, bound);
+                return;
+            }
+            if (op != "=" && op != "<" && op != ">" && op != "<=" && op != ">=") {
+                throw std::invalid_argument("Unsupported operator for range query: " + op);
+            }
+            // Keys starting with bound are the rows whose column equals the value.
+            auto index = table.GetIndex<std::string>(index_name);
+            auto cursor = index->LowerBound(op == "<" || op == "<=" ? run : bound);
+            for (; cursor.Valid(); cursor.Next()) {
+                const std::string &key = cursor.Key();
+                if (!storage::index_key::StartsWith(key, op == "=" ? bound : run)) break;
+                if (op == "<" && !(key < bound)) break;
+                if (op == "<=" && bound < key && !storage::index_key::StartsWith(key, bound)) break;
+                if (op == ">" && storage::index_key::StartsWith(key, bound)) continue;
+                consumer(cursor.GetRID(), key);
+            }
+        }
+
+        // A hash index answers "=" with one probe; a B+tree index is walked as below.
+        template<typename KeyType, typename Consumer>
+        static void ForEachMatch(const storage::Table &table, const std::string &index_name, const std::string &op, const KeyType &value,
+                                 Consumer &&consumer) {
+            if (table.GetIndexType(index_name) == storage::IndexType::HASH) {
+                if (op != "=") throw std::invalid_argument("Hash index " + index_name + " only supports =");
+                for (storage::RID rid : table.GetHashIndex<KeyType>(index_name)->Search(value)) consumer(rid, value);
+                return;
+            }
+            ForEachMatch(*table.GetIndex<KeyType>(index_name), op, value, consumer);
+        }
+
+        // Walks the index entries that satisfy "key op value" in key order and stops at the first key past them.
+        template<typename KeyType, typename Consumer>
+        static void ForEachMatch(const storage::BPlusIndex<KeyType> &index, const std::string &op, const KeyType &value, Consumer &&consumer) {
+            typename storage::BPlusIndex<KeyType>::Cursor cursor;
+            if (op == "=" || op == ">=") {
+                cursor = index.LowerBound(value);
+            } else if (op == ">") {
+                cursor = index.UpperBound(value);
+            } else if (op == "<" || op == "<=") {
+                cursor = index.Begin();
+            } else {
+                throw std::invalid_argument("Unsupported operator for range query: " + op);
+            }
+            for (; cursor.Valid(); cursor.Next()) {
+                const KeyType &key = cursor.Key();
+                if ((op == "=" || op == "<=") && value < key) break;
+                if (op == "<" && !(key < value)) break;
+                consumer(cursor.GetRID(), key);
             }
-            throw std::invalid_argument("Invalid predicate format: " + predicate);
         }
+    };
 
+    /*
+     * Answers a filtered SELECT from the entries of an index that holds every column it reads. The
+     * index is searched as by FilterExecutor, and each matching entry's key is decoded into the index
+     * columns the output and the remaining conditions need, so the table's rows are never read.
+     */
+    class IndexScanExecutor : public ExecutorNode {
+    public:
+        IndexScanExecutor(planner::IndexScanNode *plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto scan_node = dynamic_cast<planner::IndexScanNode*>(plan_);
+            auto table = catalog_->GetTable(scan_node->GetTableName());
+            const auto &schema = table->GetSchema();
+            const auto &index_name = scan_node->GetIndexName();
+            auto predicate = storage::ColumnPredicate::Parse(scan_node->GetPredicate(), schema.GetColumnIndex(scan_node->GetColumnName()));
+            auto prefix = FilterExecutor::ParseConditions(schema, scan_node->GetIndexPrefix());
+            auto conditions = FilterExecutor::ParseConditions(schema, scan_node->GetConditions());
+
+            std::vector<size_t> output_columns = SelectExecutor::SelectedColumns(schema, scan_node->GetColumns());
+            storage::SchemaRef output_schema = storage::InternSchema(SelectExecutor::SelectSchema(schema, output_columns));
+
+            std::vector<storage::Tuple> result;
+            for (const auto &source : FilterExecutor::IndexSources(table, predicate)) {
+                // Positions in the entry of the columns read; an entry is decoded no further than the last of them.
+                const auto &stored_columns = source->GetIndexColumns(index_name);
+                auto position_of = [&stored_columns](size_t column_index) {
+                    auto it = std::find(stored_columns.begin(), stored_columns.end(), column_index);
+                    if (it == stored_columns.end()) throw std::runtime_error("Index does not hold the columns of the query");
+                    return static_cast<size_t>(it - stored_columns.begin());
+                };
+                std::vector<size_t> output_positions;
+                for (size_t column_index : output_columns) output_positions.push_back(position_of(column_index));
+                std::vector<size_t> condition_positions;
+                for (const auto &condition : conditions) condition_positions.push_back(position_of(condition.column_index));
+                size_t decoded_count = 0;
+                for (size_t position : output_positions) decoded_count = std::max(decoded_count, position + 1);
+                for (size_t position : condition_positions) decoded_count = std::max(decoded_count, position + 1);
+
+                std::vector<storage::Field> fields(decoded_count);
+                FilterExecutor::ForEachIndexMatch(*source, index_name, prefix, predicate, [&](storage::RID, const auto &key) {
+                    DecodeEntry(key, stored_columns, schema, fields);
+                    if (!FilterExecutor::MatchesAll(conditions, condition_positions, fields)) return;
+                    std::vector<storage::Field> output_fields;
+                    output_fields.reserve(output_positions.size());
+                    for (size_t position : output_positions) output_fields.push_back(fields[position]);
+                    result.emplace_back(output_schema, std::move(output_fields), storage::TYPE_CHECKED);
+                });
+            }
+            return result;
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+
+        // Fills fields with the leading stored columns of an entry: its key itself for an index on one column.
         template<typename KeyType>
-        std::vector<storage::RID> PerformSearch(const std::string &op, KeyType value,
-                                                std::shared_ptr<storage::BPlusIndex<KeyType>> index) {
-            if (op == ">") {
-                return index->RangeQuery(value, std::numeric_limits<KeyType>::max());
-            } else if (op == "<") {
-                return index->RangeQuery(std::numeric_limits<KeyType>::min(), value);
-            } else if (op == "=") {
-                return index->Search(value);
-            }
-            throw std::invalid_argument("Unsupported operator for range query: " + op);
-        }
-
-        bool EvaluatePredicate(const storage::Field &field, const std::string &op, const storage::Field &value) {
-            return std::visit([&](auto &&field_value) -> bool {
-                using FieldType = std::decay_t<decltype(field_value)>;
-                if constexpr (std::is_same_v<FieldType, int> || std::is_same_v<FieldType, double>) {
-                    if (auto val_ptr = std::get_if<FieldType>(&value)) {
-                        if (op == ">") return field_value > *val_ptr;
-                        if (op == "<") return field_value < *val_ptr;
-                        if (op == "=") return field_value == *val_ptr;
-                    }
-                } else if constexpr (std::is_same_v<FieldType, std::string>) {
-                    if (auto val_ptr = std::get_if<std::string>(&value)) {
-                        if (op == "=") return field_value == *val_ptr;
-                    }
+        static void DecodeEntry(const KeyType &key, const std::vector<size_t> &stored_columns, const storage::Schema &schema,
+                                std::vector<storage::Field> &fields) {
+            if constexpr (std::is_same_v<KeyType, std::string>) {
+                if (stored_columns.size() > 1) {
+                    size_t pos = 0;
+                    for (size_t i = 0; i < fields.size(); ++i) fields[i] = storage::index_key::Read(schema.GetColumn(stored_columns[i]).type, key, pos);
+                    return;
                 }
-                return false;
-            }, field);
+            }
+            if (!fields.empty()) fields.front() = key;
         }
     };
 
     class SortExecutor : public ExecutorNode {
     public:
-        SortExecutor(planner::SortNode* plan, std::unique_ptr<ExecutorNode> child_executor)
-                : ExecutorNode(plan), child_executor_(std::move(child_executor)) {}
+        SortExecutor(planner::SortNode* plan, std::unique_ptr<ExecutorNode> child_executor, common::Arena& arena)
+                : ExecutorNode(plan), child_executor_(std::move(child_executor)), arena_(arena) {}
         std::vector<storage::Tuple> Execute() override {
             auto sort_node = dynamic_cast<planner::SortNode*>(plan_);
             auto input = child_executor_->Execute();
+            if (input.empty()) return input;
 
-            std::vector<storage::Tuple*> pointers;
-            for (auto &tuple: input) pointers.push_back(&tuple);
+            std::pmr::vector<size_t> sort_indexes(&arena_);
+            for (const auto &column: sort_node->GetSortColumns()) sort_indexes.push_back(input.front().GetFieldIndex(column));
 
-            std::sort(pointers.begin(), pointers.end(), [&sort_node](const storage::Tuple *a, const storage::Tuple *b) {
-                for (const auto &column: sort_node->GetSortColumns()) {
-                    auto index_a = a->GetFieldIndex(column);
-                    auto index_b = b->GetFieldIndex(column);
+            std::pmr::vector<storage::Tuple*> pointers(&arena_);
+            pointers.reserve(input.size());
+            for (auto &tuple: input) pointers.push_back(&tuple);
 
-                    const auto &field_a = a->GetField(index_a);
-                    const auto &field_b = b->GetField(index_b);
+            std::sort(pointers.begin(), pointers.end(), [&sort_indexes](const storage::Tuple *a, const storage::Tuple *b) {
+                for (size_t index: sort_indexes) {
+                    const auto &field_a = a->GetField(index);
+                    const auto &field_b = b->GetField(index);
 
                     if (field_a < field_b) return true;
-                    if (field_a > field_b) return false;
+                    if (field_b < field_a) return false;
                 }
                 return false;
             });
@@ -210,22 +440,25 @@ namespace executor {
             std::vector<storage::Tuple> sorted_tuples;
             sorted_tuples.reserve(input.size());
             for (auto *ptr: pointers)
-                sorted_tuples.push_back(*ptr);
+                sorted_tuples.push_back(std::move(*ptr));
 
             return sorted_tuples;
         }
     private:
         std::unique_ptr<ExecutorNode> child_executor_;
+        common::Arena &arena_;
     };
 
     class AggregateExecutor : public ExecutorNode {
     public:
         AggregateExecutor(planner::AggregateNode* plan,
                           std::unique_ptr<ExecutorNode> child_executor,
-                          std::shared_ptr<catalog::Catalog> catalog)
+                          std::shared_ptr<catalog::Catalog> catalog,
+                          common::Arena& arena)
                 : ExecutorNode(plan),
                   child_executor_(std::move(child_executor)),
-                  catalog_(std::move(catalog)) {}
+                  catalog_(std::move(catalog)),
+                  arena_(arena) {}
 
         std::vector<storage::Tuple> Execute() override {
             auto agg_node = dynamic_cast<planner::AggregateNode*>(plan_);
@@ -235,6 +468,14 @@ namespace executor {
             if (!catalog_->HasTable(table_name)) {
                 throw std::runtime_error("Table not found: " + table_name);
             }
+            auto source = agg_node->GetChildren().front().get();
+            if (source->GetType() == planner::SELECT_STATEMENT) {
+                return AggregateScan(*agg_node, nullptr);
+            }
+            if (auto filter = dynamic_cast<planner::FilterNode*>(source); filter && filter->GetIndexName().empty() && filter->GetConditions().empty() &&
+                filter->GetChildren().front()->GetType() == planner::SELECT_STATEMENT) {
+                return AggregateScan(*agg_node, filter);
+            }
 
             auto input = child_executor_->Execute();
             if (input.empty() && agg_node->GetGroupColumns().empty() && !agg_node->GetAggregates().empty()) {
@@ -257,36 +498,56 @@ namespace executor {
             std::vector<std::pair<size_t, planner::AggInstruction>> agg_cols;
             agg_cols.reserve(agg_instructions.size());
             for (auto &agg : agg_instructions) {
-                size_t idx = schema.GetColumnIndex(agg.column_name);
+                size_t idx = agg.column_name == "*" ? ALL_COLUMNS : schema.GetColumnIndex(agg.column_name);
                 agg_cols.emplace_back(idx, agg);
             }
 
-            std::unordered_map<std::vector<storage::Field>, std::vector<storage::Tuple>, VectorFieldHash, VectorFieldEqual> groups;
-            for (auto &t: input) {
-                std::vector<storage::Field> key;
-                key.reserve(group_by_indexes.size());
-                for (auto idx : group_by_indexes) key.push_back(t.GetField(idx));
+            // A group is keyed by its first tuple; the key fields are hashed and compared in place.
+            auto key_hash = [&group_by_indexes](const storage::Tuple *tuple) {
+                std::size_t seed = 0;
+                for (auto idx : group_by_indexes) seed = CombineHash(seed, FieldHash()(tuple->GetField(idx)));
+                return seed;
+            };
+            auto key_equal = [&group_by_indexes](const storage::Tuple *a, const storage::Tuple *b) {
+                for (auto idx : group_by_indexes) {
+                    if (a->GetField(idx) != b->GetField(idx)) return false;
+                }
+                return true;
+            };
+            std::pmr::unordered_map<const storage::Tuple*, size_t, decltype(key_hash), decltype(key_equal)>
+                    group_slots(0, key_hash, key_equal, &arena_);
+            std::pmr::vector<const storage::Tuple*> keys(&arena_);
+            std::pmr::vector<size_t> counts(&arena_);
+            std::pmr::vector<double> sums(&arena_);
+            size_t agg_count = agg_cols.size();
 
-                groups[key].push_back(t);
+            for (auto &t: input) {
+                auto [it, inserted] = group_slots.try_emplace(&t, keys.size());
+                if (inserted) {
+                    keys.push_back(&t);
+                    counts.push_back(0);
+                    sums.resize(sums.size() + agg_count, 0.0);
+                }
+                size_t slot = it->second;
+                ++counts[slot];
+                for (size_t a = 0; a < agg_count; ++a) {
+                    if (agg_cols[a].first == ALL_COLUMNS) continue;
+                    const auto &field = t.GetField(agg_cols[a].first);
+                    if (auto integer = std::get_if<int>(&field)) sums[slot * agg_count + a] += *integer;
+                    else if (auto real = std::get_if<double>(&field)) sums[slot * agg_count + a] += *real;
+                }
             }
 
-            storage::Schema output_schema = BuildOutputSchema(schema, group_by_cols, agg_cols);
+            storage::SchemaRef output_schema = storage::InternSchema(BuildOutputSchema(schema, group_by_cols, agg_cols));
 
             std::vector<storage::Tuple> result;
-            result.reserve(groups.size());
-
-            for (auto &kv : groups) {
-                const auto &key = kv.first;
-                const auto &tuples = kv.second;
-
-                std::vector<storage::Field> agg_values = ComputeAggregates(tuples, agg_cols);
-
+            result.reserve(keys.size());
+            for (size_t slot = 0; slot < keys.size(); ++slot) {
                 std::vector<storage::Field> out_fields;
-                out_fields.reserve(key.size() + agg_values.size());
-                out_fields.insert(out_fields.end(), key.begin(), key.end());
-                out_fields.insert(out_fields.end(), agg_values.begin(), agg_values.end());
-
-                result.emplace_back(output_schema, std::move(out_fields));
+                out_fields.reserve(group_by_indexes.size() + agg_count);
+                for (auto idx : group_by_indexes) out_fields.push_back(keys[slot]->GetField(idx));
+                AppendAggregates(out_fields, agg_cols, counts[slot], sums.data() + slot * agg_count);
+                result.emplace_back(output_schema, std::move(out_fields), storage::TYPE_CHECKED);
             }
 
             return result;
@@ -295,6 +556,147 @@ namespace executor {
     private:
         std::unique_ptr<ExecutorNode> child_executor_;
         std::shared_ptr<catalog::Catalog> catalog_;
+        common::Arena &arena_;
+
+        // Column index of the argument of COUNT(*).
+        static constexpr size_t ALL_COLUMNS = std::numeric_limits<size_t>::max();
+
+        // Codes are only comparable within one dictionary, and every partition of a partitioned table
+        // has its own. Codes of any further dictionary are mapped onto the first one's, or onto negative
+        // codes for strings the first one does not hold.
+        struct GroupDictionary {
+            static constexpr int UNMAPPED = std::numeric_limits<int>::min();
+
+            std::shared_ptr<const storage::StringDictionary> dictionary;
+            std::unordered_map<const storage::StringDictionary*, std::vector<int>> translations;
+            std::vector<std::string> missing;
+            std::unordered_map<std::string, int> missing_codes;
+
+            // The translation of codes of other, or null when they are the first dictionary's.
+            std::vector<int>* Use(const std::shared_ptr<const storage::StringDictionary> &other) {
+                if (!dictionary) dictionary = other;
+                if (other == dictionary) return nullptr;
+                return &translations[other.get()];
+            }
+
+            int Translate(std::vector<int> &translation, const storage::StringDictionary &other, uint32_t code) {
+                if (code >= translation.size()) translation.resize(other.values.size(), UNMAPPED);
+                int &mapped = translation[code];
+                if (mapped != UNMAPPED) return mapped;
+                std::string_view value = other.values[code];
+                if (auto found = dictionary->Find(value)) {
+                    mapped = static_cast<int>(*found);
+                } else {
+                    auto [it, inserted] = missing_codes.try_emplace(std::string(value), -static_cast<int>(missing.size()) - 1);
+                    if (inserted) missing.emplace_back(value);
+                    mapped = it->second;
+                }
+                return mapped;
+            }
+
+            [[nodiscard]] std::string Decode(int code) const {
+                return code >= 0 ? std::string(dictionary->values[static_cast<uint32_t>(code)]) : missing[static_cast<size_t>(-code - 1)];
+            }
+        };
+
+        // Aggregates straight off the table scan: only the grouped, aggregated and filtered columns
+        // are read, and sums run over typed column batches without building intermediate tuples.
+        // Dictionary-encoded group columns are grouped by code and decoded once per group.
+        std::vector<storage::Tuple> AggregateScan(const planner::AggregateNode &agg_node, const planner::FilterNode *filter) {
+            auto table = catalog_->GetTable(agg_node.GetTableName());
+            const auto &schema = table->GetSchema();
+            const auto &group_by_cols = agg_node.GetGroupColumns();
+
+            std::vector<size_t> scan_columns;
+            for (auto &col_name : group_by_cols) scan_columns.push_back(schema.GetColumnIndex(col_name));
+
+            std::vector<std::pair<size_t, planner::AggInstruction>> agg_cols;
+            std::vector<size_t> agg_batch_columns;
+            for (auto &agg : agg_node.GetAggregates()) {
+                if (agg.column_name == "*") {
+                    agg_cols.emplace_back(ALL_COLUMNS, agg);
+                    agg_batch_columns.push_back(ALL_COLUMNS);
+                } else {
+                    agg_cols.emplace_back(schema.GetColumnIndex(agg.column_name), agg);
+                    agg_batch_columns.push_back(scan_columns.size());
+                    scan_columns.push_back(agg_cols.back().first);
+                }
+            }
+
+            std::optional<storage::ColumnPredicate> predicate;
+            if (filter) predicate = storage::ColumnPredicate::Parse(filter->GetPredicate(), schema.GetColumnIndex(filter->GetColumnName()));
+
+            size_t agg_count = agg_cols.size();
+            std::vector<GroupDictionary> group_dictionaries(group_by_cols.size());
+            std::vector<std::vector<int>*> translations(group_by_cols.size());
+            using Key = std::pmr::vector<storage::Field>;
+            std::pmr::unordered_map<Key, size_t, VectorFieldHash, VectorFieldEqual> group_slots(&arena_);
+            std::pmr::vector<const Key*> keys(&arena_);
+            std::pmr::vector<size_t> counts(&arena_);
+            std::pmr::vector<double> sums(&arena_);
+            std::pmr::vector<size_t> slots(&arena_);
+            Key key(group_by_cols.size(), &arena_);
+
+            table->Scan(scan_columns, predicate ? &*predicate : nullptr, [&](const storage::ColumnBatch &batch) {
+
+                for (size_t g = 0; g < group_by_cols.size(); ++g) {
+                    if (auto codes = std::get_if<storage::DictionaryVector>(&batch.columns[g])) {
+                        translations[g] = group_dictionaries[g].Use(codes->dictionary);
+                    }
+                }
+
+                slots.resize(batch.Size());
+                for (size_t row = 0; row < batch.Size(); ++row) {
+                    for (size_t g = 0; g < group_by_cols.size(); ++g) {
+                        std::visit([&](const auto &values) {
+                            if constexpr (std::is_same_v<std::decay_t<decltype(values)>, storage::DictionaryVector>) {
+                                key[g] = translations[g]
+                                        ? group_dictionaries[g].Translate(*translations[g], *values.dictionary, values.codes[row])
+                                        : static_cast<int>(values.codes[row]);
+                            } else {
+                                key[g] = values[row];
+                            }
+                        }, batch.columns[g]);
+                    }
+                    auto [it, inserted] = group_slots.try_emplace(key, keys.size());
+                    if (inserted) {
+                        keys.push_back(&it->first);
+                        counts.push_back(0);
+                        sums.resize(sums.size() + agg_count, 0.0);
+                    }
+                    slots[row] = it->second;
+                    ++counts[it->second];
+                }
+
+                for (size_t a = 0; a < agg_count; ++a) {
+                    if (agg_batch_columns[a] == ALL_COLUMNS) continue;
+                    std::visit([&](const auto &values) {
+                        using ValueType = typename std::decay_t<decltype(values)>::value_type;
+                        if constexpr (std::is_arithmetic_v<ValueType>) {
+                            for (size_t row = 0; row < values.size(); ++row) sums[slots[row] * agg_count + a] += values[row];
+                        }
+                    }, batch.columns[agg_batch_columns[a]]);
+                }
+            });
+
+            if (keys.empty()) {
+                if (group_by_cols.empty() && agg_count > 0) return BuildEmptyAggregateResult(agg_node);
+                return {};
+            }
+
+            storage::SchemaRef output_schema = storage::InternSchema(BuildOutputSchema(schema, group_by_cols, agg_cols));
+            std::vector<storage::Tuple> result;
+            result.reserve(keys.size());
+            for (size_t slot = 0; slot < keys.size(); ++slot) {
+                std::vector<storage::Field> out_fields(keys[slot]->begin(), keys[slot]->end());
+                for (size_t g = 0; g < group_by_cols.size(); ++g) {
+                    if (group_dictionaries[g].dictionary) out_fields[g] = group_dictionaries[g].Decode(std::get<int>(out_fields[g]));
+                }
+                AppendAggregates(out_fields, agg_cols, counts[slot], sums.data() + slot * agg_count);
+                result.emplace_back(output_schema, std::move(out_fields), storage::TYPE_CHECKED);
+            }
+            return result;
+        }
 
         struct FieldHash {
             std::size_t operator()(const storage::Field &f) const noexcept {
@@ -313,18 +715,22 @@ namespace executor {
             }
         };
 
+        static std::size_t CombineHash(std::size_t seed, std::size_t hash) {
+            return seed ^ (hash + 0x9e3779b97f4a7c16ULL + (seed<<6) + (seed>>2));
+        }
+
         struct VectorFieldHash {
-            std::size_t operator()(const std::vector<storage::Field> &fields) const noexcept {
+            template<typename Fields>
+            std::size_t operator()(const Fields &fields) const noexcept {
                 std::size_t seed = 0;
-                for (auto &f : fields) {
-                    seed ^= FieldHash()(f) + 0x9e3779b97f4a7c16ULL + (seed<<6) + (seed>>2);
-                }
+                for (auto &f : fields) seed = CombineHash(seed, FieldHash()(f));
                 return seed;
             }
         };
 
         struct VectorFieldEqual {
-            bool operator()(const std::vector<storage::Field> &a, const std::vector<storage::Field> &b) const noexcept {
+            template<typename Fields>
+            bool operator()(const Fields &a, const Fields &b) const noexcept {
                 if (a.size() != b.size()) return false;
                 for (size_t i = 0; i < a.size(); i++) {
                     if (!FieldEqual()(a[i], b[i])) return false;
@@ -344,7 +750,6 @@ namespace executor {
             }
             for (auto &p : agg_cols) {
                 auto &agg = p.second;
-                const auto &col_def = input_schema.GetColumn(p.first);
                 storage::DataType out_type;
                 switch (agg.type) {
                     case planner::AggType::SUM:
@@ -367,47 +772,17 @@ namespace executor {
             return output_schema;
         }
 
-        std::vector<storage::Field> ComputeAggregates(const std::vector<storage::Tuple> &tuples,
-                                                      const std::vector<std::pair<size_t, planner::AggInstruction>> &agg_cols) {
-            std::vector<storage::Field> agg_values;
-            agg_values.reserve(agg_cols.size());
-
-            for (auto &inst : agg_cols) {
-                const auto &agg = inst.second;
-                std::vector<storage::Field> column_values;
-                column_values.reserve(tuples.size());
-                for (auto &t : tuples) column_values.push_back(t.GetField(inst.first));
-
-                storage::Field agg_result;
-                switch (agg.type) {
-                    case planner::AggType::COUNT: {
-                        int count_val = static_cast<int>(tuples.size());
-                        agg_result = count_val;
-                        break;
-                    }
-                    case planner::AggType::SUM: {
-                        double sum_val = 0.0;
-                        for (auto &f : column_values) {
-                            if (std::holds_alternative<int>(f)) sum_val += std::get<int>(f);
-                            else if (std::holds_alternative<double>(f)) sum_val += std::get<double>(f);
-                        }
-                        agg_result = sum_val;
-                        break;
-                    }
-                    case planner::AggType::AVG: {
-                        double sum_val = 0.0;
-                        for (auto &f : column_values) {
-                            if (std::holds_alternative<int>(f)) sum_val += std::get<int>(f);
-                            else if (std::holds_alternative<double>(f)) sum_val += std::get<double>(f);
-                        }
-                        double avg_val = tuples.empty() ? 0.0 : sum_val / tuples.size();
-                        agg_result = avg_val;
-                        break;
-                    }
+        // Appends the value of every aggregate of a group with count rows and the given per-aggregate sums.
+        static void AppendAggregates(std::vector<storage::Field> &out_fields,
+                                     const std::vector<std::pair<size_t, planner::AggInstruction>> &agg_cols,
+                                     size_t count, const double *sums) {
+            for (size_t a = 0; a < agg_cols.size(); ++a) {
+                switch (agg_cols[a].second.type) {
+                    case planner::AggType::COUNT: out_fields.emplace_back(static_cast<int>(count)); break;
+                    case planner::AggType::SUM: out_fields.emplace_back(sums[a]); break;
+                    case planner::AggType::AVG: out_fields.emplace_back(sums[a] / static_cast<double>(count)); break;
                 }
-                agg_values.push_back(agg_result);
             }
-            return agg_values;
         }
 
         std::vector<storage::Tuple> BuildEmptyAggregateResult(const planner::AggregateNode &agg_node) {
@@ -449,7 +824,7 @@ namespace executor {
             }
 
             std::vector<storage::Tuple> result;
-            result.emplace_back(output_schema, std::move(agg_values));
+            result.emplace_back(storage::InternSchema(output_schema), std::move(agg_values), storage::TYPE_CHECKED);
             return result;
         }
     };
@@ -461,13 +836,42 @@ namespace executor {
                 : ExecutorNode(plan), catalog_(std::move(catalog)) {};
         std::vector<storage::Tuple> Execute() override {
             auto create_table_node = dynamic_cast<planner::CreateTableNode*>(plan_);
-            catalog_->CreateTable(create_table_node->GetTableName(), create_table_node->GetSchema());
+            if (create_table_node->GetPartitioning()) {
+                catalog_->CreatePartitionedTable(create_table_node->GetTableName(), create_table_node->GetSchema(),
+                                                 create_table_node->GetStorage(), *create_table_node->GetPartitioning());
+            } else {
+                catalog_->CreateTable(create_table_node->GetTableName(), create_table_node->GetSchema(), create_table_node->GetStorage());
+            }
+            catalog_->Commit();
             return {};
         }
     private:
         std::shared_ptr<catalog::Catalog> catalog_;
     };
 
+    class CreateIndexExecutor : public ExecutorNode {
+    public:
+        CreateIndexExecutor(planner::CreateIndexNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto create_index_node = dynamic_cast<planner::CreateIndexNode*>(plan_);
+            const auto& table_name = create_index_node->GetTableName();
+            const auto& schema = catalog_->GetTable(table_name)->GetSchema();
+            std::vector<size_t> column_indexes;
+            for (const auto& column_name : create_index_node->GetColumnNames()) column_indexes.push_back(schema.GetColumnIndex(column_name));
+            std::vector<size_t> include_columns;
+            for (const auto& column_name : create_index_node->GetIncludeColumnNames()) include_columns.push_back(schema.GetColumnIndex(column_name));
+            catalog_->CreateIndex(create_index_node->GetIndexName(), table_name, column_indexes, create_index_node->GetDegree(),
+                                  create_index_node->GetIndexType(), include_columns);
+            catalog_->Commit();
+            return {};
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
     class InsertExecutor : public ExecutorNode {
     public:
         InsertExecutor(planner::InsertNode* plan, std::shared_ptr<catalog::Catalog> catalog)
@@ -500,10 +904,207 @@ namespace executor {
                 fields[idx] = vals[i];
             }
             table->InsertTuple(fields);
+            catalog_->Commit();
             return {};
         }
 
     private:
         std::shared_ptr<catalog::Catalog> catalog_;
     };
+
+    class ShowBufferPoolExecutor : public ExecutorNode {
+    public:
+        ShowBufferPoolExecutor(planner::ShowBufferPoolNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto stats = catalog_->GetBufferPool()->GetStats();
+
+            storage::Schema schema;
+            schema.InsertColumn("pool_size", storage::DataType::INTEGER);
+            schema.InsertColumn("hits", storage::DataType::INTEGER);
+            schema.InsertColumn("misses", storage::DataType::INTEGER);
+            schema.InsertColumn("evictions", storage::DataType::INTEGER);
+            schema.InsertColumn("pages_read", storage::DataType::INTEGER);
+            schema.InsertColumn("pages_written", storage::DataType::INTEGER);
+            schema.InsertColumn("hit_ratio", storage::DataType::DOUBLE);
+
+            size_t accesses = stats.hits + stats.misses;
+            double hit_ratio = accesses == 0 ? 0.0 : static_cast<double>(stats.hits) / static_cast<double>(accesses);
+
+            std::vector<storage::Tuple> result;
+            result.emplace_back(storage::InternSchema(schema), std::vector<storage::Field>{
+                    static_cast<int>(stats.pool_size),
+                    static_cast<int>(stats.hits),
+                    static_cast<int>(stats.misses),
+                    static_cast<int>(stats.evictions),
+                    static_cast<int>(stats.pages_read),
+                    static_cast<int>(stats.pages_written),
+                    hit_ratio
+            });
+            return result;
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
+    class CheckpointExecutor : public ExecutorNode {
+    public:
+        CheckpointExecutor(planner::CheckpointNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            storage::lsn_t lsn = catalog_->Checkpoint();
+
+            storage::Schema schema;
+            schema.InsertColumn("checkpoint_lsn", storage::DataType::INTEGER);
+
+            std::vector<storage::Tuple> result;
+            result.emplace_back(storage::InternSchema(schema), std::vector<storage::Field>{static_cast<int>(lsn)});
+            return result;
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
+    class VacuumExecutor : public ExecutorNode {
+    public:
+        VacuumExecutor(planner::VacuumNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto vacuum_node = dynamic_cast<planner::VacuumNode*>(plan_);
+            storage::VacuumStats stats = catalog_->GetTable(vacuum_node->GetTableName())->Vacuum();
+            catalog_->Commit();
+
+            storage::Schema schema;
+            schema.InsertColumn("bytes_reclaimed", storage::DataType::INTEGER);
+            schema.InsertColumn("blocks_freed", storage::DataType::INTEGER);
+            schema.InsertColumn("tuples_moved", storage::DataType::INTEGER);
+
+            std::vector<storage::Tuple> result;
+            result.emplace_back(storage::InternSchema(schema), std::vector<storage::Field>{
+                    static_cast<int>(stats.bytes_reclaimed),
+                    static_cast<int>(stats.blocks_freed),
+                    static_cast<int>(stats.tuples_moved)
+            });
+            return result;
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
+    class AlterTableExecutor : public ExecutorNode {
+    public:
+        AlterTableExecutor(planner::AlterTableNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto alter_node = dynamic_cast<planner::AlterTableNode*>(plan_);
+            switch (alter_node->GetAction()) {
+                case planner::AlterTableAction::ADD_PARTITION:
+                    catalog_->AddPartition(alter_node->GetTableName(), alter_node->GetPartition());
+                    break;
+                case planner::AlterTableAction::DROP_PARTITION:
+                    catalog_->DropPartition(alter_node->GetTableName(), alter_node->GetPartition().name);
+                    break;
+            }
+            catalog_->Commit();
+            return {};
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
+    class CopyExecutor : public ExecutorNode {
+    public:
+        CopyExecutor(planner::CopyNode* plan, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto copy_node = dynamic_cast<planner::CopyNode*>(plan_);
+            auto table = catalog_->GetTable(copy_node->GetTableName());
+            storage::CsvReader reader(table->GetSchema(), copy_node->GetOptions());
+
+            // Rows that made it in before a malformed line stay, and so do their index entries.
+            size_t row_count = 0;
+            table->BeginBulkLoad();
+            try {
+                row_count = reader.Read(copy_node->GetFileName(), [&](storage::CsvReader::Rows& rows) { table->InsertTuples(rows); });
+            } catch (...) {
+                table->EndBulkLoad();
+                catalog_->Commit();
+                throw;
+            }
+            table->EndBulkLoad();
+            catalog_->Commit();
+
+            storage::Schema schema;
+            schema.InsertColumn("rows_loaded", storage::DataType::INTEGER);
+
+            std::vector<storage::Tuple> result;
+            result.emplace_back(storage::InternSchema(schema), std::vector<storage::Field>{static_cast<int>(row_count)});
+            return result;
+        }
+
+    private:
+        std::shared_ptr<catalog::Catalog> catalog_;
+    };
+
+    class CopyToExecutor : public ExecutorNode {
+    public:
+        CopyToExecutor(planner::CopyToNode* plan, std::unique_ptr<ExecutorNode> child_executor, std::shared_ptr<catalog::Catalog> catalog)
+                : ExecutorNode(plan), child_executor_(std::move(child_executor)), catalog_(std::move(catalog)) {}
+
+        std::vector<storage::Tuple> Execute() override {
+            auto copy_node = dynamic_cast<planner::CopyToNode*>(plan_);
+            auto query = copy_node->GetChildren().front().get();
+            auto filter = dynamic_cast<planner::FilterNode*>(query);
+            if (filter && filter->GetIndexName().empty() && filter->GetConditions().empty()) query = filter->GetChildren().front().get();
+            else filter = nullptr;
+
+            size_t row_count;
+            if (auto select = dynamic_cast<planner::SelectNode*>(query)) {
+                row_count = StreamScan(*copy_node, *select, filter);
+            } else {
+                // Sorts, aggregates and index lookups produce their whole result before it is written.
+                auto tuples = child_executor_->Execute();
+                storage::Schema schema = tuples.empty() ? storage::Schema() : tuples.front().GetSchema();
+                storage::RowWriter writer(copy_node->GetFileName(), schema, copy_node->GetOptions());
+                for (const auto& tuple : tuples) writer.WriteTuple(tuple);
+                writer.Close();
+                row_count = writer.GetRowCount();
+            }
+
+            storage::Schema schema;
+            schema.InsertColumn("rows_written", storage::DataType::INTEGER);
+
+            std::vector<storage::Tuple> result;
+            result.emplace_back(storage::InternSchema(schema), std::vector<storage::Field>{static_cast<int>(row_count)});
+            return result;
+        }
+
+    private:
+        std::unique_ptr<ExecutorNode> child_executor_;
+        std::shared_ptr<catalog::Catalog> catalog_;
+
+        // Writes the scan's batches as they come, so no more than one batch is held at a time.
+        size_t StreamScan(const planner::CopyToNode& copy_node, const planner::SelectNode& select_node, const planner::FilterNode* filter) {
+            auto table = catalog_->GetTable(select_node.GetTableName());
+            const auto& full_schema = table->GetSchema();
+            std::vector<size_t> column_indexes = SelectExecutor::SelectedColumns(full_schema, select_node);
+
+            std::optional<storage::ColumnPredicate> predicate;
+            if (filter) predicate = storage::ColumnPredicate::Parse(filter->GetPredicate(), full_schema.GetColumnIndex(filter->GetColumnName()));
+
+            storage::RowWriter writer(copy_node.GetFileName(), SelectExecutor::SelectSchema(full_schema, column_indexes), copy_node.GetOptions());
+            table->Scan(column_indexes, predicate ? &*predicate : nullptr, [&](const storage::ColumnBatch& batch) { writer.WriteBatch(batch); });
+            writer.Close();
+            return writer.GetRowCount();
+        }
+    };
 }
@@ -27,6 +27,9 @@ namespace {
                     current.clear();
                 }
                 continue;
+            } else if (c == '=' && !current.empty() && (current.back() == '<' || current.back() == '>')) {
+                // "<=" and ">=" stay one operator token.
+                current.push_back(c);
             } else if (c == '(' || c == ')' || c == ',' || c == ';' || c == '=') {
                 if (!current.empty()) {
                     tokens.push_back(current);
@@ -117,10 +120,45 @@ namespace {
         throw std::runtime_error("Unknown data type: " + type_str);
     }
 
+    bool TryParseAggregate(const std::string& token, planner::AggType& out_type) {
+        auto up = ToUpper(token);
+        if (up == "SUM") out_type = planner::AggType::SUM;
+        else if (up == "COUNT") out_type = planner::AggType::COUNT;
+        else if (up == "AVG") out_type = planner::AggType::AVG;
+        else return false;
+        return true;
+    }
+
+    // column op value, one conjunct of a WHERE clause
+    planner::FilterNode::Condition ParseComparison(const std::vector<std::string>& tokens, size_t& pos) {
+        if (pos >= tokens.size()) {
+            throw std::runtime_error("Expected column after WHERE");
+        }
+        std::string column = tokens[pos++];
+
+        if (pos >= tokens.size()) {
+            throw std::runtime_error("Expected operator after column in WHERE clause");
+        }
+        std::string op = tokens[pos++];
+
+        static const std::vector<std::string> valid_ops = {"=", "<", ">", "<=", ">="};
+        if (std::find(valid_ops.begin(), valid_ops.end(), op) == valid_ops.end()) {
+            throw std::runtime_error("Expected comparison operator (=,<,>,<=,>=) but got: " + op);
+        }
+
+        if (pos >= tokens.size()) {
+            throw std::runtime_error("Expected value after operator in WHERE clause");
+        }
+        std::string value = tokens[pos++];
+
+        return {column, column + op + value};
+    }
+
     std::unique_ptr<planner::PlanNode> ParseSelect(const std::vector<std::string>& tokens, size_t& pos) {
         ExpectTokenCaseInsensitive(tokens, pos, "SELECT");
 
         std::vector<std::string> columns;
+        std::vector<planner::AggInstruction> aggregates;
         while (pos < tokens.size()) {
             if (MatchTokenCaseInsensitive(tokens, pos, "FROM")) {
                 break;
@@ -134,11 +172,21 @@ namespace {
                 pos++;
                 break;
             }
+            planner::AggType agg_type;
+            if (pos + 1 < tokens.size() && tokens[pos + 1] == "(" && TryParseAggregate(tokens[pos], agg_type)) {
+                pos += 2;
+                if (pos + 1 >= tokens.size() || tokens[pos + 1] != ")") {
+                    throw std::runtime_error("Expected a column and ')' in aggregate " + tokens[pos - 2]);
+                }
+                aggregates.push_back({agg_type, tokens[pos]});
+                pos += 2;
+                continue;
+            }
             columns.push_back(tokens[pos]);
             pos++;
         }
 
-        if (columns.empty()) {
+        if (columns.empty() && aggregates.empty()) {
             throw std::runtime_error("No columns specified after SELECT");
         }
 
@@ -148,47 +196,26 @@ namespace {
         }
         std::string table_name = tokens[pos++];
 
-        auto select_node = std::make_unique<planner::SelectNode>(columns, table_name);
-        std::unique_ptr<planner::PlanNode> current_node = std::move(select_node);
-
+        std::string where_col;
+        std::string predicate;
+        // WHERE a op x AND b op y ...: the first conjunct is the filter's predicate, the others its conditions.
+        std::vector<planner::FilterNode::Condition> conditions;
         if (pos < tokens.size() && MatchTokenCaseInsensitive(tokens, pos, "WHERE")) {
             ++pos;
-            if (pos >= tokens.size()) {
-                throw std::runtime_error("Expected column after WHERE");
-            }
-            std::string where_col = tokens[pos++];
-
-            if (pos >= tokens.size()) {
-                throw std::runtime_error("Expected operator after column in WHERE clause");
-            }
-            std::string op = tokens[pos++];
-
-            static const std::vector<std::string> valid_ops = {"=", "<", ">", "<=", ">="};
-            if (std::find(valid_ops.begin(), valid_ops.end(), op) == valid_ops.end()) {
-                throw std::runtime_error("Expected comparison operator (=,<,>,<=,>=) but got: " + op);
-            }
-
-            if (pos >= tokens.size()) {
-                throw std::runtime_error("Expected value after operator in WHERE clause");
+            auto first = ParseComparison(tokens, pos);
+            where_col = first.column_name;
+            predicate = first.predicate;
+            while (MatchTokenCaseInsensitive(tokens, pos, "AND")) {
+                ++pos;
+                conditions.push_back(ParseComparison(tokens, pos));
             }
-            std::string where_value = tokens[pos++];
-
-            std::string predicate = where_col + op + where_value;
-
-            std::string index_name;
-            current_node = std::make_unique<planner::FilterNode>(
-                    std::move(current_node),
-                    predicate,
-                    where_col,
-                    index_name,
-                    table_name
-            );
         }
 
-        if (pos < tokens.size() && MatchTokenCaseInsensitive(tokens, pos, "GROUP")) {
+        std::vector<std::string> group_cols;
+        bool has_group_by = pos < tokens.size() && MatchTokenCaseInsensitive(tokens, pos, "GROUP");
+        if (has_group_by) {
             ++pos;
             ExpectTokenCaseInsensitive(tokens, pos, "BY");
-            std::vector<std::string> group_cols;
             while (pos < tokens.size()) {
                 if (MatchTokenCaseInsensitive(tokens, pos, "ORDER") ||
                     MatchTokenCaseInsensitive(tokens, pos, "WHERE") ||
@@ -205,8 +232,35 @@ namespace {
             if (group_cols.empty()) {
                 throw std::runtime_error("No columns after GROUP BY");
             }
-            std::vector<planner::AggInstruction> aggregates;
+        }
+
+        // An aggregating query only reads the columns it groups by, aggregates over or filters on.
+        if (has_group_by || !aggregates.empty()) {
+            auto add_column = [&columns](const std::string& column) {
+                if (column != "*" && std::find(columns.begin(), columns.end(), column) == columns.end()) columns.push_back(column);
+            };
+            for (const auto& group_col : group_cols) add_column(group_col);
+            for (const auto& aggregate : aggregates) add_column(aggregate.column_name);
+            if (!where_col.empty()) add_column(where_col);
+            for (const auto& condition : conditions) add_column(condition.column_name);
+        }
+
+        auto select_node = std::make_unique<planner::SelectNode>(columns, table_name);
+        std::unique_ptr<planner::PlanNode> current_node = std::move(select_node);
+
+        if (!predicate.empty()) {
+            std::string index_name;
+            current_node = std::make_unique<planner::FilterNode>(
+                    std::move(current_node),
+                    predicate,
+                    where_col,
+                    index_name,
+                    table_name,
+                    std::move(conditions)
+            );
+        }
 
+        if (has_group_by || !aggregates.empty()) {
             current_node = std::make_unique<planner::AggregateNode>(
                     std::move(current_node),
                     group_cols,
@@ -311,6 +365,62 @@ namespace {
         return insert_node;
     }
 
+    // "VALUES LESS THAN (value)" of a RANGE partition, where value may be MAXVALUE.
+    std::optional<storage::Field> ParsePartitionBound(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "VALUES");
+        ExpectTokenCaseInsensitive(tokens, pos, "LESS");
+        ExpectTokenCaseInsensitive(tokens, pos, "THAN");
+        ExpectTokenCaseInsensitive(tokens, pos, "(");
+        if (pos >= tokens.size()) throw std::runtime_error("Expected a partition bound");
+        std::optional<storage::Field> bound;
+        if (!MatchTokenCaseInsensitive(tokens, pos, "MAXVALUE")) bound = ParseLiteral(tokens[pos]);
+        ++pos;
+        ExpectTokenCaseInsensitive(tokens, pos, ")");
+        return bound;
+    }
+
+    // PARTITION BY RANGE (col) (PARTITION p0 VALUES LESS THAN (10), ...) or PARTITION BY HASH (col) PARTITIONS n,
+    // with the leading PARTITION already consumed.
+    storage::PartitionScheme ParsePartitionBy(const std::vector<std::string>& tokens, size_t& pos, const storage::Schema& schema) {
+        ExpectTokenCaseInsensitive(tokens, pos, "BY");
+        storage::PartitionScheme scheme;
+        if (MatchTokenCaseInsensitive(tokens, pos, "HASH")) {
+            scheme.strategy = storage::PartitionStrategy::HASH;
+        } else if (!MatchTokenCaseInsensitive(tokens, pos, "RANGE")) {
+            throw std::runtime_error("Expected RANGE or HASH after PARTITION BY");
+        }
+        ++pos;
+        ExpectTokenCaseInsensitive(tokens, pos, "(");
+        if (pos >= tokens.size()) throw std::runtime_error("Expected partition column");
+        scheme.column_index = schema.GetColumnIndex(tokens[pos++]);
+        ExpectTokenCaseInsensitive(tokens, pos, ")");
+
+        if (scheme.strategy == storage::PartitionStrategy::HASH) {
+            ExpectTokenCaseInsensitive(tokens, pos, "PARTITIONS");
+            int count = 0;
+            if (pos >= tokens.size() || !TryParseInt(tokens[pos], count) || count <= 0) {
+                throw std::runtime_error("Expected a positive partition count after PARTITIONS");
+            }
+            ++pos;
+            for (int i = 0; i < count; ++i) scheme.partitions.push_back({"p" + std::to_string(i), std::nullopt});
+            return scheme;
+        }
+
+        ExpectTokenCaseInsensitive(tokens, pos, "(");
+        while (pos < tokens.size() && tokens[pos] != ")") {
+            if (tokens[pos] == ",") {
+                ++pos;
+                continue;
+            }
+            ExpectTokenCaseInsensitive(tokens, pos, "PARTITION");
+            if (pos >= tokens.size()) throw std::runtime_error("Expected partition name");
+            std::string name = tokens[pos++];
+            scheme.partitions.push_back({name, ParsePartitionBound(tokens, pos)});
+        }
+        ExpectTokenCaseInsensitive(tokens, pos, ")");
+        return scheme;
+    }
+
     std::unique_ptr<planner::PlanNode> ParseCreateTable(const std::vector<std::string>& tokens, size_t& pos) {
         ExpectTokenCaseInsensitive(tokens, pos, "CREATE");
         ExpectTokenCaseInsensitive(tokens, pos, "TABLE");
@@ -347,10 +457,244 @@ namespace {
             throw std::runtime_error("No columns found in CREATE TABLE definition");
         }
 
-        auto create_node = std::make_unique<planner::CreateTableNode>(table_name, schema);
+        storage::TableStorage storage = storage::TableStorage::ROW;
+        if (MatchTokenCaseInsensitive(tokens, pos, "WITH")) {
+            ++pos;
+            if (pos >= tokens.size() || tokens[pos] != "(") {
+                throw std::runtime_error("Expected '(' after WITH in CREATE TABLE");
+            }
+            ++pos;
+            ExpectTokenCaseInsensitive(tokens, pos, "STORAGE");
+            ExpectTokenCaseInsensitive(tokens, pos, "=");
+            if (MatchTokenCaseInsensitive(tokens, pos, "COLUMN")) {
+                storage = storage::TableStorage::COLUMN;
+            } else if (!MatchTokenCaseInsensitive(tokens, pos, "ROW")) {
+                throw std::runtime_error("Expected storage = row or storage = column in CREATE TABLE");
+            }
+            ++pos;
+            ExpectTokenCaseInsensitive(tokens, pos, ")");
+        }
+
+        std::optional<storage::PartitionScheme> partitioning;
+        if (MatchTokenCaseInsensitive(tokens, pos, "PARTITION")) {
+            ++pos;
+            partitioning = ParsePartitionBy(tokens, pos, schema);
+        }
+
+        auto create_node = std::make_unique<planner::CreateTableNode>(table_name, schema, storage, std::move(partitioning));
         return create_node;
     }
 
+    // [USING BTREE | HASH]
+    storage::IndexType ParseIndexMethod(const std::vector<std::string>& tokens, size_t& pos, storage::IndexType type) {
+        if (!MatchTokenCaseInsensitive(tokens, pos, "USING")) return type;
+        ++pos;
+        if (MatchTokenCaseInsensitive(tokens, pos, "BTREE")) {
+            ++pos;
+            return storage::IndexType::BTREE;
+        }
+        if (MatchTokenCaseInsensitive(tokens, pos, "HASH")) {
+            ++pos;
+            return storage::IndexType::HASH;
+        }
+        throw std::runtime_error("BTREE or HASH expected after USING in CREATE INDEX");
+    }
+
+    // (column, ...)
+    std::vector<std::string> ParseIndexColumns(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "(");
+        std::vector<std::string> column_names;
+        while (true) {
+            if (pos >= tokens.size() || tokens[pos] == ")" || tokens[pos] == ",") {
+                throw std::runtime_error("Column name expected in CREATE INDEX");
+            }
+            column_names.push_back(tokens[pos++]);
+            if (pos < tokens.size() && tokens[pos] == ",") {
+                ++pos;
+                continue;
+            }
+            break;
+        }
+        ExpectTokenCaseInsensitive(tokens, pos, ")");
+        return column_names;
+    }
+
+    // CREATE INDEX name ON t [USING BTREE | HASH] (column, ...) [USING BTREE | HASH] [INCLUDE (column, ...)] [WITH (DEGREE = n)]
+    std::unique_ptr<planner::PlanNode> ParseCreateIndex(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "CREATE");
+        ExpectTokenCaseInsensitive(tokens, pos, "INDEX");
+        if (pos >= tokens.size()) throw std::runtime_error("Index name expected after CREATE INDEX");
+        std::string index_name = tokens[pos++];
+        ExpectTokenCaseInsensitive(tokens, pos, "ON");
+        if (pos >= tokens.size()) throw std::runtime_error("Table name expected after ON in CREATE INDEX");
+        std::string table_name = tokens[pos++];
+        storage::IndexType type = ParseIndexMethod(tokens, pos, storage::IndexType::BTREE);
+        std::vector<std::string> column_names = ParseIndexColumns(tokens, pos);
+        type = ParseIndexMethod(tokens, pos, type);
+
+        std::vector<std::string> include_column_names;
+        if (MatchTokenCaseInsensitive(tokens, pos, "INCLUDE")) {
+            ++pos;
+            include_column_names = ParseIndexColumns(tokens, pos);
+            if (type == storage::IndexType::HASH) throw std::runtime_error("INCLUDE only applies to B+tree indexes");
+        }
+
+        int degree = 0;
+        if (MatchTokenCaseInsensitive(tokens, pos, "WITH")) {
+            ++pos;
+            ExpectTokenCaseInsensitive(tokens, pos, "(");
+            ExpectTokenCaseInsensitive(tokens, pos, "DEGREE");
+            ExpectTokenCaseInsensitive(tokens, pos, "=");
+            if (pos >= tokens.size() || !TryParseInt(tokens[pos], degree) || degree < 2) {
+                throw std::runtime_error("DEGREE must be an integer of at least 2 in CREATE INDEX");
+            }
+            ++pos;
+            ExpectTokenCaseInsensitive(tokens, pos, ")");
+            if (type == storage::IndexType::HASH) throw std::runtime_error("DEGREE only applies to B+tree indexes");
+        }
+        return std::make_unique<planner::CreateIndexNode>(index_name, table_name, std::move(column_names), degree, type,
+                                                          std::move(include_column_names));
+    }
+
+    // ALTER TABLE t ADD PARTITION p VALUES LESS THAN (value) | ALTER TABLE t DROP PARTITION p
+    std::unique_ptr<planner::PlanNode> ParseAlterTable(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "ALTER");
+        ExpectTokenCaseInsensitive(tokens, pos, "TABLE");
+        if (pos >= tokens.size()) throw std::runtime_error("Table name expected after ALTER TABLE");
+        std::string table_name = tokens[pos++];
+
+        planner::AlterTableAction action;
+        if (MatchTokenCaseInsensitive(tokens, pos, "ADD")) {
+            action = planner::AlterTableAction::ADD_PARTITION;
+        } else if (MatchTokenCaseInsensitive(tokens, pos, "DROP")) {
+            action = planner::AlterTableAction::DROP_PARTITION;
+        } else {
+            throw std::runtime_error("Expected ADD PARTITION or DROP PARTITION in ALTER TABLE");
+        }
+        ++pos;
+        ExpectTokenCaseInsensitive(tokens, pos, "PARTITION");
+        if (pos >= tokens.size()) throw std::runtime_error("Expected partition name");
+        storage::PartitionDefinition partition{tokens[pos++], std::nullopt};
+        if (action == planner::AlterTableAction::ADD_PARTITION) partition.upper_bound = ParsePartitionBound(tokens, pos);
+        return std::make_unique<planner::AlterTableNode>(table_name, action, std::move(partition));
+    }
+
+    std::unique_ptr<planner::PlanNode> ParseShow(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "SHOW");
+        ExpectTokenCaseInsensitive(tokens, pos, "BUFFER");
+        ExpectTokenCaseInsensitive(tokens, pos, "POOL");
+        return std::make_unique<planner::ShowBufferPoolNode>();
+    }
+
+    std::unique_ptr<planner::PlanNode> ParseCheckpoint(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "CHECKPOINT");
+        return std::make_unique<planner::CheckpointNode>();
+    }
+
+    std::unique_ptr<planner::PlanNode> ParseVacuum(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "VACUUM");
+        if (pos >= tokens.size()) throw std::runtime_error("Expected table name after VACUUM");
+        return std::make_unique<planner::VacuumNode>(tokens[pos++]);
+    }
+
+    struct CopyOptions {
+        storage::ExportFormat format = storage::ExportFormat::CSV;
+        bool header = false;
+        char delimiter = ',';
+    };
+
+    // [WITH (FORMAT [=] CSV | BINARY, HEADER [= TRUE | FALSE], DELIMITER = 'c')]
+    CopyOptions ParseCopyOptions(const std::vector<std::string>& tokens, size_t& pos) {
+        CopyOptions options;
+        if (!MatchTokenCaseInsensitive(tokens, pos, "WITH")) return options;
+        ++pos;
+        ExpectTokenCaseInsensitive(tokens, pos, "(");
+        while (pos < tokens.size() && tokens[pos] != ")") {
+            if (tokens[pos] == ",") {
+                ++pos;
+                continue;
+            }
+            std::string option = ToUpper(tokens[pos++]);
+            if (option == "FORMAT") {
+                if (MatchTokenCaseInsensitive(tokens, pos, "=")) ++pos;
+                if (MatchTokenCaseInsensitive(tokens, pos, "BINARY")) {
+                    options.format = storage::ExportFormat::BINARY;
+                } else if (!MatchTokenCaseInsensitive(tokens, pos, "CSV")) {
+                    throw std::runtime_error("Expected FORMAT CSV or FORMAT BINARY in COPY");
+                }
+                ++pos;
+            } else if (option == "HEADER") {
+                options.header = true;
+                if (MatchTokenCaseInsensitive(tokens, pos, "=")) {
+                    ++pos;
+                    if (MatchTokenCaseInsensitive(tokens, pos, "FALSE")) {
+                        options.header = false;
+                    } else if (!MatchTokenCaseInsensitive(tokens, pos, "TRUE")) {
+                        throw std::runtime_error("Expected HEADER = TRUE or HEADER = FALSE in COPY");
+                    }
+                    ++pos;
+                }
+            } else if (option == "DELIMITER") {
+                ExpectTokenCaseInsensitive(tokens, pos, "=");
+                std::string delimiter = pos < tokens.size() ? StripSingleQuotes(tokens[pos++]) : "";
+                if (delimiter.size() != 1) throw std::runtime_error("DELIMITER must be a single character");
+                options.delimiter = delimiter[0];
+            } else {
+                throw std::runtime_error("Unknown COPY option: " + option);
+            }
+        }
+        ExpectTokenCaseInsensitive(tokens, pos, ")");
+        return options;
+    }
+
+    std::string ParseCopyFileName(const std::vector<std::string>& tokens, size_t& pos) {
+        if (pos >= tokens.size() || tokens[pos].size() < 2 || tokens[pos].front() != '\'' || tokens[pos].back() != '\'') {
+            throw std::runtime_error("Expected quoted file name in COPY");
+        }
+        return StripSingleQuotes(tokens[pos++]);
+    }
+
+    // COPY t FROM 'file' [options] | COPY t TO 'file' [options] | COPY (SELECT ...) TO 'file' [options]
+    std::unique_ptr<planner::PlanNode> ParseCopy(const std::vector<std::string>& tokens, size_t& pos) {
+        ExpectTokenCaseInsensitive(tokens, pos, "COPY");
+        if (pos >= tokens.size()) throw std::runtime_error("Expected table name or query after COPY");
+
+        std::unique_ptr<planner::PlanNode> query;
+        std::string table_name;
+        if (tokens[pos] == "(") {
+            size_t end = ++pos;
+            for (int depth = 1; end < tokens.size(); ++end) {
+                if (tokens[end] == "(") ++depth;
+                if (tokens[end] == ")" && --depth == 0) break;
+            }
+            if (end >= tokens.size()) throw std::runtime_error("Expected ')' after query in COPY");
+            std::vector<std::string> query_tokens(tokens.begin() + static_cast<std::ptrdiff_t>(pos), tokens.begin() + static_cast<std::ptrdiff_t>(end));
+            size_t query_pos = 0;
+            query = ParseSelect(query_tokens, query_pos);
+            if (query_pos != query_tokens.size()) throw std::runtime_error("Unexpected token in COPY query: " + query_tokens[query_pos]);
+            pos = end + 1;
+        } else {
+            table_name = tokens[pos++];
+        }
+
+        if (!query && MatchTokenCaseInsensitive(tokens, pos, "FROM")) {
+            ++pos;
+            std::string file_name = ParseCopyFileName(tokens, pos);
+            CopyOptions options = ParseCopyOptions(tokens, pos);
+            if (options.format != storage::ExportFormat::CSV) throw std::runtime_error("COPY FROM only reads CSV");
+            storage::CsvOptions csv_options;
+            csv_options.header = options.header;
+            csv_options.delimiter = options.delimiter;
+            return std::make_unique<planner::CopyNode>(table_name, file_name, csv_options);
+        }
+
+        ExpectTokenCaseInsensitive(tokens, pos, "TO");
+        std::string file_name = ParseCopyFileName(tokens, pos);
+        CopyOptions options = ParseCopyOptions(tokens, pos);
+        if (!query) query = std::make_unique<planner::SelectNode>(std::vector<std::string>{"*"}, table_name);
+        return std::make_unique<planner::CopyToNode>(std::move(query), file_name,
+                                                     storage::ExportOptions{options.format, options.delimiter, options.header});
+    }
 }
 
 
@@ -369,7 +713,18 @@ namespace parser {
         } else if (first_upper == "INSERT") {
             return ParseInsert(tokens, pos);
         } else if (first_upper == "CREATE") {
+            if (MatchTokenCaseInsensitive(tokens, 1, "INDEX")) return ParseCreateIndex(tokens, pos);
             return ParseCreateTable(tokens, pos);
+        } else if (first_upper == "SHOW") {
+            return ParseShow(tokens, pos);
+        } else if (first_upper == "CHECKPOINT") {
+            return ParseCheckpoint(tokens, pos);
+        } else if (first_upper == "VACUUM") {
+            return ParseVacuum(tokens, pos);
+        } else if (first_upper == "ALTER") {
+            return ParseAlterTable(tokens, pos);
+        } else if (first_upper == "COPY") {
+            return ParseCopy(tokens, pos);
         } else {
             throw std::runtime_error("Unsupported query type: " + tokens[0]);
         }
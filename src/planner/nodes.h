@@ -1,7 +1,11 @@
 #pragma once
 
+#include "partitioned_table.h"
+#include "csv_reader.h"
+#include "row_writer.h"
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -13,7 +17,15 @@ namespace planner {
         FILTER_STATEMENT,
         SORT_STATEMENT,
         AGGREGATE_STATEMENT,
-        CREATE_TABLE_STATEMENT
+        CREATE_TABLE_STATEMENT,
+        SHOW_BUFFER_POOL_STATEMENT,
+        CHECKPOINT_STATEMENT,
+        VACUUM_STATEMENT,
+        ALTER_TABLE_STATEMENT,
+        COPY_STATEMENT,
+        COPY_TO_STATEMENT,
+        CREATE_INDEX_STATEMENT,
+        INDEX_SCAN_STATEMENT
     };
 
     class PlanNode {
@@ -32,9 +44,13 @@ namespace planner {
         std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
         const std::vector<std::string>& GetColumns() const { return columns_; }
         const std::string& GetTableName() const { return table_name_; }
+        // The partitions of a partitioned table left to scan once the planner pruned the others.
+        const std::optional<std::vector<size_t>>& GetPartitions() const { return partitions_; }
+        void SetPartitions(std::vector<size_t> partitions) { partitions_ = std::move(partitions); }
     private:
         std::vector<std::string> columns_;
         std::string table_name_;
+        std::optional<std::vector<size_t>> partitions_;
         static std::vector<std::unique_ptr<PlanNode>> empty_children_;
     };
 
@@ -56,10 +72,19 @@ namespace planner {
 
     class FilterNode : public PlanNode {
     public:
+        // One "column op value" conjunct of a WHERE clause.
+        struct Condition {
+            std::string column_name;
+            std::string predicate;
+        };
+
+        // Rows pass when they satisfy predicate and every condition. With an index, index_prefix holds the
+        // "=" conjuncts on the index columns before column_name, in index column order; the index serves
+        // them together with predicate, and only the conditions are checked on the rows it returns.
         FilterNode(std::unique_ptr<PlanNode> child, std::string predicate, std::string column_name, std::string index_name,
-                   std::string table_name)
+                   std::string table_name, std::vector<Condition> conditions = {}, std::vector<Condition> index_prefix = {})
                 : predicate_(std::move(predicate)), column_name_(std::move(column_name)), index_name_(std::move(index_name)),
-                table_name_(std::move(table_name)) {
+                table_name_(std::move(table_name)), conditions_(std::move(conditions)), index_prefix_(std::move(index_prefix)) {
             children_.push_back(std::move(child));
         }
         PlanNodeType GetType() const override { return FILTER_STATEMENT; }
@@ -68,11 +93,15 @@ namespace planner {
         const std::string& GetColumnName() const { return column_name_; }
         const std::string& GetTableName() const { return table_name_; }
         const std::string& GetIndexName() const { return index_name_; }
+        const std::vector<Condition>& GetConditions() const { return conditions_; }
+        const std::vector<Condition>& GetIndexPrefix() const { return index_prefix_; }
     private:
         std::string table_name_;
         std::string predicate_;
         std::string column_name_;
         std::string index_name_;
+        std::vector<Condition> conditions_;
+        std::vector<Condition> index_prefix_;
         std::vector<std::unique_ptr<PlanNode>> children_;
     };
 
@@ -127,15 +156,159 @@ namespace planner {
 
     class CreateTableNode : public PlanNode {
     public:
-        CreateTableNode(std::string table_name, storage::Schema schema)
-                : table_name_(std::move(table_name)), schema_(std::move(schema)) {}
+        CreateTableNode(std::string table_name, storage::Schema schema, storage::TableStorage storage = storage::TableStorage::ROW,
+                        std::optional<storage::PartitionScheme> partitioning = std::nullopt)
+                : table_name_(std::move(table_name)), schema_(std::move(schema)), storage_(storage),
+                  partitioning_(std::move(partitioning)) {}
         PlanNodeType GetType() const override { return CREATE_TABLE_STATEMENT; }
         std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
         const std::string& GetTableName() const { return table_name_; }
         const storage::Schema& GetSchema() const { return schema_; }
+        storage::TableStorage GetStorage() const { return storage_; }
+        const std::optional<storage::PartitionScheme>& GetPartitioning() const { return partitioning_; }
     private:
         std::string table_name_;
         storage::Schema schema_;
+        storage::TableStorage storage_;
+        std::optional<storage::PartitionScheme> partitioning_;
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    class ShowBufferPoolNode : public PlanNode {
+    public:
+        ShowBufferPoolNode() = default;
+        PlanNodeType GetType() const override { return SHOW_BUFFER_POOL_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+    private:
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    class CheckpointNode : public PlanNode {
+    public:
+        CheckpointNode() = default;
+        PlanNodeType GetType() const override { return CHECKPOINT_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+    private:
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    class VacuumNode : public PlanNode {
+    public:
+        explicit VacuumNode(std::string table_name) : table_name_(std::move(table_name)) {}
+        PlanNodeType GetType() const override { return VACUUM_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+        const std::string& GetTableName() const { return table_name_; }
+    private:
+        std::string table_name_;
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    enum class AlterTableAction {
+        ADD_PARTITION,
+        DROP_PARTITION
+    };
+
+    class AlterTableNode : public PlanNode {
+    public:
+        AlterTableNode(std::string table_name, AlterTableAction action, storage::PartitionDefinition partition)
+                : table_name_(std::move(table_name)), action_(action), partition_(std::move(partition)) {}
+        PlanNodeType GetType() const override { return ALTER_TABLE_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+        const std::string& GetTableName() const { return table_name_; }
+        AlterTableAction GetAction() const { return action_; }
+        const storage::PartitionDefinition& GetPartition() const { return partition_; }
+    private:
+        std::string table_name_;
+        AlterTableAction action_;
+        storage::PartitionDefinition partition_;
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    class CopyNode : public PlanNode {
+    public:
+        CopyNode(std::string table_name, std::string file_name, storage::CsvOptions options)
+                : table_name_(std::move(table_name)), file_name_(std::move(file_name)), options_(options) {}
+        PlanNodeType GetType() const override { return COPY_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+        const std::string& GetTableName() const { return table_name_; }
+        const std::string& GetFileName() const { return file_name_; }
+        const storage::CsvOptions& GetOptions() const { return options_; }
+    private:
+        std::string table_name_;
+        std::string file_name_;
+        storage::CsvOptions options_;
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    // COPY (query) TO 'file': its only child is the plan of the query.
+    class CopyToNode : public PlanNode {
+    public:
+        CopyToNode(std::unique_ptr<PlanNode> query, std::string file_name, storage::ExportOptions options)
+                : file_name_(std::move(file_name)), options_(options) {
+            children_.push_back(std::move(query));
+        }
+        PlanNodeType GetType() const override { return COPY_TO_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return children_; }
+        const std::string& GetFileName() const { return file_name_; }
+        const storage::ExportOptions& GetOptions() const { return options_; }
+    private:
+        std::vector<std::unique_ptr<PlanNode>> children_;
+        std::string file_name_;
+        storage::ExportOptions options_;
+    };
+
+    class CreateIndexNode : public PlanNode {
+    public:
+        // A degree of 0 packs the index nodes full; see storage::BPlusTree. Hash indexes ignore it.
+        CreateIndexNode(std::string index_name, std::string table_name, std::vector<std::string> column_names, int degree,
+                        storage::IndexType index_type = storage::IndexType::BTREE, std::vector<std::string> include_column_names = {})
+                : index_name_(std::move(index_name)), table_name_(std::move(table_name)), column_names_(std::move(column_names)), degree_(degree),
+                index_type_(index_type), include_column_names_(std::move(include_column_names)) {}
+        PlanNodeType GetType() const override { return CREATE_INDEX_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+        const std::string& GetIndexName() const { return index_name_; }
+        const std::string& GetTableName() const { return table_name_; }
+        const std::vector<std::string>& GetColumnNames() const { return column_names_; }
+        int GetDegree() const { return degree_; }
+        storage::IndexType GetIndexType() const { return index_type_; }
+        const std::vector<std::string>& GetIncludeColumnNames() const { return include_column_names_; }
+    private:
+        std::string index_name_;
+        std::string table_name_;
+        std::vector<std::string> column_names_;
+        int degree_;
+        storage::IndexType index_type_;
+        std::vector<std::string> include_column_names_;
+        static std::vector<std::unique_ptr<PlanNode>> empty_children_;
+    };
+
+    // A filtered SELECT answered from the entries of an index that holds every column the query reads,
+    // without reading the rows. The index conjuncts are those of a FilterNode with the same index.
+    class IndexScanNode : public PlanNode {
+    public:
+        IndexScanNode(std::string table_name, std::vector<std::string> columns, std::string index_name, std::string predicate,
+                      std::string column_name, std::vector<FilterNode::Condition> conditions,
+                      std::vector<FilterNode::Condition> index_prefix)
+                : table_name_(std::move(table_name)), columns_(std::move(columns)), index_name_(std::move(index_name)),
+                predicate_(std::move(predicate)), column_name_(std::move(column_name)), conditions_(std::move(conditions)),
+                index_prefix_(std::move(index_prefix)) {}
+        PlanNodeType GetType() const override { return INDEX_SCAN_STATEMENT; }
+        std::vector<std::unique_ptr<PlanNode>>& GetChildren() override { return empty_children_; }
+        const std::string& GetTableName() const { return table_name_; }
+        const std::vector<std::string>& GetColumns() const { return columns_; }
+        const std::string& GetIndexName() const { return index_name_; }
+        const std::string& GetPredicate() const { return predicate_; }
+        const std::string& GetColumnName() const { return column_name_; }
+        const std::vector<FilterNode::Condition>& GetConditions() const { return conditions_; }
+        const std::vector<FilterNode::Condition>& GetIndexPrefix() const { return index_prefix_; }
+    private:
+        std::string table_name_;
+        std::vector<std::string> columns_;
+        std::string index_name_;
+        std::string predicate_;
+        std::string column_name_;
+        std::vector<FilterNode::Condition> conditions_;
+        std::vector<FilterNode::Condition> index_prefix_;
         static std::vector<std::unique_ptr<PlanNode>> empty_children_;
     };
 }
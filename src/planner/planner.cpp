@@ -1,4 +1,6 @@
 #include "planner.h"
+#include <algorithm>
+#include <iterator>
 
 namespace planner {
     std::unique_ptr<PlanNode> Planner::CreatePlan(std::unique_ptr<PlanNode> logical_plan) {
@@ -30,16 +32,67 @@ namespace planner {
                 if (children.empty()) {
                     throw std::runtime_error("FilterNode has no children");
                 }
+                std::vector<FilterNode::Condition> conjuncts{{filter_node->GetColumnName(), filter_node->GetPredicate()}};
+                conjuncts.insert(conjuncts.end(), filter_node->GetConditions().begin(), filter_node->GetConditions().end());
+                // A filtered SELECT can be answered from an index alone if it holds every column the query reads.
+                auto select_node = dynamic_cast<SelectNode*>(children.front().get());
+                std::vector<std::string> needed_columns;
+                if (select_node) {
+                    for (const auto& column : select_node->GetColumns()) {
+                        if (column != "*") {
+                            needed_columns.push_back(column);
+                            continue;
+                        }
+                        for (const auto& table_column : catalog_->GetTable(filter_node->GetTableName())->GetSchema().GetColumns()) {
+                            needed_columns.push_back(table_column.name);
+                        }
+                    }
+                    for (const auto& conjunct : conjuncts) needed_columns.push_back(conjunct.column_name);
+                }
                 std::string index_name;
-                bool has_index = HasIndexForColumn(filter_node->GetTableName(),
-                                                   filter_node->GetColumnName(), index_name);
+                bool covering = false;
+                std::vector<size_t> served = ChooseIndex(filter_node->GetTableName(), conjuncts, needed_columns, index_name, covering);
+
+                // The index is searched with the last conjunct it serves as the filter's own predicate,
+                // after the "=" on the columns before it; everything else is left as a condition.
+                size_t primary = served.empty() ? 0 : served.back();
+                std::vector<FilterNode::Condition> index_prefix;
+                for (size_t i = 0; i + 1 < served.size(); ++i) index_prefix.push_back(conjuncts[served[i]]);
+                std::vector<FilterNode::Condition> conditions;
+                for (size_t i = 0; i < conjuncts.size(); ++i) {
+                    if (i != primary && std::find(served.begin(), served.end(), i) == served.end()) conditions.push_back(conjuncts[i]);
+                }
+                if (covering) {
+                    return std::make_unique<IndexScanNode>(filter_node->GetTableName(), select_node->GetColumns(), index_name,
+                                                           conjuncts[primary].predicate, conjuncts[primary].column_name,
+                                                           std::move(conditions), std::move(index_prefix));
+                }
+
                 auto child_plan = CreatePlan(std::move(children.front()));
+                if (auto select_plan = dynamic_cast<SelectNode*>(child_plan.get())) {
+                    if (auto partitioned = catalog_->GetPartitionedTable(filter_node->GetTableName())) {
+                        // Each conjunct on the partition column narrows the partitions further.
+                        const auto& schema = partitioned->GetSchema();
+                        std::vector<size_t> partitions = partitioned->GetScheme().Prune(nullptr);
+                        for (const auto& conjunct : conjuncts) {
+                            auto predicate = storage::ColumnPredicate::Parse(conjunct.predicate, schema.GetColumnIndex(conjunct.column_name));
+                            std::vector<size_t> pruned = partitioned->GetScheme().Prune(&predicate);
+                            std::vector<size_t> kept;
+                            std::set_intersection(partitions.begin(), partitions.end(), pruned.begin(), pruned.end(),
+                                                  std::back_inserter(kept));
+                            partitions = std::move(kept);
+                        }
+                        select_plan->SetPartitions(std::move(partitions));
+                    }
+                }
                 return std::make_unique<FilterNode>(
                         std::move(child_plan),
-                        filter_node->GetPredicate(),
-                        filter_node->GetColumnName(),
-                        has_index ? index_name : "",
-                        filter_node->GetTableName()
+                        conjuncts[primary].predicate,
+                        conjuncts[primary].column_name,
+                        index_name,
+                        filter_node->GetTableName(),
+                        std::move(conditions),
+                        std::move(index_prefix)
                         );
             }
             case SORT_STATEMENT: {
@@ -73,25 +126,115 @@ namespace planner {
             case CREATE_TABLE_STATEMENT: {
                 auto create_table_node = dynamic_cast<CreateTableNode*>(logical_plan.get());
                 if (!create_table_node) throw std::runtime_error("Invalid CreateTableNode");
-                return std::make_unique<CreateTableNode>(create_table_node->GetTableName(), create_table_node->GetSchema());
+                return std::make_unique<CreateTableNode>(create_table_node->GetTableName(), create_table_node->GetSchema(),
+                                                         create_table_node->GetStorage(), create_table_node->GetPartitioning());
+            }
+            case SHOW_BUFFER_POOL_STATEMENT: {
+                return std::make_unique<ShowBufferPoolNode>();
+            }
+            case CHECKPOINT_STATEMENT: {
+                return std::make_unique<CheckpointNode>();
+            }
+            case VACUUM_STATEMENT: {
+                auto vacuum_node = dynamic_cast<VacuumNode*>(logical_plan.get());
+                if (!vacuum_node) throw std::runtime_error("Invalid VacuumNode");
+                if (!catalog_->HasTable(vacuum_node->GetTableName())) {
+                    throw std::runtime_error("Table not found: " + vacuum_node->GetTableName());
+                }
+                return std::make_unique<VacuumNode>(vacuum_node->GetTableName());
+            }
+            case ALTER_TABLE_STATEMENT: {
+                auto alter_node = dynamic_cast<AlterTableNode*>(logical_plan.get());
+                if (!alter_node) throw std::runtime_error("Invalid AlterTableNode");
+                if (!catalog_->HasTable(alter_node->GetTableName())) {
+                    throw std::runtime_error("Table not found: " + alter_node->GetTableName());
+                }
+                return std::make_unique<AlterTableNode>(alter_node->GetTableName(), alter_node->GetAction(), alter_node->GetPartition());
+            }
+            case COPY_STATEMENT: {
+                auto copy_node = dynamic_cast<CopyNode*>(logical_plan.get());
+                if (!copy_node) throw std::runtime_error("Invalid CopyNode");
+                if (!catalog_->HasTable(copy_node->GetTableName())) {
+                    throw std::runtime_error("Table not found: " + copy_node->GetTableName());
+                }
+                return std::make_unique<CopyNode>(copy_node->GetTableName(), copy_node->GetFileName(), copy_node->GetOptions());
+            }
+            case COPY_TO_STATEMENT: {
+                auto copy_node = dynamic_cast<CopyToNode*>(logical_plan.get());
+                if (!copy_node) throw std::runtime_error("Invalid CopyToNode");
+                auto& children = copy_node->GetChildren();
+                if (children.empty()) throw std::runtime_error("CopyToNode has no query");
+                auto query_plan = CreatePlan(std::move(children.front()));
+                return std::make_unique<CopyToNode>(std::move(query_plan), copy_node->GetFileName(), copy_node->GetOptions());
+            }
+            case INDEX_SCAN_STATEMENT: {
+                throw std::runtime_error("Index scans are only planned from filters");
+            }
+            case CREATE_INDEX_STATEMENT: {
+                auto create_index_node = dynamic_cast<CreateIndexNode*>(logical_plan.get());
+                if (!create_index_node) throw std::runtime_error("Invalid CreateIndexNode");
+                if (!catalog_->HasTable(create_index_node->GetTableName())) {
+                    throw std::runtime_error("Table not found: " + create_index_node->GetTableName());
+                }
+                return std::make_unique<CreateIndexNode>(create_index_node->GetIndexName(), create_index_node->GetTableName(),
+                                                         create_index_node->GetColumnNames(), create_index_node->GetDegree(),
+                                                         create_index_node->GetIndexType(), create_index_node->GetIncludeColumnNames());
             }
         }
     }
 
-    bool Planner::HasIndexForColumn(const std::string& table_name, const std::string& column_name, std::string& index_name) const {
-        auto indexes = catalog_->GetIndexesForTable(table_name);
-        for (const auto& [index_record, column_names] : indexes) {
-            for (const auto& indexed_column : column_names) {
-                if (indexed_column == column_name) {
-                    index_name = index_record.index_name;
-                    return true;
-                }
+    std::vector<size_t> Planner::ChooseIndex(const std::string& table_name, const std::vector<FilterNode::Condition>& conjuncts,
+                                             const std::vector<std::string>& needed_columns, std::string& index_name,
+                                             bool& covering) const {
+        std::vector<std::string> ops;
+        for (const auto& conjunct : conjuncts) ops.push_back(storage::ColumnPredicate::Parse(conjunct.predicate, 0).op);
+        auto find_conjunct = [&](const std::string& column, bool equality, const std::vector<size_t>& served) {
+            for (size_t i = 0; i < conjuncts.size(); ++i) {
+                if (conjuncts[i].column_name != column || (ops[i] == "=") != equality) continue;
+                if (std::find(served.begin(), served.end(), i) == served.end()) return i;
+            }
+            return conjuncts.size();
+        };
+
+        std::vector<size_t> best;
+        bool best_hash = false;
+        covering = false;
+        for (const auto& [index_record, column_names] : catalog_->GetIndexesForTable(table_name)) {
+            bool hash = static_cast<storage::IndexType>(index_record.index_type) == storage::IndexType::HASH;
+            std::vector<size_t> served;
+            while (served.size() < column_names.size()) {
+                size_t i = find_conjunct(column_names[served.size()], true, served);
+                if (i == conjuncts.size()) break;
+                served.push_back(i);
+            }
+            if (hash && served.size() < column_names.size()) continue;
+            if (!hash && served.size() < column_names.size()) {
+                size_t i = find_conjunct(column_names[served.size()], false, served);
+                if (i < conjuncts.size()) served.push_back(i);
+            }
+            if (served.empty()) continue;
+            bool holds_all = !needed_columns.empty() && std::all_of(needed_columns.begin(), needed_columns.end(), [&](const std::string& column) {
+                return std::find(column_names.begin(), column_names.end(), column) != column_names.end();
+            });
+            if (served.size() > best.size() ||
+                (served.size() == best.size() && std::make_pair(holds_all, hash) > std::make_pair(covering, best_hash))) {
+                best = std::move(served);
+                best_hash = hash;
+                covering = holds_all;
+                index_name = index_record.index_name;
             }
         }
-        return false;
+        return best;
     }
 
     std::vector<std::unique_ptr<planner::PlanNode>> planner::SelectNode::empty_children_;
     std::vector<std::unique_ptr<planner::PlanNode>> planner::InsertNode::empty_children_;
     std::vector<std::unique_ptr<planner::PlanNode>> planner::CreateTableNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::ShowBufferPoolNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::CheckpointNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::VacuumNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::AlterTableNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::CopyNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::CreateIndexNode::empty_children_;
+    std::vector<std::unique_ptr<planner::PlanNode>> planner::IndexScanNode::empty_children_;
 }
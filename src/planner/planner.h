@@ -2,6 +2,7 @@
 
 #include "catalog.h"
 #include "nodes.h"
+#include <vector>
 
 namespace planner {
     class Planner {
@@ -11,6 +12,11 @@ namespace planner {
         std::unique_ptr<PlanNode> CreatePlan(std::unique_ptr<PlanNode> logical_plan);
     private:
         std::shared_ptr<catalog::Catalog> catalog_;
-        bool HasIndexForColumn(const std::string& table_name, const std::string& column_name, std::string& index_name) const;
+        // Picks the index that serves the most conjuncts and returns their positions in conjuncts, in index
+        // column order: "=" on leading columns of the index, then for a B+tree one more conjunct on the next
+        // column. A hash index serves only "=" on all of its columns. Ties go to an index holding all of
+        // needed_columns (covering is set then), then to a hash index. Empty when no index helps.
+        std::vector<size_t> ChooseIndex(const std::string& table_name, const std::vector<FilterNode::Condition>& conjuncts,
+                                        const std::vector<std::string>& needed_columns, std::string& index_name, bool& covering) const;
     };
 }
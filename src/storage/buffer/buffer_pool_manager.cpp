@@ -0,0 +1,178 @@
+#include "buffer_pool_manager.h"
+#include <stdexcept>
+
+namespace storage {
+    PageGuard::PageGuard(PageGuard &&other) noexcept
+            : buffer_pool_(other.buffer_pool_), page_(other.page_), is_dirty_(other.is_dirty_) {
+        other.buffer_pool_ = nullptr;
+        other.page_ = nullptr;
+        other.is_dirty_ = false;
+    }
+
+    PageGuard &PageGuard::operator=(PageGuard &&other) noexcept {
+        if (this != &other) {
+            Release();
+            buffer_pool_ = other.buffer_pool_;
+            page_ = other.page_;
+            is_dirty_ = other.is_dirty_;
+            other.buffer_pool_ = nullptr;
+            other.page_ = nullptr;
+            other.is_dirty_ = false;
+        }
+        return *this;
+    }
+
+    void PageGuard::Release() {
+        if (buffer_pool_ && page_) buffer_pool_->UnpinPage(page_->GetPageId(), is_dirty_);
+        buffer_pool_ = nullptr;
+        page_ = nullptr;
+        is_dirty_ = false;
+    }
+
+    BufferPoolManager::BufferPoolManager(size_t pool_size, std::shared_ptr<DiskManager> disk_manager, size_t replacer_k)
+            : pool_size_(pool_size), pages_(pool_size), disk_manager_(std::move(disk_manager)),
+              replacer_(pool_size, replacer_k), hits_(0), misses_(0), evictions_(0) {
+        if (pool_size_ == 0) throw std::invalid_argument("Buffer pool size must be positive");
+        for (size_t i = 0; i < pool_size_; ++i) free_list_.push_back(static_cast<FrameId>(i));
+    }
+
+    bool BufferPoolManager::AcquireFrame(FrameId &frame_id) {
+        if (!free_list_.empty()) {
+            frame_id = free_list_.front();
+            free_list_.pop_front();
+            return true;
+        }
+        if (!replacer_.Evict(frame_id)) return false;
+
+        Page& victim = pages_[frame_id];
+        if (victim.is_dirty_) disk_manager_->WritePage(victim.page_id_, victim.GetData());
+        page_table_.erase(victim.page_id_);
+        victim.page_id_ = INVALID_PAGE_ID;
+        victim.is_dirty_ = false;
+        ++evictions_;
+        return true;
+    }
+
+    Page *BufferPoolManager::NewPage(PageId &page_id) {
+        std::lock_guard<std::mutex> lock(latch_);
+        FrameId frame_id;
+        if (!AcquireFrame(frame_id)) return nullptr;
+
+        page_id = disk_manager_->AllocatePage();
+        Page& page = pages_[frame_id];
+        page.Reset();
+        page.page_id_ = page_id;
+        page.pin_count_ = 1;
+        page.is_dirty_ = true;
+        page_table_[page_id] = frame_id;
+
+        replacer_.RecordAccess(frame_id);
+        replacer_.SetEvictable(frame_id, false);
+        return &page;
+    }
+
+    Page *BufferPoolManager::FetchPage(PageId page_id) {
+        std::lock_guard<std::mutex> lock(latch_);
+        auto it = page_table_.find(page_id);
+        if (it != page_table_.end()) {
+            ++hits_;
+            Page& page = pages_[it->second];
+            ++page.pin_count_;
+            replacer_.RecordAccess(it->second);
+            replacer_.SetEvictable(it->second, false);
+            return &page;
+        }
+
+        ++misses_;
+        FrameId frame_id;
+        if (!AcquireFrame(frame_id)) return nullptr;
+
+        Page& page = pages_[frame_id];
+        try {
+            disk_manager_->ReadPage(page_id, page.GetData());
+        } catch (...) {
+            free_list_.push_back(frame_id);
+            throw;
+        }
+        page.page_id_ = page_id;
+        page.pin_count_ = 1;
+        page.is_dirty_ = false;
+        page_table_[page_id] = frame_id;
+
+        replacer_.RecordAccess(frame_id);
+        replacer_.SetEvictable(frame_id, false);
+        return &page;
+    }
+
+    bool BufferPoolManager::UnpinPage(PageId page_id, bool is_dirty) {
+        std::lock_guard<std::mutex> lock(latch_);
+        auto it = page_table_.find(page_id);
+        if (it == page_table_.end()) return false;
+
+        Page& page = pages_[it->second];
+        if (page.pin_count_ <= 0) return false;
+        page.is_dirty_ = page.is_dirty_ || is_dirty;
+        if (--page.pin_count_ == 0) replacer_.SetEvictable(it->second, true);
+        return true;
+    }
+
+    bool BufferPoolManager::FlushPage(PageId page_id) {
+        std::lock_guard<std::mutex> lock(latch_);
+        auto it = page_table_.find(page_id);
+        if (it == page_table_.end()) return false;
+
+        Page& page = pages_[it->second];
+        disk_manager_->WritePage(page_id, page.GetData());
+        page.is_dirty_ = false;
+        return true;
+    }
+
+    void BufferPoolManager::FlushAllPages() {
+        std::lock_guard<std::mutex> lock(latch_);
+        for (auto& [page_id, frame_id] : page_table_) {
+            Page& page = pages_[frame_id];
+            if (!page.is_dirty_) continue;
+            disk_manager_->WritePage(page_id, page.GetData());
+            page.is_dirty_ = false;
+        }
+    }
+
+    bool BufferPoolManager::DeletePage(PageId page_id) {
+        std::lock_guard<std::mutex> lock(latch_);
+        auto it = page_table_.find(page_id);
+        if (it != page_table_.end()) {
+            Page& page = pages_[it->second];
+            if (page.pin_count_ > 0) return false;
+
+            replacer_.Remove(it->second);
+            free_list_.push_back(it->second);
+            page.Reset();
+            page.page_id_ = INVALID_PAGE_ID;
+            page.is_dirty_ = false;
+            page_table_.erase(it);
+        }
+        disk_manager_->DeallocatePage(page_id);
+        return true;
+    }
+
+    PageGuard BufferPoolManager::NewPageGuarded(PageId &page_id) {
+        Page* page = NewPage(page_id);
+        if (!page) throw std::runtime_error("Buffer pool is full: all frames are pinned");
+        return {this, page};
+    }
+
+    PageGuard BufferPoolManager::FetchPageGuarded(PageId page_id) {
+        Page* page = FetchPage(page_id);
+        if (!page) throw std::runtime_error("Buffer pool is full: all frames are pinned");
+        return {this, page};
+    }
+
+    size_t BufferPoolManager::GetPoolSize() const {
+        return pool_size_;
+    }
+
+    BufferPoolStats BufferPoolManager::GetStats() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        return {pool_size_, hits_, misses_, evictions_, disk_manager_->GetNumReads(), disk_manager_->GetNumWrites()};
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "page.h"
+#include "disk_manager.h"
+#include "lru_k_replacer.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace storage {
+    static constexpr size_t DEFAULT_BUFFER_POOL_SIZE = 1024;
+    static constexpr size_t DEFAULT_REPLACER_K = 2;
+
+    struct BufferPoolStats {
+        size_t pool_size;
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t pages_read;
+        size_t pages_written;
+    };
+
+    class BufferPoolManager;
+
+    class PageGuard {
+    public:
+        PageGuard() : buffer_pool_(nullptr), page_(nullptr), is_dirty_(false) {}
+        PageGuard(BufferPoolManager* buffer_pool, Page* page) : buffer_pool_(buffer_pool), page_(page), is_dirty_(false) {}
+        PageGuard(PageGuard&& other) noexcept;
+        PageGuard& operator=(PageGuard&& other) noexcept;
+        PageGuard(const PageGuard&) = delete;
+        PageGuard& operator=(const PageGuard&) = delete;
+        ~PageGuard() { Release(); }
+
+        [[nodiscard]] PageId GetPageId() const { return page_->GetPageId(); }
+        char* GetData() { return page_->GetData(); }
+        [[nodiscard]] const char* GetData() const { return page_->GetData(); }
+        void MarkDirty() { is_dirty_ = true; }
+        void Release();
+
+    private:
+        BufferPoolManager* buffer_pool_;
+        Page* page_;
+        bool is_dirty_;
+    };
+
+    // Caches table pages in a fixed number of frames. Index nodes are heap-allocated and not held here.
+    class BufferPoolManager {
+    public:
+        BufferPoolManager(size_t pool_size, std::shared_ptr<DiskManager> disk_manager, size_t replacer_k = DEFAULT_REPLACER_K);
+        ~BufferPoolManager() = default;
+
+        BufferPoolManager(const BufferPoolManager&) = delete;
+        BufferPoolManager& operator=(const BufferPoolManager&) = delete;
+
+        Page* NewPage(PageId& page_id);
+        Page* FetchPage(PageId page_id);
+        bool UnpinPage(PageId page_id, bool is_dirty);
+        bool FlushPage(PageId page_id);
+        void FlushAllPages();
+        bool DeletePage(PageId page_id);
+
+        PageGuard NewPageGuarded(PageId& page_id);
+        PageGuard FetchPageGuarded(PageId page_id);
+
+        [[nodiscard]] size_t GetPoolSize() const;
+        [[nodiscard]] BufferPoolStats GetStats() const;
+
+    private:
+        size_t pool_size_;
+        std::vector<Page> pages_;
+        std::shared_ptr<DiskManager> disk_manager_;
+        LRUKReplacer replacer_;
+        std::unordered_map<PageId, FrameId> page_table_;
+        std::list<FrameId> free_list_;
+        size_t hits_;
+        size_t misses_;
+        size_t evictions_;
+        mutable std::mutex latch_;
+
+        bool AcquireFrame(FrameId& frame_id);
+    };
+}
@@ -0,0 +1,93 @@
+#include "disk_manager.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+namespace storage {
+    DiskManager::DiskManager(const std::string& file_name)
+            : file_name_(file_name), fd_(-1), next_page_id_(0), num_reads_(0), num_writes_(0) {
+        if (file_name_.empty()) {
+            std::string path = (std::filesystem::temp_directory_path() / "vovinquity-XXXXXX").string();
+            fd_ = mkstemp(path.data());
+            if (fd_ >= 0) unlink(path.c_str());
+        } else {
+            fd_ = open(file_name_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        }
+        if (fd_ < 0) throw std::system_error(errno, std::generic_category(), "Failed to open data file " + file_name_);
+    }
+
+    DiskManager::~DiskManager() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    void DiskManager::ReadPage(PageId page_id, char *data) {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (page_id < 0 || page_id >= next_page_id_) throw std::out_of_range("Invalid page id");
+
+        off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+        size_t done = 0;
+        while (done < PAGE_SIZE) {
+            ssize_t n = pread(fd_, data + done, PAGE_SIZE - done, offset + static_cast<off_t>(done));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "Failed to read page");
+            }
+            if (n == 0) {
+                std::memset(data + done, 0, PAGE_SIZE - done);
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        ++num_reads_;
+    }
+
+    void DiskManager::WritePage(PageId page_id, const char *data) {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (page_id < 0 || page_id >= next_page_id_) throw std::out_of_range("Invalid page id");
+
+        off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+        size_t done = 0;
+        while (done < PAGE_SIZE) {
+            ssize_t n = pwrite(fd_, data + done, PAGE_SIZE - done, offset + static_cast<off_t>(done));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "Failed to write page");
+            }
+            done += static_cast<size_t>(n);
+        }
+        ++num_writes_;
+    }
+
+    PageId DiskManager::AllocatePage() {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (!free_pages_.empty()) {
+            PageId page_id = free_pages_.back();
+            free_pages_.pop_back();
+            return page_id;
+        }
+        return next_page_id_++;
+    }
+
+    void DiskManager::DeallocatePage(PageId page_id) {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (page_id >= 0 && page_id < next_page_id_) free_pages_.push_back(page_id);
+    }
+
+    size_t DiskManager::GetNumReads() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        return num_reads_;
+    }
+
+    size_t DiskManager::GetNumWrites() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        return num_writes_;
+    }
+
+    const std::string &DiskManager::GetFileName() const {
+        return file_name_;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "page.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace storage {
+    class DiskManager {
+    public:
+        // An empty file name backs the pages with an anonymous temporary file.
+        explicit DiskManager(const std::string& file_name);
+        ~DiskManager();
+
+        DiskManager(const DiskManager&) = delete;
+        DiskManager& operator=(const DiskManager&) = delete;
+
+        void ReadPage(PageId page_id, char* data);
+        void WritePage(PageId page_id, const char* data);
+        PageId AllocatePage();
+        void DeallocatePage(PageId page_id);
+
+        [[nodiscard]] size_t GetNumReads() const;
+        [[nodiscard]] size_t GetNumWrites() const;
+        [[nodiscard]] const std::string& GetFileName() const;
+
+    private:
+        std::string file_name_;
+        int fd_;
+        PageId next_page_id_;
+        std::vector<PageId> free_pages_;
+        size_t num_reads_;
+        size_t num_writes_;
+        mutable std::mutex latch_;
+    };
+}
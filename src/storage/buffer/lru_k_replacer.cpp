@@ -0,0 +1,65 @@
+#include "lru_k_replacer.h"
+#include <limits>
+#include <stdexcept>
+
+namespace storage {
+    LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+            : frames_(num_frames), k_(k), current_timestamp_(0), evictable_count_(0) {
+        if (k_ == 0) throw std::invalid_argument("LRU-K replacer requires k > 0");
+    }
+
+    void LRUKReplacer::RecordAccess(FrameId frame_id) {
+        if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) throw std::out_of_range("Invalid frame id");
+        auto& history = frames_[frame_id].history;
+        history.push_back(current_timestamp_++);
+        if (history.size() > k_) history.pop_front();
+    }
+
+    void LRUKReplacer::SetEvictable(FrameId frame_id, bool evictable) {
+        if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) throw std::out_of_range("Invalid frame id");
+        auto& frame = frames_[frame_id];
+        if (frame.evictable == evictable) return;
+        frame.evictable = evictable;
+        if (evictable) ++evictable_count_;
+        else --evictable_count_;
+    }
+
+    bool LRUKReplacer::Evict(FrameId &frame_id) {
+        bool found = false;
+        bool found_infinite = false;
+        uint64_t best_timestamp = std::numeric_limits<uint64_t>::max();
+
+        for (size_t i = 0; i < frames_.size(); ++i) {
+            const auto& frame = frames_[i];
+            if (!frame.evictable || frame.history.empty()) continue;
+
+            bool infinite = frame.history.size() < k_;
+            uint64_t timestamp = frame.history.front();
+            if (infinite && !found_infinite) {
+                found_infinite = true;
+                best_timestamp = timestamp;
+                frame_id = static_cast<FrameId>(i);
+                found = true;
+            } else if (infinite == found_infinite && timestamp < best_timestamp) {
+                best_timestamp = timestamp;
+                frame_id = static_cast<FrameId>(i);
+                found = true;
+            }
+        }
+
+        if (found) Remove(frame_id);
+        return found;
+    }
+
+    void LRUKReplacer::Remove(FrameId frame_id) {
+        if (frame_id < 0 || static_cast<size_t>(frame_id) >= frames_.size()) throw std::out_of_range("Invalid frame id");
+        auto& frame = frames_[frame_id];
+        if (frame.evictable) --evictable_count_;
+        frame.evictable = false;
+        frame.history.clear();
+    }
+
+    size_t LRUKReplacer::Size() const {
+        return evictable_count_;
+    }
+}
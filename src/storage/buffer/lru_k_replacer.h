@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace storage {
+    using FrameId = int32_t;
+
+    /*
+     * Evicts the frame whose k-th most recent access is the oldest. Frames with
+     * fewer than k recorded accesses have an infinite backward k-distance and are
+     * evicted first (oldest first access wins), so a single sequential scan cannot
+     * push frequently used pages out of the pool.
+     */
+    class LRUKReplacer {
+    public:
+        LRUKReplacer(size_t num_frames, size_t k);
+
+        void RecordAccess(FrameId frame_id);
+        void SetEvictable(FrameId frame_id, bool evictable);
+        bool Evict(FrameId& frame_id);
+        void Remove(FrameId frame_id);
+        [[nodiscard]] size_t Size() const;
+
+    private:
+        struct FrameInfo {
+            std::deque<uint64_t> history;
+            bool evictable = false;
+        };
+
+        std::vector<FrameInfo> frames_;
+        size_t k_;
+        uint64_t current_timestamp_;
+        size_t evictable_count_;
+    };
+}
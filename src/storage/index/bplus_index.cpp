@@ -1,4 +1,5 @@
 #include "bplus_index.h"
+#include <algorithm>
 
 namespace storage {
     template<typename KeyType>
@@ -8,39 +9,34 @@ namespace storage {
 
     template<typename KeyType>
     void BPlusIndex<KeyType>::Insert(const KeyType &key, RID rid) {
-        bplus_tree_->Insert(key);
-        key_rid_.emplace(key, rid);
+        bplus_tree_->Insert(key, rid);
     }
 
     template<typename KeyType>
     void BPlusIndex<KeyType>::Remove(const KeyType &key, RID rid) {
-        auto range = key_rid_.equal_range(key);
-        for (auto it = range.first; it != range.second; ++it) {
-            if (it->second == rid) {
-                key_rid_.erase(it);
-                break;
-            }
-        }
-        if (key_rid_.count(key) == 0) bplus_tree_->Remove(key);
+        bplus_tree_->Remove(key, rid);
     }
 
     template<typename KeyType>
     std::vector<RID> BPlusIndex<KeyType>::Search(const KeyType &key) const {
-        std::vector<RID> rids;
-        auto range = key_rid_.equal_range(key);
-        for (auto it = range.first; it != range.second; ++it) rids.push_back(it->second);
-        return rids;
+        return bplus_tree_->Search(key);
     }
 
     template<typename KeyType>
     std::vector<RID> BPlusIndex<KeyType>::RangeQuery(const KeyType &lower, const KeyType &upper) const {
-        std::vector<KeyType> keys_in_range = bplus_tree_->RangeQuery(lower, upper);
-        std::vector<RID> rids;
-        for (const auto& key : keys_in_range) {
-            auto range = key_rid_.equal_range(key);
-            for (auto it = range.first; it != range.second; ++it) rids.push_back(it->second);
+        return bplus_tree_->RangeQuery(lower, upper);
+    }
+
+    template<typename KeyType>
+    void BPlusIndex<KeyType>::BulkLoad(const std::vector<std::pair<KeyType, RID>> &sorted_entries) {
+        // Entries with equal keys may come in any RID order; the tree wants them by (key, RID).
+        if (std::is_sorted(sorted_entries.begin(), sorted_entries.end())) {
+            bplus_tree_->BulkLoad(sorted_entries);
+            return;
         }
-        return rids;
+        auto entries = sorted_entries;
+        std::sort(entries.begin(), entries.end());
+        bplus_tree_->BulkLoad(entries);
     }
 
     template class BPlusIndex<int>;
@@ -1,29 +1,32 @@
 #pragma once
 
 #include "tuple.h"
+#include "index.h"
 #include "bplus_tree.h"
 #include <vector>
 #include <utility>
-#include <map>
 
 namespace storage {
-    class IndexBase {
-    public:
-        virtual ~IndexBase() = default;
-    };
-
     template<typename KeyType>
     class BPlusIndex : public IndexBase {
     public:
+        using Cursor = typename BPlusTree<KeyType>::Cursor;
+
         explicit BPlusIndex(int degree);
         ~BPlusIndex() override = default;
 
         void Insert(const KeyType& key, RID rid);
         void Remove(const KeyType& key, RID rid);
+        // Cursors read the entries in key order without materializing them; see BPlusTree::Cursor.
+        [[nodiscard]] Cursor Begin() const { return bplus_tree_->Begin(); }
+        [[nodiscard]] Cursor Last() const { return bplus_tree_->Last(); }
+        [[nodiscard]] Cursor LowerBound(const KeyType& key) const { return bplus_tree_->LowerBound(key); }
+        [[nodiscard]] Cursor UpperBound(const KeyType& key) const { return bplus_tree_->UpperBound(key); }
         [[nodiscard]] std::vector<RID> Search(const KeyType& key) const;
         [[nodiscard]] std::vector<RID> RangeQuery(const KeyType& lower, const KeyType& upper) const;
+        // Replaces the contents with entries sorted by key, building the tree bottom-up.
+        void BulkLoad(const std::vector<std::pair<KeyType, RID>>& sorted_entries);
     private:
         std::unique_ptr<BPlusTree<KeyType>> bplus_tree_;
-        std::multimap<KeyType, RID> key_rid_;
     };
 }
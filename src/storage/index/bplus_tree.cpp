@@ -1,282 +1,422 @@
 #include "bplus_tree.h"
-#include "tuple.h"
+#include <algorithm>
+#include <type_traits>
 
 namespace storage {
     template<typename T>
-    BPlusTree<T>::BPlusTree(int degree) : root(nullptr), t(degree) {}
-
-    template<typename T>
-    void BPlusTree<T>::Insert(const T &key) {
-        if (!root) {
-            root = std::make_unique<Node>(true);
-            root->keys.push_back(key);
-            return;
-        }
-        if (root->keys.size() == 2 * t - 1) {
-            auto newRoot = std::make_unique<Node>();
-            newRoot->children.emplace_back(std::move(root));
-            SplitChild(newRoot.get(), 0, newRoot->children[0]);
-            root = std::move(newRoot);
-        }
-        InsertNonFull(root.get(), key);
+    BPlusTree<T>::BPlusTree(int degree) : root(nullptr), rightmost(nullptr) {
+        max_keys = degree <= 0 ? NODE_CAPACITY : std::min(2 * static_cast<size_t>(std::max(degree, 2)) - 1, NODE_CAPACITY);
+        min_keys = (max_keys - 1) / 2;
     }
 
     template<typename T>
-    bool BPlusTree<T>::Search(const T &key) const {
-        return Search(root.get(), key);
+    BPlusTree<T>::~BPlusTree() {
+        Free(root);
     }
 
     template<typename T>
-    bool BPlusTree<T>::Search(const BPlusTree<T>::Node *node, const T &key) const {
-        if (!node) {
-            return false;
-        }
-        int i = 0;
-        while (i < node->keys.size() && key > node->keys[i]) {
-            ++i;
-        }
-        if (i < node->keys.size() and node->keys[i] == key) {
-            return true;
-        }
+    void BPlusTree<T>::Free(Node *node) {
+        if (!node) return;
         if (node->isLeaf) {
-            return false;
+            delete AsLeaf(node);
+            return;
         }
-        return Search(node->children[i].get(), key);
+        InnerNode* inner = AsInner(node);
+        for (size_t i = 0; i <= inner->size; ++i) Free(inner->children[i]);
+        delete inner;
     }
 
     template<typename T>
-    void BPlusTree<T>::SplitChild(Node *parent, int index, std::unique_ptr<Node> &child) {
-        auto newChild = std::make_unique<Node>(child->isLeaf);
-        newChild->keys.assign(child->keys.begin() + t, child->keys.end());
-        child->keys.resize(t - 1);
-
-        if (!child->isLeaf) {
-            newChild->children.assign(
-                    std::make_move_iterator(child->children.begin() + t),
-                    std::make_move_iterator(child->children.end())
-            );
-            child->children.resize(t);
+    template<bool Upper>
+    size_t BPlusTree<T>::SearchNode(const Node *node, const T &key) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            size_t count = node->size;
+            if (count == 0) return 0;
+            // The comparison feeds a conditional move rather than a branch the CPU has to predict.
+            const T* base = node->keys;
+            while (count > 1) {
+                size_t half = count / 2;
+                bool before = Upper ? !(key < base[half]) : base[half] < key;
+                base = before ? base + half : base;
+                count -= half;
+            }
+            bool before = Upper ? !(key < *base) : *base < key;
+            return static_cast<size_t>(base - node->keys) + (before ? 1 : 0);
+        } else if constexpr (Upper) {
+            return static_cast<size_t>(std::upper_bound(node->keys, node->keys + node->size, key) - node->keys);
         } else {
-            newChild->next = child->next;
-            child->next = newChild.get();
+            return static_cast<size_t>(std::lower_bound(node->keys, node->keys + node->size, key) - node->keys);
         }
+    }
 
-        parent->keys.insert(parent->keys.begin() + index, child->keys[t - 1]);
-        parent->children.emplace(parent->children.begin() + index + 1, std::move(newChild));
+    template<typename T>
+    size_t BPlusTree<T>::FindEntry(const Node *node, const T &key, RID rid) {
+        size_t index = SearchNode<false>(node, key);
+        while (index < node->size && !(key < node->keys[index]) && node->rids[index] < rid) ++index;
+        return index;
     }
 
     template<typename T>
-    void BPlusTree<T>::InsertNonFull(Node *node, const T &key) {
-        int i = node->keys.size() - 1;
+    size_t BPlusTree<T>::FindChild(const Node *node, const T &key, RID rid) {
+        size_t index = SearchNode<false>(node, key);
+        while (index < node->size && !(key < node->keys[index]) && node->rids[index] <= rid) ++index;
+        return index;
+    }
 
-        if (node->isLeaf) {
-            node->keys.emplace_back();
-            while (i >= 0 && key < node->keys[i]) {
-                node->keys[i + 1] = node->keys[i];
-                --i;
-            }
-            node->keys[i + 1] = key;
-        } else {
-            while (i >= 0 && key < node->keys[i]) {
-                --i;
-            }
-            ++i;
-            if (node->children[i]->keys.size() == 2 * t - 1) {
-                SplitChild(node, i, node->children[i]);
-                if (key > node->keys[i]) {
-                    ++i;
-                }
-            }
-            InsertNonFull(node->children[i].get(), key);
+    template<typename T>
+    BPlusTree<T>::Cursor::Cursor(const LeafNode *leaf, size_t index) : leaf_(leaf), index_(index) {
+        if (leaf_ && index_ == leaf_->size) {
+            leaf_ = leaf_->next;
+            index_ = 0;
         }
     }
 
     template<typename T>
-    void BPlusTree<T>::Remove(const T &key) {
-        if (!root) {
+    void BPlusTree<T>::Cursor::Next() {
+        if (++index_ < leaf_->size) return;
+        leaf_ = leaf_->next;
+        index_ = 0;
+    }
+
+    template<typename T>
+    void BPlusTree<T>::Cursor::Prev() {
+        if (index_ > 0) {
+            --index_;
             return;
         }
-        Remove(root.get(), key);
-        if (root->keys.empty()) {
-            if (!root->isLeaf) {
-                root = std::move(root->children[0]);
-            } else {
-                root = nullptr;
-            }
-        }
+        leaf_ = leaf_->prev;
+        index_ = leaf_ ? leaf_->size - 1 : 0;
     }
 
     template<typename T>
-    void BPlusTree<T>::Remove(Node *node, const T &key) {
-        int index = FindKey(node, key);
-        if (index < node->keys.size() && node->keys[index] == key) {
-            if (node->isLeaf) {
-                node->keys.erase(node->keys.begin() + index);
-            } else {
-                RemoveFromNonLeaf(node, index);
-            }
-        } else {
-            if (node->isLeaf) {
-                return;
-            }
-            bool flag = (index == node->keys.size());
-            if (node->children[index]->keys.size() < t) {
-                Fill(node, index);
-            }
-            if (flag && index > node->keys.size()) {
-                Remove(node->children[index - 1].get(), key);
-            } else {
-                Remove(node->children[index].get(), key);
-            }
+    template<bool Upper>
+    typename BPlusTree<T>::Cursor BPlusTree<T>::Seek(const T &key) const {
+        const Node* node = root;
+        if (!node) return {};
+        while (!node->isLeaf) {
+            const Node* child = AsInner(node)->children[SearchNode<Upper>(node, key)];
+            __builtin_prefetch(child);
+            __builtin_prefetch(&child->keys[NODE_CAPACITY / 2]);
+            node = child;
         }
+        return Cursor(AsLeaf(node), SearchNode<Upper>(node, key));
     }
 
     template<typename T>
-    int BPlusTree<T>::FindKey(Node *node, const T &key) const {
-        int index = 0;
-        while (index < node->keys.size() && node->keys[index] < key) {
-            ++index;
-        }
-        return index;
+    typename BPlusTree<T>::Cursor BPlusTree<T>::LowerBound(const T &key) const {
+        return Seek<false>(key);
     }
 
     template<typename T>
-    void BPlusTree<T>::RemoveFromNonLeaf(Node *node, int index) {
-        T key = node->keys[index];
-        if (node->children[index]->keys.size() >= t) {
-            T pred = GetPred(node, index);
-            node->keys[index] = pred;
-            Remove(node->children[index].get(), pred);
-        } else if (node->children[index + 1]->keys.size() >= t) {
-            T succ = GetSucc(node, index);
-            node->keys[index] = succ;
-            Remove(node->children[index + 1].get(), succ);
-        } else {
-            Merge(node, index);
-            Remove(node->children[index].get(), key);
-        }
+    typename BPlusTree<T>::Cursor BPlusTree<T>::UpperBound(const T &key) const {
+        return Seek<true>(key);
     }
 
     template<typename T>
-    T BPlusTree<T>::GetPred(Node *node, int index) const {
-        Node *curr = node->children[index].get();
-        while (!curr->isLeaf) {
-            curr = curr->children[curr->children.size() - 1].get();
-        }
-        return curr->keys[curr->keys.size() - 1];
+    typename BPlusTree<T>::Cursor BPlusTree<T>::Begin() const {
+        const Node* node = root;
+        if (!node) return {};
+        while (!node->isLeaf) node = AsInner(node)->children[0];
+        return Cursor(AsLeaf(node), 0);
     }
 
     template<typename T>
-    T BPlusTree<T>::GetSucc(Node *node, int index) const {
-        Node *cur = node->children[index + 1].get();
-        while (!cur->isLeaf) {
-            cur = cur->children[0].get();
-        }
-        return cur->keys[0];
+    typename BPlusTree<T>::Cursor BPlusTree<T>::Last() const {
+        const Node* node = root;
+        if (!node) return {};
+        while (!node->isLeaf) node = AsInner(node)->children[node->size];
+        return Cursor(AsLeaf(node), node->size - 1);
+    }
 
+    template<typename T>
+    void BPlusTree<T>::InsertAt(Node *node, size_t index, T key, RID rid) {
+        std::move_backward(node->keys + index, node->keys + node->size, node->keys + node->size + 1);
+        std::copy_backward(node->rids + index, node->rids + node->size, node->rids + node->size + 1);
+        node->keys[index] = std::move(key);
+        node->rids[index] = rid;
+        ++node->size;
     }
 
     template<typename T>
-    void BPlusTree<T>::Fill(Node *node, int index) {
-        if (index != 0 && node->children[index - 1]->keys.size() >= t) {
-            BorrowFromPrev(node, index);
-        } else if (index != node->keys.size() && node->children[index + 1]->keys.size() >= t) {
-            BorrowFromNext(node, index);
-        } else {
-            if (index != node->keys.size()) {
-                Merge(node, index);
-            } else {
-                Merge(node, index - 1);
+    void BPlusTree<T>::EraseAt(Node *node, size_t index) {
+        std::move(node->keys + index + 1, node->keys + node->size, node->keys + index);
+        std::copy(node->rids + index + 1, node->rids + node->size, node->rids + index);
+        --node->size;
+    }
+
+    template<typename T>
+    void BPlusTree<T>::Insert(const T &key, RID rid) {
+        if (!root) {
+            rightmost = new LeafNode();
+            root = rightmost;
+            InsertAt(root, 0, key, rid);
+            return;
+        }
+        // Appends past the last entry go straight into the rightmost leaf while it has room.
+        if (rightmost->size > 0 && rightmost->size < max_keys) {
+            size_t last = rightmost->size - 1;
+            const T& last_key = rightmost->keys[last];
+            if (last_key < key || (!(key < last_key) && rightmost->rids[last] <= rid)) {
+                InsertAt(rightmost, rightmost->size, key, rid);
+                return;
             }
         }
+        T separator{};
+        RID separator_rid = 0;
+        Node* sibling = Insert(root, key, rid, true, separator, separator_rid);
+        if (sibling) {
+            auto newRoot = new InnerNode();
+            newRoot->keys[0] = std::move(separator);
+            newRoot->rids[0] = separator_rid;
+            newRoot->size = 1;
+            newRoot->children[0] = root;
+            newRoot->children[1] = sibling;
+            root = newRoot;
+        }
     }
 
+    // Returns the new right sibling when the node had to be split, and the separator that goes up.
+    // Nodes split in half, except that an append on the rightmost path leaves the left node nearly
+    // full, so sequential keys fill the tree instead of leaving every node half empty.
     template<typename T>
-    void BPlusTree<T>::BorrowFromPrev(Node *node, int index) {
-        Node *child = node->children[index].get();
-        Node *sibling = node->children[index - 1].get();
-
-        child->keys.insert(child->keys.begin(), node->keys[index - 1]);
-
-        if (!child->isLeaf) {
-            child->children.insert(child->children.begin(), std::move(sibling->children.back()));
-            sibling->children.pop_back();
+    typename BPlusTree<T>::Node* BPlusTree<T>::Insert(Node *node, const T &key, RID rid, bool on_right_edge,
+                                                      T &separator, RID &separator_rid) {
+        size_t middle = (max_keys + 1) / 2;
+        size_t skewed = max_keys - max_keys / 10;
+        if (node->isLeaf) {
+            size_t position = FindEntry(node, key, rid);
+            InsertAt(node, position, key, rid);
+            if (node->size <= max_keys) return nullptr;
+
+            if (on_right_edge && position == max_keys) middle = skewed;
+            auto leaf = AsLeaf(node);
+            auto sibling = new LeafNode();
+            std::move(leaf->keys + middle, leaf->keys + leaf->size, sibling->keys);
+            std::copy(leaf->rids + middle, leaf->rids + leaf->size, sibling->rids);
+            sibling->size = static_cast<uint16_t>(leaf->size - middle);
+            leaf->size = static_cast<uint16_t>(middle);
+            sibling->prev = leaf;
+            sibling->next = leaf->next;
+            if (leaf->next) leaf->next->prev = sibling;
+            leaf->next = sibling;
+            if (rightmost == leaf) rightmost = sibling;
+            separator = sibling->keys[0];
+            separator_rid = sibling->rids[0];
+            return sibling;
         }
 
-        node->keys[index - 1] = sibling->keys.back();
-        sibling->keys.pop_back();
+        auto inner = AsInner(node);
+        size_t index = FindChild(node, key, rid);
+        T child_separator{};
+        RID child_separator_rid = 0;
+        bool child_on_right_edge = on_right_edge && index == inner->size;
+        Node* child_sibling = Insert(inner->children[index], key, rid, child_on_right_edge, child_separator, child_separator_rid);
+        if (!child_sibling) return nullptr;
+
+        std::copy_backward(inner->children + index + 1, inner->children + inner->size + 1, inner->children + inner->size + 2);
+        inner->children[index + 1] = child_sibling;
+        InsertAt(inner, index, std::move(child_separator), child_separator_rid);
+        if (inner->size <= max_keys) return nullptr;
+
+        // The new sibling keeps at least one key.
+        if (child_on_right_edge) middle = std::min(skewed, max_keys - 1);
+        // The middle key moves up; the keys after it and their children go to the new sibling.
+        auto sibling = new InnerNode();
+        separator = std::move(inner->keys[middle]);
+        separator_rid = inner->rids[middle];
+        std::move(inner->keys + middle + 1, inner->keys + inner->size, sibling->keys);
+        std::copy(inner->rids + middle + 1, inner->rids + inner->size, sibling->rids);
+        std::copy(inner->children + middle + 1, inner->children + inner->size + 1, sibling->children);
+        sibling->size = static_cast<uint16_t>(inner->size - middle - 1);
+        inner->size = static_cast<uint16_t>(middle);
+        return sibling;
     }
 
     template<typename T>
-    void BPlusTree<T>::BorrowFromNext(Node *node, int index) {
-        Node *child = node->children[index].get();
-        Node *sibling = node->children[index + 1].get();
-
-        child->keys.push_back(node->keys[index]);
-
-        if (!child->isLeaf) {
-            child->children.push_back(std::move(sibling->children[0]));
-            sibling->children.erase(sibling->children.begin());
+    bool BPlusTree<T>::Remove(const T &key, RID rid) {
+        if (!root) {
+            return false;
         }
-
-        node->keys[index] = sibling->keys[0];
-        sibling->keys.erase(sibling->keys.begin());
+        bool removed = Remove(root, key, rid);
+        if (root->size == 0) {
+            Node* old_root = root;
+            if (!root->isLeaf) {
+                root = AsInner(root)->children[0];
+                delete AsInner(old_root);
+            } else {
+                root = nullptr;
+                rightmost = nullptr;
+                delete AsLeaf(old_root);
+            }
+        }
+        return removed;
     }
 
     template<typename T>
-    void BPlusTree<T>::Merge(Node *node, int index) {
-        Node *child = node->children[index].get();
-        Node *sibling = node->children[index + 1].get();
-
-        child->keys.push_back(node->keys[index]);
+    bool BPlusTree<T>::Remove(Node *node, const T &key, RID rid) {
+        if (node->isLeaf) {
+            size_t index = FindEntry(node, key, rid);
+            if (index == node->size || node->keys[index] != key || node->rids[index] != rid) return false;
+            EraseAt(node, index);
+            return true;
+        }
 
-        child->keys.insert(child->keys.end(),
-                           sibling->keys.begin(),
-                           sibling->keys.end());
+        auto inner = AsInner(node);
+        size_t index = FindChild(node, key, rid);
+        if (!Remove(inner->children[index], key, rid)) return false;
+        if (inner->children[index]->size < min_keys) Fill(inner, index);
+        return true;
+    }
 
-        if (!child->isLeaf) {
-            child->children.insert(child->children.end(),
-                                   std::make_move_iterator(sibling->children.begin()),
-                                   std::make_move_iterator(sibling->children.end())
-            );
+    // Brings the child at index back to min_keys from a sibling, or merges it with one.
+    template<typename T>
+    void BPlusTree<T>::Fill(InnerNode *node, size_t index) {
+        if (index != 0 && node->children[index - 1]->size > min_keys) {
+            BorrowFromPrev(node, index);
+        } else if (index != node->size && node->children[index + 1]->size > min_keys) {
+            BorrowFromNext(node, index);
+        } else if (index != node->size) {
+            Merge(node, index);
         } else {
-            child->next = sibling->next;
+            Merge(node, index - 1);
         }
+    }
 
-        node->keys.erase(node->keys.begin() + index);
-        node->children.erase(node->children.begin() + index + 1);
+    template<typename T>
+    void BPlusTree<T>::BorrowFromPrev(InnerNode *node, size_t index) {
+        Node *child = node->children[index];
+        Node *sibling = node->children[index - 1];
+        size_t last = sibling->size - 1;
+
+        if (child->isLeaf) {
+            InsertAt(child, 0, std::move(sibling->keys[last]), sibling->rids[last]);
+            node->keys[index - 1] = child->keys[0];
+            node->rids[index - 1] = child->rids[0];
+        } else {
+            auto inner_child = AsInner(child);
+            std::copy_backward(inner_child->children, inner_child->children + child->size + 1, inner_child->children + child->size + 2);
+            inner_child->children[0] = AsInner(sibling)->children[sibling->size];
+            InsertAt(child, 0, std::move(node->keys[index - 1]), node->rids[index - 1]);
+            node->keys[index - 1] = std::move(sibling->keys[last]);
+            node->rids[index - 1] = sibling->rids[last];
+        }
+        --sibling->size;
     }
 
     template<typename T>
-    std::vector<T> BPlusTree<T>::RangeQuery(const T &lower, const T &upper) const {
-        std::vector<T> result;
-        RangeQuery(root.get(), lower, upper, result);
-        return result;
+    void BPlusTree<T>::BorrowFromNext(InnerNode *node, size_t index) {
+        Node *child = node->children[index];
+        Node *sibling = node->children[index + 1];
+
+        if (child->isLeaf) {
+            InsertAt(child, child->size, std::move(sibling->keys[0]), sibling->rids[0]);
+            node->keys[index] = sibling->keys[1];
+            node->rids[index] = sibling->rids[1];
+        } else {
+            auto inner_sibling = AsInner(sibling);
+            AsInner(child)->children[child->size + 1] = inner_sibling->children[0];
+            std::copy(inner_sibling->children + 1, inner_sibling->children + sibling->size + 1, inner_sibling->children);
+            InsertAt(child, child->size, std::move(node->keys[index]), node->rids[index]);
+            node->keys[index] = std::move(sibling->keys[0]);
+            node->rids[index] = sibling->rids[0];
+        }
+        EraseAt(sibling, 0);
     }
 
+    // Folds the child after index into the child at index and drops the separator between them.
     template<typename T>
-    void BPlusTree<T>::RangeQuery(const Node *node, T lower, T upper, std::vector<T> &result) const {
-        if (!node) {
-            return;
+    void BPlusTree<T>::Merge(InnerNode *node, size_t index) {
+        Node *child = node->children[index];
+        Node *sibling = node->children[index + 1];
+
+        if (child->isLeaf) {
+            AsLeaf(child)->next = AsLeaf(sibling)->next;
+            if (AsLeaf(child)->next) AsLeaf(child)->next->prev = AsLeaf(child);
+            if (rightmost == sibling) rightmost = AsLeaf(child);
+        } else {
+            std::copy(AsInner(sibling)->children, AsInner(sibling)->children + sibling->size + 1,
+                      AsInner(child)->children + child->size + 1);
+            InsertAt(child, child->size, std::move(node->keys[index]), node->rids[index]);
         }
+        std::move(sibling->keys, sibling->keys + sibling->size, child->keys + child->size);
+        std::copy(sibling->rids, sibling->rids + sibling->size, child->rids + child->size);
+        child->size = static_cast<uint16_t>(child->size + sibling->size);
+
+        std::copy(node->children + index + 2, node->children + node->size + 1, node->children + index + 1);
+        EraseAt(node, index);
+        if (sibling->isLeaf) delete AsLeaf(sibling);
+        else delete AsInner(sibling);
+    }
 
-        int i = 0;
-        while (i < node->keys.size() && node->keys[i] < lower) {
-            ++i;
+    template<typename T>
+    std::vector<RID> BPlusTree<T>::Search(const T &key) const {
+        return RangeQuery(key, key);
+    }
+
+    template<typename T>
+    std::vector<RID> BPlusTree<T>::RangeQuery(const T &lower, const T &upper) const {
+        std::vector<RID> result;
+        for (Cursor cursor = LowerBound(lower); cursor.Valid() && !(upper < cursor.Key()); cursor.Next()) {
+            result.push_back(cursor.GetRID());
         }
+        return result;
+    }
 
-        for (; i < node->keys.size() && node->keys[i] <= upper; ++i) {
-            if (node->isLeaf) {
-                result.push_back(node->keys[i]);
-            } else {
-                RangeQuery(node->children[i].get(), lower, upper, result);
-                result.push_back(node->keys[i]);
+    template<typename T>
+    void BPlusTree<T>::BulkLoad(const std::vector<std::pair<T, RID>> &entries) {
+        Free(root);
+        root = nullptr;
+        rightmost = nullptr;
+        if (entries.empty()) return;
+
+        // Leaves are cut evenly from the sorted entries; each level above is cut evenly from the
+        // nodes below, every child but a node's first contributing its smallest entry as separator.
+        size_t leaf_count = (entries.size() + max_keys - 1) / max_keys;
+
+        std::vector<Node*> nodes;
+        std::vector<std::pair<T, RID>> smallest;
+        LeafNode* previous = nullptr;
+        auto entry = entries.begin();
+        for (size_t i = 0; i < leaf_count; ++i) {
+            auto leaf = new LeafNode();
+            size_t count = entries.size() / leaf_count + (i < entries.size() % leaf_count ? 1 : 0);
+            smallest.push_back(*entry);
+            for (size_t j = 0; j < count; ++j, ++entry) {
+                leaf->keys[j] = entry->first;
+                leaf->rids[j] = entry->second;
             }
+            leaf->size = static_cast<uint16_t>(count);
+            leaf->prev = previous;
+            if (previous) previous->next = leaf;
+            previous = leaf;
+            nodes.push_back(leaf);
         }
-
-        if (!node->isLeaf) {
-            RangeQuery(node->children[i].get(), lower, upper, result);
+        rightmost = previous;
+
+        size_t max_children = max_keys + 1;
+        while (nodes.size() > 1) {
+            size_t parent_count = (nodes.size() + max_children - 1) / max_children;
+            std::vector<Node*> parents;
+            std::vector<std::pair<T, RID>> parent_smallest;
+            size_t child = 0;
+            for (size_t i = 0; i < parent_count; ++i) {
+                auto parent = new InnerNode();
+                size_t count = nodes.size() / parent_count + (i < nodes.size() % parent_count ? 1 : 0);
+                parent_smallest.push_back(std::move(smallest[child]));
+                for (size_t j = 0; j < count; ++j, ++child) {
+                    if (j > 0) {
+                        parent->keys[j - 1] = std::move(smallest[child].first);
+                        parent->rids[j - 1] = smallest[child].second;
+                    }
+                    parent->children[j] = nodes[child];
+                }
+                parent->size = static_cast<uint16_t>(count - 1);
+                parents.push_back(parent);
+            }
+            nodes = std::move(parents);
+            smallest = std::move(parent_smallest);
         }
+        root = nodes.front();
     }
 
     template class BPlusTree<int>;
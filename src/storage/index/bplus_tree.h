@@ -1,43 +1,131 @@
 #pragma once
 
+#include "tuple.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <utility>
 
 namespace storage {
+    /*
+     * B+tree of (key, RID) entries ordered by key, then RID, so duplicate keys are ordinary entries
+     * and every entry can be removed exactly. Entries live only in the leaves, which are chained
+     * both ways; internal nodes hold copies of the first entry of each child but the first. Cursors
+     * walk that chain, so range scans read entries one at a time and can stop anywhere.
+     *
+     * Nodes are page-sized and cache-line aligned, with keys, RIDs and child pointers in fixed
+     * arrays inside the node, so a node is one heap allocation and its keys are contiguous. Nodes are
+     * not buffer pool pages: a tree stays in memory in full, outside the pool's frame budget. Numeric keys
+     * are searched with a branchless binary search, and lookups prefetch the child they descend to.
+     *
+     * The rightmost leaf is cached: an entry past the last one is appended to it without a descent,
+     * and splits along the right edge keep ~90% in the left node, so ascending keys (ids, timestamps)
+     * load at close to append speed into nearly full leaves.
+     */
     template<typename T>
     class BPlusTree {
     public:
-        struct Node {
+        static constexpr size_t NODE_SIZE = 4096;
+        // Most keys a node holds. Kept odd so that split and merged nodes stay at least half full.
+        static constexpr size_t NODE_CAPACITY = ((NODE_SIZE - 64) / (sizeof(T) + sizeof(RID) + sizeof(void*)) - 1) | 1;
+
+        struct alignas(64) Node {
             bool isLeaf;
-            std::vector<T> keys;
-            std::vector<std::unique_ptr<Node>> children;
-            Node* next;
+            uint16_t size;
+            // One spare slot holds the overflowing entry until the node is split.
+            T keys[NODE_CAPACITY + 1];
+            // RID of each entry in a leaf, or of each separator in an internal node.
+            RID rids[NODE_CAPACITY + 1];
 
-            explicit Node(bool leaf = false) : isLeaf(leaf), next(nullptr) {}
+            explicit Node(bool leaf) : isLeaf(leaf), size(0) {}
         };
 
-        explicit BPlusTree(int degree);
-        ~BPlusTree() = default;
+        struct InnerNode : Node {
+            Node* children[NODE_CAPACITY + 2];
+
+            InnerNode() : Node(false), children() {}
+        };
+
+        struct LeafNode : Node {
+            LeafNode* prev;
+            LeafNode* next;
+
+            LeafNode() : Node(true), prev(nullptr), next(nullptr) {}
+        };
+
+        // Position of an entry in the leaf chain, or past either end. Inserts and removes invalidate it.
+        class Cursor {
+        public:
+            Cursor() : leaf_(nullptr), index_(0) {}
+
+            [[nodiscard]] bool Valid() const { return leaf_ != nullptr; }
+            [[nodiscard]] const T& Key() const { return leaf_->keys[index_]; }
+            [[nodiscard]] RID GetRID() const { return leaf_->rids[index_]; }
+            void Next();
+            void Prev();
+
+        private:
+            friend class BPlusTree;
 
-        void Insert(const T& key);
-        void Remove(const T& key);
-        bool Search(const T& key) const;
-        std::vector<T> RangeQuery(const T& lower, const T& upper) const;
+            // A position just past the end of a leaf is moved onto the start of the next one.
+            Cursor(const LeafNode* leaf, size_t index);
+
+            const LeafNode* leaf_;
+            size_t index_;
+        };
+
+        // Nodes hold at most 2 * degree - 1 keys, capped by NODE_CAPACITY; a degree of 0 fills them.
+        explicit BPlusTree(int degree = 0);
+        ~BPlusTree();
+
+        BPlusTree(const BPlusTree&) = delete;
+        BPlusTree& operator=(const BPlusTree&) = delete;
+
+        void Insert(const T& key, RID rid);
+        // Returns false when the entry is not in the tree.
+        bool Remove(const T& key, RID rid);
+        [[nodiscard]] Cursor Begin() const;
+        [[nodiscard]] Cursor Last() const;
+        // The first entry with a key not less than key.
+        [[nodiscard]] Cursor LowerBound(const T& key) const;
+        // The first entry with a key greater than key.
+        [[nodiscard]] Cursor UpperBound(const T& key) const;
+        [[nodiscard]] std::vector<RID> Search(const T& key) const;
+        [[nodiscard]] std::vector<RID> RangeQuery(const T& lower, const T& upper) const;
+        // Replaces the tree with one built bottom-up from entries in (key, RID) order, without splits.
+        void BulkLoad(const std::vector<std::pair<T, RID>>& entries);
     private:
-        std::unique_ptr<Node> root;
-        int t;
-        void SplitChild(Node* parent, int index, std::unique_ptr<Node>& child);
-        void InsertNonFull(Node* node, const T& key);
-        bool Search(const Node* node, const T& key) const;
-        void Remove(Node* node, const T& key);
-        void BorrowFromPrev(Node* node, int index);
-        void BorrowFromNext(Node* node, int index);
-        void Merge(Node* node, int index);
-        int FindKey(Node* node, const T& key) const;
-        void RemoveFromNonLeaf(Node* node, int index);
-        T GetPred(Node* node, int index) const;
-        T GetSucc(Node* node, int index) const;
-        void Fill(Node* node, int index);
-        void RangeQuery(const Node* node, T lower, T upper, std::vector<T>& result) const;
+        Node* root;
+        // Last leaf of the chain, the target of in-order appends.
+        LeafNode* rightmost;
+        size_t max_keys;
+        // Every node but the root holds at least this many keys.
+        size_t min_keys;
+
+        static InnerNode* AsInner(Node* node) { return static_cast<InnerNode*>(node); }
+        static const InnerNode* AsInner(const Node* node) { return static_cast<const InnerNode*>(node); }
+        static LeafNode* AsLeaf(Node* node) { return static_cast<LeafNode*>(node); }
+        static const LeafNode* AsLeaf(const Node* node) { return static_cast<const LeafNode*>(node); }
+        static void Free(Node* node);
+
+        // Position of the first key of the node not less than key, or greater than key when Upper.
+        template<bool Upper>
+        static size_t SearchNode(const Node* node, const T& key);
+        // Position of the first entry of the node not less than (key, rid).
+        static size_t FindEntry(const Node* node, const T& key, RID rid);
+        // Position of the child of an internal node that holds the entry, or would hold it.
+        static size_t FindChild(const Node* node, const T& key, RID rid);
+        // Descends by key alone: the entry sought is in the leaf reached, or starts the next one.
+        template<bool Upper>
+        [[nodiscard]] Cursor Seek(const T& key) const;
+
+        static void InsertAt(Node* node, size_t index, T key, RID rid);
+        static void EraseAt(Node* node, size_t index);
+        Node* Insert(Node* node, const T& key, RID rid, bool on_right_edge, T& separator, RID& separator_rid);
+        bool Remove(Node* node, const T& key, RID rid);
+        void Fill(InnerNode* node, size_t index);
+        void BorrowFromPrev(InnerNode* node, size_t index);
+        void BorrowFromNext(InnerNode* node, size_t index);
+        void Merge(InnerNode* node, size_t index);
     };
 }
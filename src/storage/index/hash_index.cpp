@@ -0,0 +1,130 @@
+#include "hash_index.h"
+#include <algorithm>
+#include <functional>
+
+namespace storage {
+    namespace {
+        constexpr size_t MIN_SLOTS = 16;
+    }
+
+    template<typename KeyType>
+    HashIndex<KeyType>::HashIndex() : slots_(MIN_SLOTS), key_count_(0) {}
+
+    template<typename KeyType>
+    uint64_t HashIndex<KeyType>::Hash(const KeyType &key) {
+        // std::hash of a number is often the number itself; mixing spreads clustered keys over the slots.
+        uint64_t hash = std::hash<KeyType>{}(key);
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash == 0 ? 1 : hash;
+    }
+
+    template<typename KeyType>
+    size_t HashIndex<KeyType>::Find(const KeyType &key, uint64_t hash) const {
+        size_t mask = slots_.size() - 1;
+        size_t position = hash & mask;
+        while (slots_[position].hash != 0 && (slots_[position].hash != hash || slots_[position].key != key)) {
+            position = (position + 1) & mask;
+        }
+        return position;
+    }
+
+    template<typename KeyType>
+    void HashIndex<KeyType>::Reserve(size_t key_count) {
+        // At most 3/4 of the slots are occupied, which keeps probe runs short.
+        size_t capacity = slots_.size();
+        while (key_count * 4 > capacity * 3) capacity *= 2;
+        if (capacity == slots_.size()) return;
+
+        std::vector<Slot> old_slots(capacity);
+        old_slots.swap(slots_);
+        for (auto& slot : old_slots) {
+            if (slot.hash == 0) continue;
+            slots_[Find(slot.key, slot.hash)] = std::move(slot);
+        }
+    }
+
+    template<typename KeyType>
+    void HashIndex<KeyType>::Insert(const KeyType &key, RID rid) {
+        uint64_t hash = Hash(key);
+        size_t position = Find(key, hash);
+        if (slots_[position].hash != 0) {
+            slots_[position].more_rids.push_back(rid);
+            return;
+        }
+        if ((key_count_ + 1) * 4 > slots_.size() * 3) {
+            Reserve(key_count_ + 1);
+            position = Find(key, hash);
+        }
+        Slot& slot = slots_[position];
+        slot.hash = hash;
+        slot.key = key;
+        slot.rid = rid;
+        ++key_count_;
+    }
+
+    template<typename KeyType>
+    void HashIndex<KeyType>::Remove(const KeyType &key, RID rid) {
+        size_t position = Find(key, Hash(key));
+        Slot& slot = slots_[position];
+        if (slot.hash == 0) return;
+
+        auto& more = slot.more_rids;
+        if (slot.rid == rid) {
+            if (more.empty()) {
+                EraseSlot(position);
+                return;
+            }
+            slot.rid = more.back();
+            more.pop_back();
+            return;
+        }
+        auto it = std::find(more.begin(), more.end(), rid);
+        if (it == more.end()) return;
+        *it = more.back();
+        more.pop_back();
+    }
+
+    template<typename KeyType>
+    void HashIndex<KeyType>::EraseSlot(size_t position) {
+        // Backward-shift deletion: a later slot of the run moves into the hole unless the hole lies
+        // before its home slot, in which case a lookup would no longer reach it.
+        size_t mask = slots_.size() - 1;
+        size_t hole = position;
+        for (size_t next = (hole + 1) & mask; slots_[next].hash != 0; next = (next + 1) & mask) {
+            size_t home = slots_[next].hash & mask;
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                slots_[hole] = std::move(slots_[next]);
+                hole = next;
+            }
+        }
+        slots_[hole] = Slot{};
+        --key_count_;
+    }
+
+    template<typename KeyType>
+    std::vector<RID> HashIndex<KeyType>::Search(const KeyType &key) const {
+        const Slot& slot = slots_[Find(key, Hash(key))];
+        if (slot.hash == 0) return {};
+        std::vector<RID> result;
+        result.reserve(1 + slot.more_rids.size());
+        result.push_back(slot.rid);
+        result.insert(result.end(), slot.more_rids.begin(), slot.more_rids.end());
+        return result;
+    }
+
+    template<typename KeyType>
+    void HashIndex<KeyType>::BulkLoad(const std::vector<std::pair<KeyType, RID>> &entries) {
+        slots_.assign(MIN_SLOTS, Slot{});
+        key_count_ = 0;
+        Reserve(entries.size());
+        for (const auto& [key, rid] : entries) Insert(key, rid);
+    }
+
+    template class HashIndex<int>;
+    template class HashIndex<std::string>;
+    template class HashIndex<double>;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "tuple.h"
+#include "index.h"
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+namespace storage {
+    /*
+     * Open-addressing hash index with linear probing, one slot per distinct key. A slot keeps the
+     * key's hash, the key and its first RID inline, so a lookup of a unique key reads one slot;
+     * further RIDs of a duplicate key go to a side vector. Removing a key's last RID shifts the
+     * rest of its probe run back instead of leaving a tombstone. Only equality lookups are served.
+     */
+    template<typename KeyType>
+    class HashIndex : public IndexBase {
+    public:
+        HashIndex();
+        ~HashIndex() override = default;
+
+        void Insert(const KeyType& key, RID rid);
+        void Remove(const KeyType& key, RID rid);
+        [[nodiscard]] std::vector<RID> Search(const KeyType& key) const;
+        // Replaces the contents with the entries, sized for them up front so the table never grows.
+        void BulkLoad(const std::vector<std::pair<KeyType, RID>>& entries);
+    private:
+        struct Slot {
+            // 0 marks an empty slot; hashes of keys are never 0.
+            uint64_t hash = 0;
+            KeyType key{};
+            RID rid = 0;
+            std::vector<RID> more_rids;
+        };
+
+        std::vector<Slot> slots_;
+        // Occupied slots, i.e. distinct keys.
+        size_t key_count_;
+
+        static uint64_t Hash(const KeyType& key);
+        // The slot holding key, or the empty slot ending its probe run.
+        [[nodiscard]] size_t Find(const KeyType& key, uint64_t hash) const;
+        void Reserve(size_t key_count);
+        void EraseSlot(size_t position);
+    };
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+namespace storage {
+    enum class IndexType : uint8_t {
+        // Ordered; serves equality and range predicates. See BPlusIndex.
+        BTREE,
+        // Unordered; serves equality predicates only. See HashIndex.
+        HASH
+    };
+
+    class IndexBase {
+    public:
+        virtual ~IndexBase() = default;
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "tuple.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace storage {
+    /*
+     * Keys of multi-column indexes are the columns' values encoded one after another so that
+     * comparing the encoded strings bytewise orders them like the tuples: INTEGER as 4 big-endian
+     * bytes with the sign bit flipped, DOUBLE as 8 big-endian bytes of its IEEE bits (all flipped
+     * when negative, the sign bit only otherwise), VARCHAR with 0x00 escaped as 0x00 0xFF and ended
+     * by 0x00 0x01. Every value is self-delimiting, so a key starts with the encoding of a prefix
+     * of its columns exactly when those columns are equal.
+     */
+    namespace index_key {
+        inline void AppendBigEndian(uint64_t bits, size_t bytes, std::string& out) {
+            for (size_t i = bytes; i-- > 0;) out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+        }
+
+        inline void Append(int value, std::string& out) {
+            AppendBigEndian(static_cast<uint32_t>(value) ^ 0x80000000u, sizeof(uint32_t), out);
+        }
+
+        inline void Append(double value, std::string& out) {
+            if (value == 0) value = 0.0;
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+            AppendBigEndian(bits, sizeof(uint64_t), out);
+        }
+
+        inline void Append(std::string_view value, std::string& out) {
+            for (char c : value) {
+                out.push_back(c);
+                if (c == '\0') out.push_back('\xFF');
+            }
+            out.push_back('\0');
+            out.push_back('\x01');
+        }
+
+        inline void Append(const std::string& value, std::string& out) {
+            Append(std::string_view(value), out);
+        }
+
+        inline void Append(const Field& field, std::string& out) {
+            std::visit([&out](const auto& value) { Append(value, out); }, field);
+        }
+
+        inline bool StartsWith(const std::string& key, const std::string& prefix) {
+            return key.compare(0, prefix.size(), prefix) == 0;
+        }
+
+        inline uint64_t ReadBigEndian(const std::string& key, size_t bytes, size_t& pos) {
+            if (pos + bytes > key.size()) throw std::runtime_error("Corrupted index key");
+            uint64_t bits = 0;
+            for (size_t i = 0; i < bytes; ++i) bits = (bits << 8) | static_cast<unsigned char>(key[pos++]);
+            return bits;
+        }
+
+        // Decodes the value of a column of type starting at pos of an encoded key and moves pos past it.
+        inline Field Read(DataType type, const std::string& key, size_t& pos) {
+            switch (type) {
+                case INTEGER:
+                    return static_cast<int>(static_cast<uint32_t>(ReadBigEndian(key, sizeof(uint32_t), pos)) ^ 0x80000000u);
+                case DOUBLE: {
+                    uint64_t bits = ReadBigEndian(key, sizeof(uint64_t), pos);
+                    bits = (bits & 0x8000000000000000ULL) ? bits & ~0x8000000000000000ULL : ~bits;
+                    double value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    return value;
+                }
+                case VARCHAR: {
+                    std::string value;
+                    while (pos + 1 < key.size() && !(key[pos] == '\0' && key[pos + 1] == '\x01')) {
+                        value.push_back(key[pos]);
+                        pos += key[pos] == '\0' ? 2 : 1;
+                    }
+                    if (pos + 1 >= key.size()) throw std::runtime_error("Corrupted index key");
+                    pos += 2;
+                    return value;
+                }
+            }
+            throw std::runtime_error("Unknown column type in index key");
+        }
+    }
+
+    // The entry key of a row in an index on columns: the field itself for one column, the encoded tuple otherwise.
+    inline Field MakeIndexKey(const std::vector<size_t>& columns, const std::vector<Field>& fields) {
+        if (columns.size() == 1) return fields[columns.front()];
+        std::string key;
+        for (size_t column : columns) index_key::Append(fields[column], key);
+        return key;
+    }
+}
@@ -0,0 +1,249 @@
+#include "log_manager.h"
+#include "crc32.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+
+namespace storage {
+    LogManager::LogManager(std::string log_dir, lsn_t next_lsn, LogManagerOptions options)
+            : log_dir_(std::move(log_dir)), options_(options), fd_(-1), segment_(0), segment_bytes_(0),
+              next_lsn_(next_lsn == INVALID_LSN ? 1 : next_lsn), buffered_lsn_(next_lsn_ - 1),
+              persistent_lsn_(next_lsn_ - 1), records_(0), flushes_(0),
+              flush_requested_(false), rotate_requested_(false), stop_(false), failed_(false) {
+        std::vector<uint32_t> segments = ListSegments(log_dir_);
+        struct stat st{};
+        if (!segments.empty() && stat(SegmentFileName(log_dir_, segments.back()).c_str(), &st) == 0 && st.st_size == 0) {
+            OpenSegment(segments.back());
+        } else {
+            OpenSegment(segments.empty() ? 1 : segments.back() + 1);
+        }
+        flush_thread_ = std::thread(&LogManager::FlushLoop, this);
+    }
+
+    void LogManager::OpenSegment(uint32_t segment) {
+        std::string file_name = SegmentFileName(log_dir_, segment);
+        int fd = open(file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "Failed to open log file " + file_name);
+
+        int dir_fd = open(log_dir_.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dir_fd >= 0) {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+        if (fd_ >= 0) close(fd_);
+        fd_ = fd;
+        segment_ = segment;
+    }
+
+    LogManager::~LogManager() {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            stop_ = true;
+        }
+        flush_cv_.notify_one();
+        flush_thread_.join();
+        close(fd_);
+    }
+
+    lsn_t LogManager::Append(LogRecord &record) {
+        std::lock_guard<std::mutex> lock(latch_);
+        record.lsn = next_lsn_++;
+
+        size_t frame_begin = buffer_.size();
+        buffer_.append(LogRecord::FRAME_HEADER_SIZE, '\0');
+        record.SerializeBody(buffer_);
+
+        auto body_size = static_cast<uint32_t>(buffer_.size() - frame_begin - LogRecord::FRAME_HEADER_SIZE);
+        uint32_t crc = common::Crc32(buffer_.data() + frame_begin + LogRecord::FRAME_HEADER_SIZE, body_size);
+        std::memcpy(buffer_.data() + frame_begin, &body_size, sizeof(body_size));
+        std::memcpy(buffer_.data() + frame_begin + sizeof(body_size), &crc, sizeof(crc));
+
+        buffered_lsn_ = record.lsn;
+        segment_bytes_ += buffer_.size() - frame_begin;
+        ++records_;
+        if (buffer_.size() >= options_.flush_threshold) flush_cv_.notify_one();
+        return record.lsn;
+    }
+
+    void LogManager::Commit(lsn_t lsn) {
+        if (options_.synchronous_commit) WaitForDurable(lsn);
+    }
+
+    void LogManager::WaitForDurable(lsn_t lsn) {
+        std::unique_lock<std::mutex> lock(latch_);
+        if (persistent_lsn_ >= lsn) return;
+        flush_requested_ = true;
+        flush_cv_.notify_one();
+        durable_cv_.wait(lock, [&] { return persistent_lsn_ >= lsn || failed_; });
+        if (failed_) throw std::runtime_error("Failed to write log file " + SegmentFileName(log_dir_, segment_));
+    }
+
+    void LogManager::Flush() {
+        WaitForDurable(GetLastLsn());
+    }
+
+    lsn_t LogManager::GetLastLsn() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        return next_lsn_ - 1;
+    }
+
+    LogStats LogManager::GetStats() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        return {next_lsn_ - 1, persistent_lsn_, records_, flushes_, segment_, segment_bytes_};
+    }
+
+    uint32_t LogManager::Rotate() {
+        std::unique_lock<std::mutex> lock(latch_);
+        uint32_t old_segment = segment_;
+        rotate_requested_ = true;
+        flush_requested_ = true;
+        flush_cv_.notify_one();
+        durable_cv_.wait(lock, [&] { return segment_ != old_segment || failed_; });
+        if (failed_) throw std::runtime_error("Failed to rotate log file " + SegmentFileName(log_dir_, old_segment));
+        return segment_;
+    }
+
+    void LogManager::RemoveSegmentsBefore(uint32_t segment) {
+        for (uint32_t old_segment : ListSegments(log_dir_)) {
+            if (old_segment >= segment) break;
+            std::string file_name = SegmentFileName(log_dir_, old_segment);
+            if (unlink(file_name.c_str()) != 0 && errno != ENOENT) {
+                throw std::system_error(errno, std::generic_category(), "Failed to remove log file " + file_name);
+            }
+        }
+    }
+
+    std::vector<uint32_t> LogManager::ListSegments(const std::string &log_dir) {
+        std::vector<uint32_t> segments;
+        DIR* dir = opendir(log_dir.c_str());
+        if (!dir) {
+            if (errno == ENOENT) return segments;
+            throw std::system_error(errno, std::generic_category(), "Failed to list log directory " + log_dir);
+        }
+        while (dirent* entry = readdir(dir)) {
+            unsigned int segment;
+            char suffix[5] = {};
+            if (std::sscanf(entry->d_name, "wal_%u.%4s", &segment, suffix) == 2 && std::string(suffix) == "log") {
+                segments.push_back(segment);
+            }
+        }
+        closedir(dir);
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    std::string LogManager::SegmentFileName(const std::string &log_dir, uint32_t segment) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "wal_%06u.log", segment);
+        return log_dir + "/" + name;
+    }
+
+    void LogManager::FlushLoop() {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (true) {
+            flush_cv_.wait_for(lock, options_.flush_interval, [&] {
+                return stop_ || flush_requested_ || buffer_.size() >= options_.flush_threshold;
+            });
+            bool rotate = rotate_requested_;
+            if (buffer_.empty() && !rotate) {
+                flush_requested_ = false;
+                if (stop_) break;
+                continue;
+            }
+
+            std::string batch;
+            batch.swap(buffer_);
+            lsn_t batch_lsn = buffered_lsn_;
+            flush_requested_ = false;
+            rotate_requested_ = false;
+            // Records appended from here on belong to the next segment.
+            if (rotate) segment_bytes_ = 0;
+            lock.unlock();
+
+            bool ok = true;
+            size_t done = 0;
+            while (ok && done < batch.size()) {
+                ssize_t n = write(fd_, batch.data() + done, batch.size() - done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) ok = false;
+                else done += static_cast<size_t>(n);
+            }
+            if (ok && !batch.empty() && fdatasync(fd_) != 0) ok = false;
+
+            uint32_t next_segment = segment_ + 1;
+            int new_fd = -1;
+            if (ok && rotate) {
+                std::string file_name = SegmentFileName(log_dir_, next_segment);
+                new_fd = open(file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+                if (new_fd < 0) ok = false;
+            }
+
+            lock.lock();
+            if (ok) {
+                persistent_lsn_ = batch_lsn;
+                if (!batch.empty()) ++flushes_;
+                if (rotate) {
+                    close(fd_);
+                    fd_ = new_fd;
+                    segment_ = next_segment;
+                }
+            } else {
+                failed_ = true;
+            }
+            durable_cv_.notify_all();
+        }
+    }
+
+    lsn_t LogManager::ReadLog(const std::string &file_name, const std::function<void(const LogRecord &)> &consumer) {
+        int fd = open(file_name.c_str(), O_RDWR);
+        if (fd < 0) {
+            if (errno == ENOENT) return INVALID_LSN;
+            throw std::system_error(errno, std::generic_category(), "Failed to open log file " + file_name);
+        }
+
+        std::string data;
+        {
+            std::vector<char> chunk(1 << 20);
+            ssize_t n;
+            while ((n = read(fd, chunk.data(), chunk.size())) != 0) {
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    close(fd);
+                    throw std::system_error(errno, std::generic_category(), "Failed to read log file " + file_name);
+                }
+                data.append(chunk.data(), static_cast<size_t>(n));
+            }
+        }
+
+        lsn_t last_lsn = INVALID_LSN;
+        size_t pos = 0;
+        while (pos + LogRecord::FRAME_HEADER_SIZE <= data.size()) {
+            uint32_t body_size;
+            uint32_t crc;
+            std::memcpy(&body_size, data.data() + pos, sizeof(body_size));
+            std::memcpy(&crc, data.data() + pos + sizeof(body_size), sizeof(crc));
+            size_t body_begin = pos + LogRecord::FRAME_HEADER_SIZE;
+            if (body_begin + body_size > data.size()) break;
+            if (common::Crc32(data.data() + body_begin, body_size) != crc) break;
+
+            LogRecord record = LogRecord::DeserializeBody(data.data() + body_begin, body_size);
+            if (record.lsn <= last_lsn) break;
+            consumer(record);
+            last_lsn = record.lsn;
+            pos = body_begin + body_size;
+        }
+
+        if (pos < data.size() && ftruncate(fd, static_cast<off_t>(pos)) != 0) {
+            close(fd);
+            throw std::system_error(errno, std::generic_category(), "Failed to truncate log file " + file_name);
+        }
+        close(fd);
+        return last_lsn;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "log_record.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace storage {
+    struct LogManagerOptions {
+        // When false, Commit returns immediately and at most flush_interval worth of commits can be lost.
+        bool synchronous_commit = false;
+        std::chrono::milliseconds flush_interval{10};
+        size_t flush_threshold = 1 << 20;
+    };
+
+    struct LogStats {
+        lsn_t last_lsn;
+        lsn_t persistent_lsn;
+        size_t records;
+        size_t flushes;
+        uint32_t segment;
+        uint64_t segment_bytes;
+    };
+
+    /*
+     * Records are appended to an in-memory buffer. A background thread writes the
+     * whole buffer and fsyncs it once per flush, so every commit waiting at that
+     * moment is made durable by the same fsync (group commit).
+     * The log is a sequence of segment files wal_NNNNNN.log in one directory; a
+     * checkpoint rotates to a new segment and drops the ones it has made redundant.
+     */
+    class LogManager {
+    public:
+        // Starts a fresh segment after the highest one already in log_dir.
+        LogManager(std::string log_dir, lsn_t next_lsn, LogManagerOptions options = {});
+        ~LogManager();
+
+        LogManager(const LogManager&) = delete;
+        LogManager& operator=(const LogManager&) = delete;
+
+        lsn_t Append(LogRecord& record);
+        void Commit(lsn_t lsn);
+        void WaitForDurable(lsn_t lsn);
+        void Flush();
+        // Makes everything appended so far durable in the current segment, switches to a new one and returns its number.
+        uint32_t Rotate();
+        void RemoveSegmentsBefore(uint32_t segment);
+
+        [[nodiscard]] lsn_t GetLastLsn() const;
+        [[nodiscard]] LogStats GetStats() const;
+
+        // Replays every intact record in order, truncates a torn tail and returns the last LSN seen.
+        static lsn_t ReadLog(const std::string& file_name, const std::function<void(const LogRecord&)>& consumer);
+        [[nodiscard]] static std::vector<uint32_t> ListSegments(const std::string& log_dir);
+        [[nodiscard]] static std::string SegmentFileName(const std::string& log_dir, uint32_t segment);
+
+    private:
+        std::string log_dir_;
+        LogManagerOptions options_;
+        int fd_;
+        uint32_t segment_;
+        uint64_t segment_bytes_;
+        std::string buffer_;
+        lsn_t next_lsn_;
+        lsn_t buffered_lsn_;
+        lsn_t persistent_lsn_;
+        size_t records_;
+        size_t flushes_;
+        bool flush_requested_;
+        bool rotate_requested_;
+        bool stop_;
+        bool failed_;
+        mutable std::mutex latch_;
+        std::condition_variable flush_cv_;
+        std::condition_variable durable_cv_;
+        std::thread flush_thread_;
+
+        void FlushLoop();
+        void OpenSegment(uint32_t segment);
+    };
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "schema.h"
+#include "tuple.h"
+#include "index.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace storage {
+    using lsn_t = uint64_t;
+    static constexpr lsn_t INVALID_LSN = 0;
+
+    enum class LogRecordType : uint8_t {
+        INSERT = 1,
+        UPDATE,
+        DELETE,
+        CREATE_TABLE,
+        DROP_TABLE,
+        CREATE_INDEX,
+        ADD_PARTITION,
+        DROP_PARTITION
+    };
+
+    /*
+     * On disk a record is framed as | size | crc | body | where size and crc cover
+     * the body only. Tuple payloads use the TupleSerializer wire format.
+     */
+    struct LogRecord {
+        lsn_t lsn = INVALID_LSN;
+        LogRecordType type = LogRecordType::INSERT;
+        std::string table_name;
+        RID rid = 0;
+        // The tuple for INSERT and UPDATE; the serialized PartitionScheme of a partitioned table for
+        // CREATE_TABLE, and the added partition's bound for ADD_PARTITION.
+        std::string payload;
+        Schema schema;
+        std::string index_name;
+        // Key columns of CREATE_INDEX in key order.
+        std::vector<size_t> column_indexes;
+        // Columns CREATE_INDEX stores in the entries after the key.
+        std::vector<size_t> include_column_indexes;
+        int degree = 0;
+        IndexType index_type = IndexType::BTREE;
+        // A TableStorage value for CREATE_TABLE.
+        uint8_t storage = 0;
+        std::string partition_name;
+
+        static constexpr size_t FRAME_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+        void SerializeBody(std::string& out) const {
+            Append(out, lsn);
+            Append(out, static_cast<uint8_t>(type));
+            AppendString(out, table_name);
+            switch (type) {
+                case LogRecordType::INSERT:
+                case LogRecordType::UPDATE:
+                    Append(out, rid);
+                    Append(out, static_cast<uint32_t>(payload.size()));
+                    out.append(payload);
+                    break;
+                case LogRecordType::DELETE:
+                    Append(out, rid);
+                    break;
+                case LogRecordType::CREATE_TABLE:
+                    Append(out, static_cast<uint16_t>(schema.GetColumnCount()));
+                    for (const auto& column : schema.GetColumns()) {
+                        Append(out, static_cast<uint8_t>(column.type));
+                        AppendString(out, column.name);
+                    }
+                    Append(out, storage);
+                    Append(out, static_cast<uint32_t>(payload.size()));
+                    out.append(payload);
+                    break;
+                case LogRecordType::DROP_TABLE:
+                    break;
+                case LogRecordType::ADD_PARTITION:
+                    AppendString(out, partition_name);
+                    AppendString(out, payload);
+                    break;
+                case LogRecordType::DROP_PARTITION:
+                    AppendString(out, partition_name);
+                    break;
+                case LogRecordType::CREATE_INDEX:
+                    AppendString(out, index_name);
+                    Append(out, static_cast<uint32_t>(column_indexes.front()));
+                    Append(out, static_cast<int32_t>(degree));
+                    Append(out, static_cast<uint8_t>(index_type));
+                    Append(out, static_cast<uint16_t>(column_indexes.size() - 1));
+                    for (size_t i = 1; i < column_indexes.size(); ++i) Append(out, static_cast<uint32_t>(column_indexes[i]));
+                    Append(out, static_cast<uint16_t>(include_column_indexes.size()));
+                    for (size_t column : include_column_indexes) Append(out, static_cast<uint32_t>(column));
+                    break;
+            }
+        }
+
+        static LogRecord DeserializeBody(const char* data, size_t size) {
+            Reader reader{data, data + size};
+            LogRecord record;
+            record.lsn = reader.Read<lsn_t>();
+            record.type = static_cast<LogRecordType>(reader.Read<uint8_t>());
+            record.table_name = reader.ReadString();
+            switch (record.type) {
+                case LogRecordType::INSERT:
+                case LogRecordType::UPDATE: {
+                    record.rid = reader.Read<RID>();
+                    auto length = reader.Read<uint32_t>();
+                    record.payload = reader.ReadBytes(length);
+                    break;
+                }
+                case LogRecordType::DELETE:
+                    record.rid = reader.Read<RID>();
+                    break;
+                case LogRecordType::CREATE_TABLE: {
+                    auto column_count = reader.Read<uint16_t>();
+                    for (uint16_t i = 0; i < column_count; ++i) {
+                        auto column_type = static_cast<DataType>(reader.Read<uint8_t>());
+                        record.schema.InsertColumn(reader.ReadString(), column_type);
+                    }
+                    record.storage = reader.Read<uint8_t>();
+                    // Records written before tables could be partitioned end here.
+                    if (reader.pos != reader.end) record.payload = reader.ReadBytes(reader.Read<uint32_t>());
+                    break;
+                }
+                case LogRecordType::DROP_TABLE:
+                    break;
+                case LogRecordType::ADD_PARTITION:
+                    record.partition_name = reader.ReadString();
+                    record.payload = reader.ReadString();
+                    break;
+                case LogRecordType::DROP_PARTITION:
+                    record.partition_name = reader.ReadString();
+                    break;
+                case LogRecordType::CREATE_INDEX:
+                    record.index_name = reader.ReadString();
+                    record.column_indexes.push_back(reader.Read<uint32_t>());
+                    record.degree = reader.Read<int32_t>();
+                    // Records written before hash indexes end here, those written before multi-column
+                    // indexes after the index type, and those written before included columns after the key columns.
+                    if (reader.pos != reader.end) record.index_type = static_cast<IndexType>(reader.Read<uint8_t>());
+                    if (reader.pos != reader.end) {
+                        auto more_columns = reader.Read<uint16_t>();
+                        for (uint16_t i = 0; i < more_columns; ++i) record.column_indexes.push_back(reader.Read<uint32_t>());
+                    }
+                    if (reader.pos != reader.end) {
+                        auto include_count = reader.Read<uint16_t>();
+                        for (uint16_t i = 0; i < include_count; ++i) record.include_column_indexes.push_back(reader.Read<uint32_t>());
+                    }
+                    break;
+                default:
+                    throw std::runtime_error("Unknown log record type");
+            }
+            return record;
+        }
+
+    private:
+        struct Reader {
+            const char* pos;
+            const char* end;
+
+            template<typename T>
+            T Read() {
+                T value;
+                if (pos + sizeof(T) > end) throw std::runtime_error("Corrupted log record");
+                std::memcpy(&value, pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
+
+            std::string ReadBytes(size_t length) {
+                if (pos + length > end) throw std::runtime_error("Corrupted log record");
+                std::string value(pos, length);
+                pos += length;
+                return value;
+            }
+
+            std::string ReadString() {
+                return ReadBytes(Read<uint16_t>());
+            }
+        };
+
+        template<typename T>
+        static void Append(std::string& out, const T& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static void AppendString(std::string& out, const std::string& value) {
+            Append(out, static_cast<uint16_t>(value.size()));
+            out.append(value);
+        }
+    };
+}
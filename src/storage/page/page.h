@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace storage {
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    using PageId = int32_t;
+    static constexpr PageId INVALID_PAGE_ID = -1;
+
+    class Page {
+        friend class BufferPoolManager;
+    public:
+        Page() { Reset(); }
+
+        char* GetData() { return data_; }
+        const char* GetData() const { return data_; }
+
+        [[nodiscard]] PageId GetPageId() const { return page_id_; }
+        [[nodiscard]] int GetPinCount() const { return pin_count_; }
+        [[nodiscard]] bool IsDirty() const { return is_dirty_; }
+
+        void Reset() { std::memset(data_, 0, PAGE_SIZE); }
+
+    private:
+        char data_[PAGE_SIZE];
+        PageId page_id_ = INVALID_PAGE_ID;
+        int pin_count_ = 0;
+        bool is_dirty_ = false;
+    };
+}
@@ -0,0 +1,149 @@
+#include "table_page.h"
+#include <algorithm>
+#include <vector>
+
+namespace storage {
+    void TablePage::Init() {
+        std::memset(data_, 0, PAGE_SIZE);
+        GetHeader()->free_space_end = static_cast<uint16_t>(PAGE_SIZE);
+    }
+
+    SlotId TablePage::GetSlotCount() const {
+        return GetHeader()->slot_count;
+    }
+
+    uint16_t TablePage::GetTupleCount() const {
+        return GetHeader()->tuple_count;
+    }
+
+    size_t TablePage::GetFreeSpace() const {
+        return GetHeader()->free_space_end - GetFreeSpaceBegin();
+    }
+
+    size_t TablePage::GetUsableSpace() const {
+        size_t space = GetFreeSpace() + GetHeader()->garbage_bytes;
+        size_t slot_size = HasTombstone() ? 0 : sizeof(Slot);
+        return space > slot_size ? space - slot_size : 0;
+    }
+
+    bool TablePage::IsLive(SlotId slot) const {
+        return slot < GetHeader()->slot_count && GetSlots()[slot].size != 0;
+    }
+
+    bool TablePage::InsertTuple(const char *tuple_data, uint16_t size, SlotId &slot) {
+        if (size == 0 || GetUsableSpace() < size) return false;
+
+        Header* header = GetHeader();
+        bool reuse_slot = HasTombstone();
+        if (GetFreeSpace() < size + (reuse_slot ? 0 : sizeof(Slot))) Compact();
+
+        header->free_space_end -= size;
+        std::memcpy(data_ + header->free_space_end, tuple_data, size);
+
+        Slot* slots = GetSlots();
+        if (reuse_slot) {
+            slot = 0;
+            while (slots[slot].size != 0) ++slot;
+        } else {
+            slot = header->slot_count++;
+        }
+        slots[slot] = {header->free_space_end, size};
+        ++header->tuple_count;
+        return true;
+    }
+
+    bool TablePage::InsertTupleAt(SlotId slot, const char *tuple_data, uint16_t size) {
+        Header* header = GetHeader();
+        if (size == 0 || IsLive(slot)) return false;
+
+        size_t new_slots = slot >= header->slot_count ? slot + 1 - header->slot_count : 0;
+        size_t needed = size + new_slots * sizeof(Slot);
+        if (GetFreeSpace() < needed) {
+            Compact();
+            if (GetFreeSpace() < needed) return false;
+        }
+
+        Slot* slots = GetSlots();
+        for (size_t i = header->slot_count; i <= slot && new_slots > 0; ++i) slots[i] = {0, 0};
+        if (new_slots > 0) header->slot_count = slot + 1;
+
+        header->free_space_end -= size;
+        std::memcpy(data_ + header->free_space_end, tuple_data, size);
+        slots[slot] = {header->free_space_end, size};
+        ++header->tuple_count;
+        return true;
+    }
+
+    bool TablePage::GetTuple(SlotId slot, const char *&tuple_data, uint16_t &size) const {
+        if (!IsLive(slot)) return false;
+        const Slot& s = GetSlots()[slot];
+        tuple_data = data_ + s.offset;
+        size = s.size;
+        return true;
+    }
+
+    bool TablePage::RemoveTuple(SlotId slot) {
+        if (!IsLive(slot)) return false;
+        GetHeader()->garbage_bytes += GetSlots()[slot].size;
+        GetSlots()[slot] = {0, 0};
+        --GetHeader()->tuple_count;
+        return true;
+    }
+
+    bool TablePage::UpdateTuple(SlotId slot, const char *tuple_data, uint16_t size) {
+        if (!IsLive(slot) || size == 0) return false;
+        Slot& s = GetSlots()[slot];
+
+        Header* header = GetHeader();
+        if (size <= s.size) {
+            std::memcpy(data_ + s.offset, tuple_data, size);
+            header->garbage_bytes += s.size - size;
+            s.size = size;
+            return true;
+        }
+
+        if (GetFreeSpace() < size) {
+            if (GetFreeSpace() + header->garbage_bytes + s.size < size) return false;
+            s = {0, 0};
+            Compact();
+        } else {
+            header->garbage_bytes += s.size;
+        }
+
+        header->free_space_end -= size;
+        std::memcpy(data_ + header->free_space_end, tuple_data, size);
+        s = {header->free_space_end, size};
+        return true;
+    }
+
+    void TablePage::Compact() {
+        Header* header = GetHeader();
+        Slot* slots = GetSlots();
+
+        std::vector<SlotId> live;
+        live.reserve(header->slot_count);
+        for (SlotId i = 0; i < header->slot_count; ++i) {
+            if (slots[i].size != 0) live.push_back(i);
+        }
+        std::sort(live.begin(), live.end(), [slots](SlotId a, SlotId b) {
+            return slots[a].offset > slots[b].offset;
+        });
+
+        uint16_t end = static_cast<uint16_t>(PAGE_SIZE);
+        for (SlotId i : live) {
+            end -= slots[i].size;
+            std::memmove(data_ + end, data_ + slots[i].offset, slots[i].size);
+            slots[i].offset = end;
+        }
+        header->free_space_end = end;
+        header->garbage_bytes = 0;
+    }
+
+    size_t TablePage::Vacuum() {
+        Header* header = GetHeader();
+        size_t free_before = GetFreeSpace();
+        Compact();
+        while (header->slot_count > 0 && GetSlots()[header->slot_count - 1].size == 0) --header->slot_count;
+        return GetFreeSpace() - free_before;
+    }
+}
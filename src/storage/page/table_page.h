@@ -0,0 +1,66 @@
+#pragma once
+
+#include "page.h"
+#include <cstdint>
+
+namespace storage {
+    using SlotId = uint16_t;
+
+    /*
+     * Slotted page layout:
+     *  | header | slot[0] slot[1] ... -> free space <- ... tuple[1] tuple[0] |
+     * Slots grow from the front, tuple data grows from the back of the page.
+     * A slot with size 0 is a tombstone of a removed tuple; inserts reuse it.
+     * Bytes of removed and shrunk tuples are counted as garbage until Compact() squeezes them out.
+     */
+    class TablePage {
+    public:
+        explicit TablePage(char* data) : data_(data) {}
+
+        void Init();
+
+        [[nodiscard]] SlotId GetSlotCount() const;
+        [[nodiscard]] uint16_t GetTupleCount() const;
+        [[nodiscard]] size_t GetFreeSpace() const;
+        // Size of the largest tuple InsertTuple can still place, compacting the page if it has to.
+        [[nodiscard]] size_t GetUsableSpace() const;
+        [[nodiscard]] bool IsLive(SlotId slot) const;
+
+        bool InsertTuple(const char* tuple_data, uint16_t size, SlotId& slot);
+        // Places a tuple at a given slot, growing the slot directory if needed. Used to restore RIDs.
+        bool InsertTupleAt(SlotId slot, const char* tuple_data, uint16_t size);
+        bool GetTuple(SlotId slot, const char*& tuple_data, uint16_t& size) const;
+        bool RemoveTuple(SlotId slot);
+        bool UpdateTuple(SlotId slot, const char* tuple_data, uint16_t size);
+        void Compact();
+        // Compacts the page and drops the tombstones at the end of the slot directory.
+        // Returns the number of bytes that became free.
+        size_t Vacuum();
+
+        static constexpr size_t MaxTupleSize();
+
+    private:
+        struct Header {
+            uint16_t slot_count;
+            uint16_t tuple_count;
+            uint16_t free_space_end;
+            uint16_t garbage_bytes;
+        };
+
+        struct Slot {
+            uint16_t offset;
+            uint16_t size;
+        };
+
+        char* data_;
+
+        Header* GetHeader() const { return reinterpret_cast<Header*>(data_); }
+        Slot* GetSlots() const { return reinterpret_cast<Slot*>(data_ + sizeof(Header)); }
+        [[nodiscard]] size_t GetFreeSpaceBegin() const { return sizeof(Header) + GetHeader()->slot_count * sizeof(Slot); }
+        [[nodiscard]] bool HasTombstone() const { return GetHeader()->tuple_count < GetHeader()->slot_count; }
+    };
+
+    constexpr size_t TablePage::MaxTupleSize() {
+        return PAGE_SIZE - sizeof(Header) - sizeof(Slot);
+    }
+}
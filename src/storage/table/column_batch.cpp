@@ -0,0 +1,156 @@
+#include "column_batch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <regex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace storage {
+    namespace {
+        template<typename Matches>
+        void KeepMatching(std::vector<uint32_t>& rows, Matches matches) {
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint32_t row) { return !matches(row); }), rows.end());
+        }
+    }
+
+    uint32_t StringDictionary::Encode(std::string_view value) {
+        if (auto it = codes.find(value); it != codes.end()) return it->second;
+        if (values.size() == std::numeric_limits<uint32_t>::max()) throw std::runtime_error("Dictionary is full");
+        if (!arena) arena = std::make_shared<common::Arena>();
+        std::string_view stored = arena->CopyString(value);
+        codes.emplace(stored, static_cast<uint32_t>(values.size()));
+        values.push_back(stored);
+        return values.size() - 1;
+    }
+
+    std::optional<uint32_t> StringDictionary::Find(std::string_view value) const {
+        auto it = codes.find(value);
+        if (it == codes.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void ColumnBatch::Retain(const std::vector<uint32_t> &rows) {
+        if (rows.size() == rids.size()) return;
+        auto compact = [&rows](auto& values) {
+            for (size_t i = 0; i < rows.size(); ++i) values[i] = values[rows[i]];
+            values.resize(rows.size());
+        };
+        compact(rids);
+        for (auto& column : columns) {
+            std::visit([&](auto& values) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) compact(values.codes);
+                else compact(values);
+            }, column);
+        }
+    }
+
+    void ColumnZone::Add(const Field &value) {
+        // NaN matches no predicate, so it never has to widen a zone.
+        if (auto number = std::get_if<double>(&value); number && std::isnan(*number)) return;
+        if (!min || value < *min) min = value;
+        if (!max || *max < value) max = value;
+    }
+
+    void ZoneMap::Add(const std::vector<Field> &fields) {
+        if (columns.size() < fields.size()) columns.resize(fields.size());
+        for (size_t i = 0; i < fields.size(); ++i) columns[i].Add(fields[i]);
+    }
+
+    void ZoneMap::Add(const ZoneMap &other) {
+        if (columns.size() < other.columns.size()) columns.resize(other.columns.size());
+        for (size_t i = 0; i < other.columns.size(); ++i) {
+            if (other.columns[i].min) columns[i].Add(*other.columns[i].min);
+            if (other.columns[i].max) columns[i].Add(*other.columns[i].max);
+        }
+    }
+
+    ColumnPredicate ColumnPredicate::Parse(const std::string &predicate, size_t column_index) {
+        std::regex pattern(R"(^([^<>=\s]+)\s*(<=|>=|<|>|=)\s*(\S+)$)");
+        std::smatch matches;
+        if (!std::regex_match(predicate, matches, pattern)) {
+            throw std::invalid_argument("Invalid predicate format: " + predicate);
+        }
+        ColumnPredicate result{column_index, matches[2].str(), {}};
+        std::string value_str = matches[3].str();
+
+        if (value_str.size() >= 2 && value_str.front() == '\'' && value_str.back() == '\'') {
+            result.value = value_str.substr(1, value_str.size() - 2);
+        } else if (std::regex_match(value_str, std::regex(R"(\d+\.\d+)"))) {
+            result.value = std::stod(value_str);
+        } else if (std::regex_match(value_str, std::regex(R"(\d+)"))) {
+            result.value = std::stoi(value_str);
+        } else {
+            result.value = value_str;
+        }
+        return result;
+    }
+
+    bool ColumnPredicate::Matches(const Field &field) const {
+        return std::visit([&](auto &&field_value) -> bool {
+            using FieldType = std::decay_t<decltype(field_value)>;
+            if (auto literal = std::get_if<FieldType>(&value)) {
+                if (op == "=") return field_value == *literal;
+                if constexpr (std::is_arithmetic_v<FieldType>) {
+                    if (op == "<") return field_value < *literal;
+                    if (op == ">") return field_value > *literal;
+                    if (op == "<=") return field_value <= *literal;
+                    if (op == ">=") return field_value >= *literal;
+                }
+            }
+            return false;
+        }, field);
+    }
+
+    bool ColumnPredicate::MayMatch(const ColumnZone &zone) const {
+        if (!zone.min) return false;
+        return std::visit([&](const auto &min) -> bool {
+            using ValueType = std::decay_t<decltype(min)>;
+            auto literal = std::get_if<ValueType>(&value);
+            if (!literal) return false;
+            const auto &max = std::get<ValueType>(*zone.max);
+            if (op == "=") return !(*literal < min) && !(max < *literal);
+            if constexpr (std::is_arithmetic_v<ValueType>) {
+                if (op == "<") return min < *literal;
+                if (op == ">") return max > *literal;
+                if (op == "<=") return min <= *literal;
+                if (op == ">=") return max >= *literal;
+            }
+            return false;
+        }, *zone.min);
+    }
+
+    void ColumnPredicate::Select(const ColumnVector &values, std::vector<uint32_t> &rows) const {
+        std::visit([&](const auto &column) {
+            using VectorType = std::decay_t<decltype(column)>;
+            using ValueType = typename VectorType::value_type;
+            auto literal = std::get_if<ValueType>(&value);
+            if constexpr (std::is_same_v<VectorType, DictionaryVector>) {
+                SelectCodes(column.codes, *column.dictionary, rows);
+            } else if (!literal) {
+                rows.clear();
+            } else if (op == "=") {
+                KeepMatching(rows, [&](uint32_t row) { return column[row] == *literal; });
+            } else if constexpr (std::is_arithmetic_v<ValueType>) {
+                if (op == "<") KeepMatching(rows, [&](uint32_t row) { return column[row] < *literal; });
+                else if (op == ">") KeepMatching(rows, [&](uint32_t row) { return column[row] > *literal; });
+                else if (op == "<=") KeepMatching(rows, [&](uint32_t row) { return column[row] <= *literal; });
+                else if (op == ">=") KeepMatching(rows, [&](uint32_t row) { return column[row] >= *literal; });
+                else rows.clear();
+            } else {
+                rows.clear();
+            }
+        }, values);
+    }
+
+    void ColumnPredicate::SelectCodes(const std::vector<uint32_t> &codes, const StringDictionary &dictionary,
+                                      std::vector<uint32_t> &rows) const {
+        auto literal = std::get_if<std::string>(&value);
+        auto code = literal && op == "=" ? dictionary.Find(*literal) : std::nullopt;
+        if (!code) {
+            rows.clear();
+            return;
+        }
+        KeepMatching(rows, [&](uint32_t row) { return codes[row] == *code; });
+    }
+}
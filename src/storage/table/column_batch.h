@@ -0,0 +1,85 @@
+#pragma once
+
+#include "arena.h"
+#include "tuple.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace storage {
+    // Distinct strings of a dictionary-encoded column; a string's code is its position in values.
+    // Codes are only ever appended, so a code stays valid for the lifetime of the table.
+    // The strings themselves live in an arena shared with every copy of the dictionary.
+    struct StringDictionary {
+        std::shared_ptr<common::Arena> arena;
+        std::vector<std::string_view> values;
+        std::unordered_map<std::string_view, uint32_t> codes;
+
+        uint32_t Encode(std::string_view value);
+        [[nodiscard]] std::optional<uint32_t> Find(std::string_view value) const;
+    };
+
+    // A VARCHAR column held as 32-bit codes; indexing it decodes a single value.
+    struct DictionaryVector {
+        using value_type = std::string;
+
+        std::vector<uint32_t> codes;
+        std::shared_ptr<const StringDictionary> dictionary;
+
+        std::string operator[](size_t row) const { return std::string(dictionary->values[codes[row]]); }
+        [[nodiscard]] size_t size() const { return codes.size(); }
+    };
+
+    using ColumnVector = std::variant<std::vector<int>, std::vector<double>, std::vector<std::string>, DictionaryVector>;
+
+    // A run of live rows in column-major form, restricted to the columns a scan asked for.
+    struct ColumnBatch {
+        std::vector<RID> rids;
+        std::vector<ColumnVector> columns;
+
+        [[nodiscard]] size_t Size() const { return rids.size(); }
+        // Keeps only the given rows, which must be ascending positions in the batch.
+        void Retain(const std::vector<uint32_t>& rows);
+    };
+
+    // Smallest and largest value of one column within a storage block (a page or a row group).
+    // Deletes and updates may leave it wider than the live values, never narrower.
+    struct ColumnZone {
+        std::optional<Field> min;
+        std::optional<Field> max;
+
+        void Add(const Field& value);
+    };
+
+    struct ZoneMap {
+        std::vector<ColumnZone> columns;
+
+        void Add(const std::vector<Field>& fields);
+        // Widens every column to cover the same column of other.
+        void Add(const ZoneMap& other);
+    };
+
+    // "column op value" evaluated inside a scan, with op one of =, <, >, <= and >=. A literal whose type
+    // differs from the column's never matches, and strings only compare for equality.
+    struct ColumnPredicate {
+        size_t column_index;
+        std::string op;
+        Field value;
+
+        // Parses a WHERE predicate "column op value" into a predicate on column_index.
+        static ColumnPredicate Parse(const std::string& predicate, size_t column_index);
+
+        [[nodiscard]] bool Matches(const Field& field) const;
+        // False when no value within the zone can match, so the whole block can be skipped.
+        [[nodiscard]] bool MayMatch(const ColumnZone& zone) const;
+        // Drops from rows, ascending positions in values, every row whose value does not match.
+        void Select(const ColumnVector& values, std::vector<uint32_t>& rows) const;
+        // The same over dictionary codes: the literal is looked up once and codes are compared.
+        void SelectCodes(const std::vector<uint32_t>& codes, const StringDictionary& dictionary, std::vector<uint32_t>& rows) const;
+    };
+}
@@ -0,0 +1,461 @@
+#include "column_encoding.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace storage {
+    namespace {
+        // Integers a double holds exactly; a DOUBLE block within this range can use the integer encodings.
+        constexpr double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+        uint8_t BitWidth(uint64_t range) {
+            uint8_t width = 0;
+            while (range) {
+                ++width;
+                range >>= 1;
+            }
+            return width;
+        }
+
+        size_t PackedWords(size_t count, uint8_t bit_width) {
+            return (count * bit_width + 63) / 64;
+        }
+
+        template<typename T>
+        bool SameValue(const T& a, const T& b) {
+            if constexpr (std::is_same_v<T, double>) return std::memcmp(&a, &b, sizeof(T)) == 0;
+            else return a == b;
+        }
+
+        bool IsExactInteger(double value) {
+            return std::trunc(value) == value && std::fabs(value) <= MAX_EXACT_INTEGER && !(value == 0 && std::signbit(value));
+        }
+
+        template<typename T>
+        void AppendValue(std::string& out, const T& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        template<typename T>
+        void AppendArray(std::string& out, const std::vector<T>& values) {
+            out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+
+        // Only the INTEGER and DOUBLE alternatives of a ColumnVector are ever encoded.
+        template<typename Visitor>
+        void VisitNumeric(const ColumnVector& values, Visitor visitor) {
+            if (auto integers = std::get_if<std::vector<int>>(&values)) visitor(*integers);
+            else visitor(std::get<std::vector<double>>(values));
+        }
+
+        class EncodedReader {
+        public:
+            EncodedReader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+            template<typename T>
+            T Read() {
+                T value;
+                Take(&value, sizeof(value));
+                return value;
+            }
+
+            template<typename T>
+            void ReadArray(std::vector<T>& out, size_t count) {
+                if (count > static_cast<size_t>(end_ - pos_) / sizeof(T)) throw std::runtime_error("Corrupted encoded column");
+                out.resize(count);
+                Take(out.data(), count * sizeof(T));
+            }
+
+        private:
+            const char* pos_;
+            const char* end_;
+
+            void Take(void* out, size_t size) {
+                if (size > static_cast<size_t>(end_ - pos_)) throw std::runtime_error("Corrupted encoded column");
+                if (size == 0) return;
+                std::memcpy(out, pos_, size);
+                pos_ += size;
+            }
+        };
+    }
+
+    EncodedColumn EncodedColumn::Encode(const ColumnVector &values) {
+        EncodedColumn column;
+        std::visit([&](const auto& typed) {
+            using VectorType = std::decay_t<decltype(typed)>;
+            if constexpr (std::is_same_v<VectorType, std::vector<int>> || std::is_same_v<VectorType, std::vector<double>>) {
+                column.EncodeValues(typed);
+            } else {
+                throw std::invalid_argument("Only INTEGER and DOUBLE columns can be encoded");
+            }
+        }, values);
+        return column;
+    }
+
+    template<typename T>
+    void EncodedColumn::EncodeValues(const std::vector<T> &values) {
+        type_ = std::is_same_v<T, int> ? INTEGER : DOUBLE;
+        size_ = static_cast<uint32_t>(values.size());
+        encoding_ = ColumnEncoding::PLAIN;
+        values_ = values;
+        if (values.empty()) return;
+
+        size_t best = values.size() * sizeof(T);
+
+        size_t runs = 1;
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (!SameValue(values[i], values[i - 1])) ++runs;
+        }
+        size_t rle_bytes = sizeof(uint32_t) + runs * (sizeof(T) + sizeof(uint32_t));
+
+        std::vector<int64_t> integers;
+        integers.reserve(values.size());
+        for (const T& value : values) {
+            if constexpr (std::is_same_v<T, double>) {
+                if (!IsExactInteger(value)) break;
+            }
+            integers.push_back(static_cast<int64_t>(value));
+        }
+        bool integral = integers.size() == values.size();
+
+        size_t for_bytes = SIZE_MAX;
+        size_t delta_bytes = SIZE_MAX;
+        int64_t min = 0, max = 0, min_delta = 0, max_delta = 0;
+        uint8_t for_width = 0, delta_width = 0;
+        if (integral) {
+            auto [min_it, max_it] = std::minmax_element(integers.begin(), integers.end());
+            min = *min_it;
+            max = *max_it;
+            for_width = BitWidth(static_cast<uint64_t>(max - min));
+            for_bytes = 3 * sizeof(int64_t) + PackedWords(values.size(), for_width) * sizeof(uint64_t);
+
+            if (values.size() > 1) {
+                min_delta = max_delta = integers[1] - integers[0];
+                for (size_t i = 2; i < integers.size(); ++i) {
+                    int64_t delta = integers[i] - integers[i - 1];
+                    min_delta = std::min(min_delta, delta);
+                    max_delta = std::max(max_delta, delta);
+                }
+            }
+            delta_width = BitWidth(static_cast<uint64_t>(max_delta - min_delta));
+            size_t anchors = (values.size() + DELTA_STRIDE - 1) / DELTA_STRIDE;
+            delta_bytes = 3 * sizeof(int64_t) + PackedWords(values.size(), delta_width) * sizeof(uint64_t) + anchors * sizeof(int64_t);
+        }
+
+        if (rle_bytes < best) {
+            best = rle_bytes;
+            encoding_ = ColumnEncoding::RLE;
+        }
+        if (for_bytes < best) {
+            best = for_bytes;
+            encoding_ = ColumnEncoding::FRAME_OF_REFERENCE;
+        }
+        if (delta_bytes < best) {
+            encoding_ = ColumnEncoding::DELTA;
+        }
+
+        switch (encoding_) {
+            case ColumnEncoding::PLAIN:
+                break;
+            case ColumnEncoding::RLE: {
+                std::vector<T> run_values;
+                run_values.reserve(runs);
+                run_ends_.reserve(runs);
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if (i > 0 && SameValue(values[i], values[i - 1])) continue;
+                    if (i > 0) run_ends_.push_back(static_cast<uint32_t>(i));
+                    run_values.push_back(values[i]);
+                }
+                run_ends_.push_back(size_);
+                values_ = std::move(run_values);
+                break;
+            }
+            case ColumnEncoding::FRAME_OF_REFERENCE:
+                values_ = std::vector<T>();
+                min_ = min;
+                max_ = max;
+                Pack(integers, min, for_width);
+                break;
+            case ColumnEncoding::DELTA: {
+                values_ = std::vector<T>();
+                min_ = min;
+                max_ = max;
+                std::vector<int64_t> deltas(integers.size(), min_delta);
+                for (size_t i = 0; i < integers.size(); ++i) {
+                    if (i % DELTA_STRIDE == 0) anchors_.push_back(integers[i]);
+                    else deltas[i] = integers[i] - integers[i - 1];
+                }
+                Pack(deltas, min_delta, delta_width);
+                break;
+            }
+        }
+    }
+
+    void EncodedColumn::Pack(const std::vector<int64_t> &values, int64_t reference, uint8_t bit_width) {
+        reference_ = reference;
+        bit_width_ = bit_width;
+        packed_.assign(PackedWords(values.size(), bit_width), 0);
+        if (bit_width == 0) return;
+        for (size_t i = 0; i < values.size(); ++i) {
+            uint64_t offset = static_cast<uint64_t>(values[i] - reference);
+            size_t bit = i * bit_width;
+            size_t shift = bit & 63;
+            packed_[bit >> 6] |= offset << shift;
+            if (shift + bit_width > 64) packed_[(bit >> 6) + 1] |= offset >> (64 - shift);
+        }
+    }
+
+    uint64_t EncodedColumn::Unpack(size_t index) const {
+        if (bit_width_ == 0) return 0;
+        size_t bit = index * bit_width_;
+        size_t shift = bit & 63;
+        uint64_t value = packed_[bit >> 6] >> shift;
+        if (shift + bit_width_ > 64) value |= packed_[(bit >> 6) + 1] << (64 - shift);
+        if (bit_width_ < 64) value &= (uint64_t{1} << bit_width_) - 1;
+        return value;
+    }
+
+    int64_t EncodedColumn::GetInteger(size_t row) const {
+        if (encoding_ == ColumnEncoding::FRAME_OF_REFERENCE) return reference_ + static_cast<int64_t>(Unpack(row));
+
+        size_t anchor = row / DELTA_STRIDE;
+        int64_t value = anchors_[anchor];
+        for (size_t i = anchor * DELTA_STRIDE + 1; i <= row; ++i) value += reference_ + static_cast<int64_t>(Unpack(i));
+        return value;
+    }
+
+    template<typename T>
+    void EncodedColumn::DecodeIntegers(std::vector<T> &out) const {
+        out.resize(size_);
+        if (encoding_ == ColumnEncoding::FRAME_OF_REFERENCE) {
+            for (size_t i = 0; i < size_; ++i) out[i] = static_cast<T>(reference_ + static_cast<int64_t>(Unpack(i)));
+            return;
+        }
+        int64_t value = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            if (i % DELTA_STRIDE == 0) value = anchors_[i / DELTA_STRIDE];
+            else value += reference_ + static_cast<int64_t>(Unpack(i));
+            out[i] = static_cast<T>(value);
+        }
+    }
+
+    size_t EncodedColumn::GetEncodedSize() const {
+        size_t value_size = type_ == INTEGER ? sizeof(int) : sizeof(double);
+        switch (encoding_) {
+            case ColumnEncoding::PLAIN: return size_ * value_size;
+            case ColumnEncoding::RLE: return run_ends_.size() * (value_size + sizeof(uint32_t));
+            case ColumnEncoding::FRAME_OF_REFERENCE: return packed_.size() * sizeof(uint64_t);
+            case ColumnEncoding::DELTA: return packed_.size() * sizeof(uint64_t) + anchors_.size() * sizeof(int64_t);
+        }
+        return 0;
+    }
+
+    Field EncodedColumn::Get(size_t row) const {
+        if (row >= size_) throw std::out_of_range("Row out of range");
+        switch (encoding_) {
+            case ColumnEncoding::PLAIN:
+                return std::visit([&](const auto& values) -> Field { return values[row]; }, values_);
+            case ColumnEncoding::RLE: {
+                size_t run = std::upper_bound(run_ends_.begin(), run_ends_.end(), row) - run_ends_.begin();
+                return std::visit([&](const auto& values) -> Field { return values[run]; }, values_);
+            }
+            default: {
+                int64_t value = GetInteger(row);
+                if (type_ == INTEGER) return static_cast<int>(value);
+                return static_cast<double>(value);
+            }
+        }
+    }
+
+    void EncodedColumn::Decode(ColumnVector &out) const {
+        switch (encoding_) {
+            case ColumnEncoding::PLAIN:
+                out = values_;
+                break;
+            case ColumnEncoding::RLE:
+                VisitNumeric(values_, [&](const auto& run_values) {
+                    std::decay_t<decltype(run_values)> values;
+                    values.reserve(size_);
+                    for (size_t run = 0; run < run_ends_.size(); ++run) values.resize(run_ends_[run], run_values[run]);
+                    out = std::move(values);
+                });
+                break;
+            default:
+                if (type_ == INTEGER) {
+                    std::vector<int> values;
+                    DecodeIntegers(values);
+                    out = std::move(values);
+                } else {
+                    std::vector<double> values;
+                    DecodeIntegers(values);
+                    out = std::move(values);
+                }
+                break;
+        }
+    }
+
+    void EncodedColumn::Select(const ColumnPredicate &predicate, std::vector<uint32_t> &rows) const {
+        if (encoding_ == ColumnEncoding::PLAIN) {
+            predicate.Select(values_, rows);
+            return;
+        }
+        auto keep = [&rows](auto&& matches) {
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint32_t row) { return !matches(row); }), rows.end());
+        };
+
+        if (encoding_ == ColumnEncoding::RLE) {
+            size_t run = 0;
+            size_t checked_run = SIZE_MAX;
+            bool run_matches = false;
+            keep([&](uint32_t row) {
+                while (run_ends_[run] <= row) ++run;
+                if (run != checked_run) {
+                    checked_run = run;
+                    run_matches = std::visit([&](const auto& values) { return predicate.Matches(values[run]); }, values_);
+                }
+                return run_matches;
+            });
+            return;
+        }
+
+        double literal;
+        if (type_ == INTEGER && std::holds_alternative<int>(predicate.value)) literal = std::get<int>(predicate.value);
+        else if (type_ == DOUBLE && std::holds_alternative<double>(predicate.value)) literal = std::get<double>(predicate.value);
+        else {
+            rows.clear();
+            return;
+        }
+
+        // Values are integers within [min_, max_], so the literal can be settled against the block range first.
+        auto min = static_cast<double>(min_);
+        auto max = static_cast<double>(max_);
+        if (predicate.op == "=") {
+            if (literal < min || literal > max || std::trunc(literal) != literal) rows.clear();
+        } else if (predicate.op == "<") {
+            if (literal > max) return;
+            if (literal <= min) rows.clear();
+        } else if (predicate.op == ">") {
+            if (literal < min) return;
+            if (literal >= max) rows.clear();
+        } else if (predicate.op == "<=") {
+            if (literal >= max) return;
+            if (literal < min) rows.clear();
+        } else if (predicate.op == ">=") {
+            if (literal <= min) return;
+            if (literal > max) rows.clear();
+        } else {
+            rows.clear();
+        }
+        if (rows.empty()) return;
+
+        if (encoding_ == ColumnEncoding::DELTA) {
+            ColumnVector values;
+            Decode(values);
+            predicate.Select(values, rows);
+            return;
+        }
+
+        if (predicate.op == "=") {
+            auto target = static_cast<uint64_t>(static_cast<int64_t>(literal) - reference_);
+            keep([&](uint32_t row) { return Unpack(row) == target; });
+        } else if (predicate.op == "<") {
+            auto bound = static_cast<uint64_t>(static_cast<int64_t>(std::ceil(literal)) - reference_);
+            keep([&](uint32_t row) { return Unpack(row) < bound; });
+        } else if (predicate.op == "<=") {
+            auto bound = static_cast<uint64_t>(static_cast<int64_t>(std::floor(literal)) - reference_);
+            keep([&](uint32_t row) { return Unpack(row) <= bound; });
+        } else if (predicate.op == ">=") {
+            auto bound = static_cast<uint64_t>(static_cast<int64_t>(std::ceil(literal)) - reference_);
+            keep([&](uint32_t row) { return Unpack(row) >= bound; });
+        } else {
+            auto bound = static_cast<uint64_t>(static_cast<int64_t>(std::floor(literal)) - reference_);
+            keep([&](uint32_t row) { return Unpack(row) > bound; });
+        }
+    }
+
+    void EncodedColumn::Serialize(std::string &out) const {
+        AppendValue(out, static_cast<uint8_t>(encoding_));
+        AppendValue(out, static_cast<uint8_t>(type_));
+        AppendValue(out, bit_width_);
+        AppendValue(out, uint8_t{0});
+        AppendValue(out, size_);
+        switch (encoding_) {
+            case ColumnEncoding::PLAIN:
+                VisitNumeric(values_, [&](const auto& values) { AppendArray(out, values); });
+                break;
+            case ColumnEncoding::RLE:
+                AppendValue(out, static_cast<uint32_t>(run_ends_.size()));
+                VisitNumeric(values_, [&](const auto& values) { AppendArray(out, values); });
+                AppendArray(out, run_ends_);
+                break;
+            case ColumnEncoding::FRAME_OF_REFERENCE:
+            case ColumnEncoding::DELTA:
+                AppendValue(out, min_);
+                AppendValue(out, max_);
+                AppendValue(out, reference_);
+                AppendArray(out, packed_);
+                AppendArray(out, anchors_);
+                break;
+        }
+    }
+
+    EncodedColumn EncodedColumn::Deserialize(DataType type, const char *data, size_t size) {
+        EncodedColumn column;
+        EncodedReader reader(data, size);
+        column.encoding_ = static_cast<ColumnEncoding>(reader.Read<uint8_t>());
+        column.type_ = static_cast<DataType>(reader.Read<uint8_t>());
+        column.bit_width_ = reader.Read<uint8_t>();
+        reader.Read<uint8_t>();
+        column.size_ = reader.Read<uint32_t>();
+        if (column.type_ != type || (type != INTEGER && type != DOUBLE) || column.bit_width_ > 64) {
+            throw std::runtime_error("Corrupted encoded column");
+        }
+
+        auto read_values = [&](size_t count) {
+            if (type == INTEGER) {
+                std::vector<int> values;
+                reader.ReadArray(values, count);
+                column.values_ = std::move(values);
+            } else {
+                std::vector<double> values;
+                reader.ReadArray(values, count);
+                column.values_ = std::move(values);
+            }
+        };
+
+        switch (column.encoding_) {
+            case ColumnEncoding::PLAIN:
+                read_values(column.size_);
+                break;
+            case ColumnEncoding::RLE: {
+                auto runs = reader.Read<uint32_t>();
+                if (runs > column.size_) throw std::runtime_error("Corrupted encoded column");
+                read_values(runs);
+                reader.ReadArray(column.run_ends_, runs);
+                uint32_t previous = 0;
+                for (uint32_t end : column.run_ends_) {
+                    if (end <= previous) throw std::runtime_error("Corrupted encoded column");
+                    previous = end;
+                }
+                if (previous != column.size_) throw std::runtime_error("Corrupted encoded column");
+                break;
+            }
+            case ColumnEncoding::FRAME_OF_REFERENCE:
+            case ColumnEncoding::DELTA: {
+                read_values(0);
+                column.min_ = reader.Read<int64_t>();
+                column.max_ = reader.Read<int64_t>();
+                column.reference_ = reader.Read<int64_t>();
+                reader.ReadArray(column.packed_, PackedWords(column.size_, column.bit_width_));
+                size_t anchors = column.encoding_ == ColumnEncoding::DELTA ? (column.size_ + DELTA_STRIDE - 1) / DELTA_STRIDE : 0;
+                reader.ReadArray(column.anchors_, anchors);
+                break;
+            }
+            default:
+                throw std::runtime_error("Corrupted encoded column");
+        }
+        return column;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "column_batch.h"
+#include "schema.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace storage {
+    enum class ColumnEncoding : uint8_t {
+        PLAIN,
+        RLE,
+        FRAME_OF_REFERENCE,
+        DELTA
+    };
+
+    /*
+     * An immutable block of INTEGER or DOUBLE values in the smallest of a few lightweight encodings:
+     *  RLE                - one value per run of equal values, plus the row each run ends at;
+     *  FRAME_OF_REFERENCE - the block minimum, and each value's distance from it bit-packed at the
+     *                       narrowest width the block needs;
+     *  DELTA              - the differences between neighbouring values, packed the same way, with
+     *                       the running value kept every DELTA_STRIDE rows for random access.
+     * DOUBLE blocks whose values are all integers go through the integer encodings; other DOUBLE
+     * blocks can only be run-length encoded. PLAIN keeps the array as it is.
+     */
+    class EncodedColumn {
+    public:
+        static constexpr size_t DELTA_STRIDE = 128;
+
+        // Picks the encoding that stores values in the fewest bytes.
+        static EncodedColumn Encode(const ColumnVector& values);
+        static EncodedColumn Deserialize(DataType type, const char* data, size_t size);
+
+        [[nodiscard]] ColumnEncoding GetEncoding() const { return encoding_; }
+        [[nodiscard]] size_t Size() const { return size_; }
+        [[nodiscard]] size_t GetEncodedSize() const;
+        [[nodiscard]] Field Get(size_t row) const;
+        // Writes the whole block into out as a plain std::vector<int> or std::vector<double>.
+        void Decode(ColumnVector& out) const;
+        // Like ColumnPredicate::Select, but checks the block range first and compares runs and
+        // frame-of-reference offsets without decoding the values.
+        void Select(const ColumnPredicate& predicate, std::vector<uint32_t>& rows) const;
+        void Serialize(std::string& out) const;
+
+    private:
+        DataType type_ = INTEGER;
+        ColumnEncoding encoding_ = ColumnEncoding::PLAIN;
+        uint32_t size_ = 0;
+        // PLAIN: every value; RLE: one value per run.
+        ColumnVector values_;
+        std::vector<uint32_t> run_ends_;
+        // FRAME_OF_REFERENCE and DELTA: the value range of the block, and the value (or delta)
+        // every packed offset is relative to.
+        int64_t min_ = 0;
+        int64_t max_ = 0;
+        int64_t reference_ = 0;
+        uint8_t bit_width_ = 0;
+        std::vector<uint64_t> packed_;
+        std::vector<int64_t> anchors_;
+
+        template<typename T>
+        void EncodeValues(const std::vector<T>& values);
+        template<typename T>
+        void DecodeIntegers(std::vector<T>& out) const;
+        void Pack(const std::vector<int64_t>& values, int64_t reference, uint8_t bit_width);
+        [[nodiscard]] uint64_t Unpack(size_t index) const;
+        [[nodiscard]] int64_t GetInteger(size_t row) const;
+    };
+}
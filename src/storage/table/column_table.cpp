@@ -0,0 +1,455 @@
+#include "column_table.h"
+#include "tuple_serializer.h"
+#include <atomic>
+#include <stdexcept>
+
+namespace storage {
+    ColumnTable::ColumnTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool)
+            : Table(schema, std::move(buffer_pool)), dictionaries_(NewDictionaries()) {}
+
+    RID ColumnTable::InsertTuple(const std::vector<Field> &fields) {
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+
+        std::string buffer;
+        TupleSerializer::Serialize(schema_, fields, buffer);
+
+        std::lock_guard<std::mutex> lock(latch_);
+        return AppendRow(fields, std::move(buffer));
+    }
+
+    void ColumnTable::InsertTuples(const std::vector<std::vector<Field>>& rows) {
+        std::vector<std::string> buffers(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+            TupleSerializer::Serialize(schema_, rows[i], buffers[i]);
+        }
+
+        std::lock_guard<std::mutex> lock(latch_);
+        for (size_t i = 0; i < rows.size(); ++i) AppendRow(rows[i], std::move(buffers[i]));
+    }
+
+    RID ColumnTable::AppendRow(const std::vector<Field>& fields, std::string buffer) {
+        if (row_groups_.empty() || row_groups_.back()->live.size() == ROWS_PER_GROUP) {
+            if (!row_groups_.empty() && !row_groups_.back()->sealed) row_groups_.back() = Seal(*row_groups_.back());
+            row_groups_.push_back(NewRowGroup());
+        }
+        size_t group = row_groups_.size() - 1;
+        RowGroup& row_group = MutableRowGroup(group);
+        size_t row = row_group.live.size();
+        PlaceRow(row_group, row, fields);
+
+        RID rid = MakeRID(group, static_cast<SlotId>(row));
+        InsertIntoIndexes(fields, rid);
+        Log(LogRecordType::INSERT, rid, std::move(buffer));
+        return rid;
+    }
+
+    bool ColumnTable::RemoveTuple(RID rid) {
+        std::lock_guard<std::mutex> lock(latch_);
+        const RowGroup* found = FindLiveRow(rid);
+        if (!found) return false;
+        size_t row = GetRIDSlot(rid);
+        RemoveFromIndexes(ReadRow(*found, row, dictionaries_), rid);
+
+        RowGroup& row_group = MutableRowGroup(GetRIDPageNumber(rid));
+        row_group.live[row] = 0;
+        if (--row_group.live_count == 0) {
+            row_group.zones.columns.assign(schema_.GetColumnCount(), ColumnZone());
+            row_group.zones_exact = true;
+        } else {
+            row_group.zones_exact = false;
+        }
+        --tuple_count_;
+        Log(LogRecordType::DELETE, rid);
+        return true;
+    }
+
+    bool ColumnTable::UpdateTuple(RID rid, const std::vector<Field> &fields) {
+        std::lock_guard<std::mutex> lock(latch_);
+        const RowGroup* found = FindLiveRow(rid);
+        if (!found) return false;
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+
+        std::string buffer;
+        TupleSerializer::Serialize(schema_, fields, buffer);
+        size_t row = GetRIDSlot(rid);
+        std::vector<Field> old_fields = ReadRow(*found, row, dictionaries_);
+        RowGroup& row_group = MutableRowGroup(GetRIDPageNumber(rid));
+        WriteRow(row_group, row, fields);
+        row_group.zones_exact = false;
+
+        RemoveFromIndexes(old_fields, rid);
+        InsertIntoIndexes(fields, rid);
+        Log(LogRecordType::UPDATE, rid, std::move(buffer));
+        return true;
+    }
+
+    std::vector<RID> ColumnTable::GetAllRID() const {
+        std::vector<RID> rids;
+        rids.reserve(tuple_count_);
+        for (size_t group = 0; group < row_groups_.size(); ++group) {
+            const auto& live = row_groups_[group]->live;
+            for (size_t row = 0; row < live.size(); ++row) {
+                if (live[row]) rids.push_back(MakeRID(group, static_cast<SlotId>(row)));
+            }
+        }
+        return rids;
+    }
+
+    void ColumnTable::Scan(const std::vector<size_t> &column_indexes, const ColumnPredicate *predicate,
+                           const std::function<void(const ColumnBatch &)> &consumer) const {
+        for (size_t column_index : column_indexes) {
+            if (column_index >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+        }
+        if (predicate && predicate->column_index >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+
+        // Holding the groups keeps them stable: a writer copies a group before changing a shared one.
+        std::vector<std::shared_ptr<const RowGroup>> groups;
+        std::vector<std::shared_ptr<const StringDictionary>> dictionaries;
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            groups.assign(row_groups_.begin(), row_groups_.end());
+            dictionaries.assign(dictionaries_.begin(), dictionaries_.end());
+        }
+
+        // Zone maps of VARCHAR columns hold dictionary codes, so an equality is checked against the literal's code.
+        std::optional<ColumnPredicate> zone_predicate;
+        if (predicate) zone_predicate = *predicate;
+        if (predicate && dictionaries[predicate->column_index]) {
+            auto literal = std::get_if<std::string>(&predicate->value);
+            auto code = literal && predicate->op == "=" ? dictionaries[predicate->column_index]->Find(*literal) : std::nullopt;
+            if (!code) return;
+            zone_predicate->value = static_cast<int>(*code);
+        }
+
+        ColumnBatch batch;
+        std::vector<uint32_t> rows;
+        for (size_t group = 0; group < groups.size(); ++group) {
+            const RowGroup& row_group = *groups[group];
+            if (row_group.live_count == 0) continue;
+            if (zone_predicate && !zone_predicate->MayMatch(row_group.zones.columns[zone_predicate->column_index])) continue;
+
+            rows.clear();
+            for (size_t row = 0; row < row_group.live.size(); ++row) {
+                if (row_group.live[row]) rows.push_back(static_cast<uint32_t>(row));
+            }
+            if (predicate) {
+                size_t column_index = predicate->column_index;
+                const ColumnVector& values = row_group.columns[column_index];
+                if (row_group.encoded[column_index]) row_group.encoded[column_index]->Select(*predicate, rows);
+                else if (auto codes = std::get_if<DictionaryVector>(&values)) predicate->SelectCodes(codes->codes, *dictionaries[column_index], rows);
+                else predicate->Select(values, rows);
+                if (rows.empty()) continue;
+            }
+            bool all_rows = rows.size() == row_group.live.size();
+
+            batch.rids.clear();
+            batch.rids.reserve(rows.size());
+            for (uint32_t row : rows) batch.rids.push_back(MakeRID(group, static_cast<SlotId>(row)));
+
+            auto select = [&](const auto& values) {
+                std::decay_t<decltype(values)> selected;
+                if (all_rows) {
+                    selected = values;
+                } else {
+                    selected.reserve(rows.size());
+                    for (uint32_t row : rows) selected.push_back(values[row]);
+                }
+                return selected;
+            };
+            batch.columns.clear();
+            for (size_t column_index : column_indexes) {
+                if (const auto& encoded = row_group.encoded[column_index]) {
+                    ColumnVector decoded;
+                    encoded->Decode(decoded);
+                    if (all_rows) batch.columns.push_back(std::move(decoded));
+                    else if (auto integers = std::get_if<std::vector<int>>(&decoded)) batch.columns.emplace_back(select(*integers));
+                    else batch.columns.emplace_back(select(std::get<std::vector<double>>(decoded)));
+                    continue;
+                }
+                std::visit([&](const auto& values) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) {
+                        batch.columns.emplace_back(DictionaryVector{select(values.codes), dictionaries[column_index]});
+                    } else {
+                        batch.columns.emplace_back(select(values));
+                    }
+                }, row_group.columns[column_index]);
+            }
+            consumer(batch);
+        }
+    }
+
+    TableStorage ColumnTable::GetStorage() const {
+        return TableStorage::COLUMN;
+    }
+
+    void ColumnTable::WriteSnapshot(const std::string &file_name) const {
+        std::vector<std::shared_ptr<const RowGroup>> groups;
+        Dictionaries dictionaries;
+        lsn_t lsn;
+        std::vector<TableFileIndex> indexes;
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            if (!snapshot_) throw std::logic_error("No snapshot in progress");
+            groups = snapshot_groups_;
+            dictionaries = snapshot_dictionaries_;
+            lsn = snapshot_->lsn;
+            indexes = snapshot_->indexes;
+        }
+
+        TableFileWriter writer(file_name, schema_, indexes);
+        std::string buffer;
+        for (size_t group = 0; group < groups.size(); ++group) {
+            RowGroup row_group = *groups[group];
+            Materialize(row_group);
+            for (size_t row = 0; row < row_group.live.size(); ++row) {
+                if (!row_group.live[row]) continue;
+                TupleSerializer::Serialize(schema_, ReadRow(row_group, row, dictionaries), buffer);
+                writer.AppendRow(MakeRID(group, static_cast<SlotId>(row)), buffer.data(), buffer.size());
+            }
+        }
+        writer.Finish(lsn);
+
+        // Groups decoded by updates, or with loose zone maps, are sealed again unless a writer got to them meanwhile.
+        for (size_t group = 0; group < groups.size(); ++group) {
+            const RowGroup& row_group = *groups[group];
+            if ((row_group.sealed && row_group.zones_exact) || !IsSealable(group, groups.size(), row_group)) continue;
+            std::shared_ptr<RowGroup> sealed = Seal(*groups[group]);
+            std::lock_guard<std::mutex> lock(latch_);
+            if (group < row_groups_.size() && row_groups_[group] == groups[group]) row_groups_[group] = std::move(sealed);
+        }
+    }
+
+    void ColumnTable::RestoreTuple(RID rid, const char *data, uint16_t size, const std::vector<Field> *fields) {
+        size_t group = GetRIDPageNumber(rid);
+        size_t row = GetRIDSlot(rid);
+        if (row >= ROWS_PER_GROUP) throw std::runtime_error("Tuple cannot be placed at its RID");
+        std::vector<Field> decoded;
+        if (!fields) {
+            decoded = TupleSerializer::Deserialize(schema_, data, size);
+            fields = &decoded;
+        }
+
+        while (row_groups_.size() <= group) row_groups_.push_back(NewRowGroup());
+        RowGroup& row_group = MutableRowGroup(group);
+        if (row < row_group.live.size() && row_group.live[row]) throw std::runtime_error("Tuple cannot be placed at its RID");
+        PlaceRow(row_group, row, *fields);
+    }
+
+    void ColumnTable::FinishRestore() {
+        for (size_t group = 0; group < row_groups_.size(); ++group) {
+            const RowGroup& row_group = *row_groups_[group];
+            if ((!row_group.sealed || !row_group.zones_exact) && IsSealable(group, row_groups_.size(), row_group)) {
+                row_groups_[group] = Seal(row_group);
+            }
+        }
+    }
+
+    std::vector<Field> ColumnTable::ReadFields(RID rid) const {
+        const RowGroup* row_group = FindLiveRow(rid);
+        if (!row_group) throw std::out_of_range("Invalid RID");
+        return ReadRow(*row_group, GetRIDSlot(rid), dictionaries_);
+    }
+
+    void ColumnTable::Clear() {
+        Table::Clear();
+        row_groups_.clear();
+        dictionaries_ = NewDictionaries();
+    }
+
+    void ColumnTable::PrepareSnapshot() const {
+        snapshot_groups_.assign(row_groups_.begin(), row_groups_.end());
+        snapshot_dictionaries_ = dictionaries_;
+    }
+
+    void ColumnTable::ReleaseSnapshot() const {
+        snapshot_groups_.clear();
+        snapshot_dictionaries_.clear();
+    }
+
+    std::shared_ptr<ColumnTable::RowGroup> ColumnTable::NewRowGroup(size_t capacity) const {
+        auto row_group = std::make_shared<RowGroup>();
+        row_group->live.reserve(capacity);
+        row_group->encoded.resize(schema_.GetColumnCount());
+        row_group->zones.columns.resize(schema_.GetColumnCount());
+        for (const auto& column : schema_.GetColumns()) {
+            switch (column.type) {
+                case DataType::INTEGER: row_group->columns.emplace_back(std::vector<int>()); break;
+                case DataType::DOUBLE: row_group->columns.emplace_back(std::vector<double>()); break;
+                case DataType::VARCHAR: row_group->columns.emplace_back(DictionaryVector()); break;
+            }
+            std::visit([capacity](auto& values) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) values.codes.reserve(capacity);
+                else values.reserve(capacity);
+            }, row_group->columns.back());
+        }
+        return row_group;
+    }
+
+    VacuumStats ColumnTable::Vacuum() {
+        VacuumStats stats;
+        for (size_t group = 0;; ++group) {
+            std::lock_guard<std::mutex> lock(latch_);
+            // The last group still takes appends, so it keeps its rows and their positions.
+            if (group + 1 >= row_groups_.size()) break;
+            const RowGroup& row_group = *row_groups_[group];
+            if (row_group.live_count > 0 || row_group.live.empty()) continue;
+
+            stats.bytes_reclaimed += GetAllocatedBytes(row_group);
+            auto empty = NewRowGroup(0);
+            empty->sealed = true;
+            row_groups_[group] = std::move(empty);
+            ++stats.blocks_freed;
+        }
+        return stats;
+    }
+
+    size_t ColumnTable::GetAllocatedBytes(const RowGroup &group) {
+        size_t bytes = group.live.capacity();
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            if (group.encoded[i]) bytes += group.encoded[i]->GetEncodedSize();
+            std::visit([&bytes](const auto& values) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) {
+                    bytes += values.codes.capacity() * sizeof(uint32_t);
+                } else {
+                    bytes += values.capacity() * sizeof(typename std::decay_t<decltype(values)>::value_type);
+                }
+            }, group.columns[i]);
+        }
+        return bytes;
+    }
+
+    ColumnTable::Dictionaries ColumnTable::NewDictionaries() const {
+        Dictionaries dictionaries;
+        auto arena = std::make_shared<common::Arena>();
+        for (const auto& column : schema_.GetColumns()) {
+            if (column.type != DataType::VARCHAR) {
+                dictionaries.push_back(nullptr);
+                continue;
+            }
+            dictionaries.push_back(std::make_shared<StringDictionary>());
+            dictionaries.back()->arena = arena;
+        }
+        return dictionaries;
+    }
+
+    ColumnTable::RowGroup& ColumnTable::MutableRowGroup(size_t group) {
+        auto& row_group = row_groups_[group];
+        if (row_group.use_count() > 1) row_group = std::make_shared<RowGroup>(*row_group);
+        // use_count() is a relaxed load; the fence orders the writes after the reads of a scan that just let go.
+        else std::atomic_thread_fence(std::memory_order_acquire);
+        return *row_group;
+    }
+
+    StringDictionary& ColumnTable::MutableDictionary(size_t column) {
+        auto& dictionary = dictionaries_[column];
+        if (dictionary.use_count() > 1) dictionary = std::make_shared<StringDictionary>(*dictionary);
+        else std::atomic_thread_fence(std::memory_order_acquire);
+        return *dictionary;
+    }
+
+    bool ColumnTable::IsSealable(size_t group, size_t group_count, const RowGroup &row_group) {
+        // Rows are only appended to the last group, and only until it is full.
+        return group + 1 < group_count || row_group.live.size() == ROWS_PER_GROUP;
+    }
+
+    std::shared_ptr<ColumnTable::RowGroup> ColumnTable::Seal(const RowGroup &group) {
+        auto sealed = std::make_shared<RowGroup>(group);
+        Materialize(*sealed);
+
+        sealed->zones.columns.assign(sealed->columns.size(), ColumnZone());
+        for (size_t i = 0; i < sealed->columns.size(); ++i) {
+            ColumnZone& zone = sealed->zones.columns[i];
+            std::visit([&](const auto& values) {
+                for (size_t row = 0; row < sealed->live.size(); ++row) {
+                    if (!sealed->live[row]) continue;
+                    if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) zone.Add(static_cast<int>(values.codes[row]));
+                    else zone.Add(values[row]);
+                }
+            }, sealed->columns[i]);
+        }
+        sealed->zones_exact = true;
+
+        for (size_t i = 0; i < sealed->columns.size(); ++i) {
+            auto& values = sealed->columns[i];
+            if (std::holds_alternative<std::vector<std::string>>(values) || std::holds_alternative<DictionaryVector>(values)) continue;
+            EncodedColumn encoded = EncodedColumn::Encode(values);
+            if (encoded.GetEncoding() == ColumnEncoding::PLAIN) continue;
+            sealed->encoded[i] = std::make_shared<const EncodedColumn>(std::move(encoded));
+            if (std::holds_alternative<std::vector<int>>(values)) values = std::vector<int>();
+            else values = std::vector<double>();
+        }
+        sealed->sealed = true;
+        return sealed;
+    }
+
+    void ColumnTable::Materialize(RowGroup &group) {
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            if (!group.encoded[i]) continue;
+            group.encoded[i]->Decode(group.columns[i]);
+            group.encoded[i].reset();
+        }
+        group.sealed = false;
+    }
+
+    const ColumnTable::RowGroup* ColumnTable::FindLiveRow(RID rid) const {
+        size_t group = GetRIDPageNumber(rid);
+        size_t row = GetRIDSlot(rid);
+        if (group >= row_groups_.size()) return nullptr;
+        const RowGroup& row_group = *row_groups_[group];
+        if (row >= row_group.live.size() || !row_group.live[row]) return nullptr;
+        return &row_group;
+    }
+
+    void ColumnTable::PlaceRow(RowGroup &group, size_t row, const std::vector<Field> &fields) {
+        Materialize(group);
+        if (row >= group.live.size()) {
+            group.live.resize(row + 1, 0);
+            for (auto& column : group.columns) {
+                std::visit([&](auto& values) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) values.codes.resize(row + 1);
+                    else values.resize(row + 1);
+                }, column);
+            }
+        }
+        WriteRow(group, row, fields);
+        group.live[row] = 1;
+        ++group.live_count;
+        ++tuple_count_;
+    }
+
+    void ColumnTable::WriteRow(RowGroup &group, size_t row, const std::vector<Field> &fields) {
+        Materialize(group);
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            std::visit([&](auto& values) {
+                using VectorType = std::decay_t<decltype(values)>;
+                if constexpr (std::is_same_v<VectorType, DictionaryVector>) {
+                    values.codes[row] = MutableDictionary(i).Encode(std::get<std::string>(fields[i]));
+                    group.zones.columns[i].Add(static_cast<int>(values.codes[row]));
+                } else {
+                    values[row] = std::get<typename VectorType::value_type>(fields[i]);
+                    group.zones.columns[i].Add(fields[i]);
+                }
+            }, group.columns[i]);
+        }
+    }
+
+    std::vector<Field> ColumnTable::ReadRow(const RowGroup &group, size_t row, const Dictionaries &dictionaries) {
+        std::vector<Field> fields;
+        fields.reserve(group.columns.size());
+        for (size_t i = 0; i < group.columns.size(); ++i) {
+            if (group.encoded[i]) {
+                fields.push_back(group.encoded[i]->Get(row));
+                continue;
+            }
+            std::visit([&](const auto& values) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) {
+                    fields.emplace_back(std::string(dictionaries[i]->values[values.codes[row]]));
+                } else {
+                    fields.emplace_back(values[row]);
+                }
+            }, group.columns[i]);
+        }
+        return fields;
+    }
+}
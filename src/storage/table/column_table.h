@@ -0,0 +1,86 @@
+#pragma once
+
+#include "table.h"
+#include "column_encoding.h"
+
+namespace storage {
+    /*
+     * Column-oriented (PAX) layout: rows are kept in row groups of ROWS_PER_GROUP rows,
+     * and inside a group every column is a contiguous typed array, so a scan reads only
+     * the columns it asks for. A RID is (row group << 32) | row within the group.
+     * Row groups are shared with a running snapshot and copied before a writer changes
+     * one the snapshot still holds.
+     * VARCHAR columns are dictionary-encoded: a row group stores 32-bit codes and the
+     * table keeps one append-only dictionary per column, shared the same way. The strings
+     * of all dictionaries of the table are packed into one arena.
+     * A row group is sealed once no more rows are appended to it (when it fills up, when
+     * it is restored from a snapshot, or at the next checkpoint after an update): its
+     * INTEGER and DOUBLE columns are replaced by an EncodedColumn wherever that is smaller.
+     * Updating a sealed group decodes it again.
+     * Every group keeps a zone map (dictionary codes for VARCHAR columns) that scans use to
+     * skip it; sealing recomputes it from the live rows.
+     */
+    class ColumnTable : public Table {
+    public:
+        static constexpr size_t ROWS_PER_GROUP = 4096;
+
+        explicit ColumnTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool = nullptr);
+
+        RID InsertTuple(const std::vector<Field>& fields) override;
+        void InsertTuples(const std::vector<std::vector<Field>>& rows) override;
+        bool RemoveTuple(RID rid) override;
+        bool UpdateTuple(RID rid, const std::vector<Field>& fields) override;
+        [[nodiscard]] std::vector<RID> GetAllRID() const override;
+        void Scan(const std::vector<size_t>& column_indexes, const ColumnPredicate* predicate,
+                  const std::function<void(const ColumnBatch&)>& consumer) const override;
+        [[nodiscard]] TableStorage GetStorage() const override;
+        void WriteSnapshot(const std::string& file_name) const override;
+        // Releases the storage of row groups whose rows were all deleted. Rows are addressed by
+        // position, so groups that still hold live rows keep their deleted ones.
+        VacuumStats Vacuum() override;
+
+    protected:
+        void RestoreTuple(RID rid, const char* data, uint16_t size, const std::vector<Field>* fields) override;
+        void FinishRestore() override;
+        [[nodiscard]] std::vector<Field> ReadFields(RID rid) const override;
+        void Clear() override;
+        void PrepareSnapshot() const override;
+        void ReleaseSnapshot() const override;
+
+    private:
+        struct RowGroup {
+            // An encoded column leaves its entry in columns empty.
+            std::vector<ColumnVector> columns;
+            std::vector<std::shared_ptr<const EncodedColumn>> encoded;
+            std::vector<uint8_t> live;
+            size_t live_count = 0;
+            bool sealed = false;
+            ZoneMap zones;
+            // False once a delete or update may have left the zone map wider than the live rows.
+            bool zones_exact = true;
+        };
+
+        using Dictionaries = std::vector<std::shared_ptr<StringDictionary>>;
+
+        // Mutable so that a checkpoint can swap in a sealed copy of a group; the rows stay the same.
+        mutable std::vector<std::shared_ptr<RowGroup>> row_groups_;
+        Dictionaries dictionaries_;
+        mutable std::vector<std::shared_ptr<const RowGroup>> snapshot_groups_;
+        mutable Dictionaries snapshot_dictionaries_;
+
+        [[nodiscard]] std::shared_ptr<RowGroup> NewRowGroup(size_t capacity = ROWS_PER_GROUP) const;
+        [[nodiscard]] Dictionaries NewDictionaries() const;
+        RowGroup& MutableRowGroup(size_t group);
+        StringDictionary& MutableDictionary(size_t column);
+        [[nodiscard]] const RowGroup* FindLiveRow(RID rid) const;
+        [[nodiscard]] static bool IsSealable(size_t group, size_t group_count, const RowGroup& row_group);
+        [[nodiscard]] static std::shared_ptr<RowGroup> Seal(const RowGroup& group);
+        static void Materialize(RowGroup& group);
+        // Appends a row and logs it; the latch is held.
+        RID AppendRow(const std::vector<Field>& fields, std::string buffer);
+        void PlaceRow(RowGroup& group, size_t row, const std::vector<Field>& fields);
+        void WriteRow(RowGroup& group, size_t row, const std::vector<Field>& fields);
+        static std::vector<Field> ReadRow(const RowGroup& group, size_t row, const Dictionaries& dictionaries);
+        [[nodiscard]] static size_t GetAllocatedBytes(const RowGroup& group);
+    };
+}
@@ -0,0 +1,200 @@
+#include "csv_reader.h"
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace storage {
+    namespace {
+        // Length of the prefix of data that ends with its last line break outside quotes; newlines
+        // is set to the number of line breaks in that prefix, quoted ones included.
+        size_t CompleteLinesLength(std::string_view data, size_t& newlines) {
+            size_t length = 0;
+            size_t count = 0;
+            newlines = 0;
+            bool quoted = false;
+            for (size_t i = 0; i < data.size(); ++i) {
+                char c = data[i];
+                if (c == '"') {
+                    quoted = !quoted;
+                } else if (c == '\n') {
+                    ++count;
+                    if (!quoted) {
+                        length = i + 1;
+                        newlines = count;
+                    }
+                }
+            }
+            return length;
+        }
+
+        std::runtime_error LineError(size_t line, const std::string& message) {
+            return std::runtime_error("Line " + std::to_string(line) + ": " + message);
+        }
+
+        template<typename NumberType>
+        bool ParseNumber(std::string_view text, NumberType& value) {
+            const char* end = text.data() + text.size();
+            auto [parsed_end, error] = std::from_chars(text.data(), end, value);
+            return error == std::errc() && parsed_end == end;
+        }
+    }
+
+    CsvReader::CsvReader(const Schema& schema, CsvOptions options) : schema_(schema), options_(options) {
+        if (options_.chunk_size == 0) throw std::invalid_argument("CSV chunk size must be positive");
+        if (options_.delimiter == '"' || options_.delimiter == '\n' || options_.delimiter == '\r') {
+            throw std::invalid_argument("Invalid CSV delimiter");
+        }
+    }
+
+    size_t CsvReader::Read(const std::string& file_name, const std::function<void(Rows& rows)>& consumer) const {
+        std::ifstream file(file_name, std::ios::binary);
+        if (!file) throw std::runtime_error("Cannot open file: " + file_name);
+
+        size_t threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+        std::deque<std::future<Rows>> pending;
+        size_t row_count = 0;
+        auto deliver = [&]() {
+            Rows rows = pending.front().get();
+            pending.pop_front();
+            row_count += rows.size();
+            consumer(rows);
+        };
+
+        std::string buffer;
+        size_t line = 1;
+        bool skip_header = options_.header;
+        bool at_end = false;
+        while (!at_end) {
+            size_t offset = buffer.size();
+            buffer.resize(offset + options_.chunk_size);
+            file.read(buffer.data() + offset, static_cast<std::streamsize>(options_.chunk_size));
+            auto read = static_cast<size_t>(file.gcount());
+            buffer.resize(offset + read);
+            at_end = read < options_.chunk_size;
+            if (file.bad()) throw std::runtime_error("Failed to read file: " + file_name);
+
+            // A line longer than a chunk keeps growing the buffer until it is complete.
+            size_t newlines = 0;
+            size_t length = at_end ? buffer.size() : CompleteLinesLength(buffer, newlines);
+            if (length == 0) continue;
+
+            std::string chunk = buffer.substr(0, length);
+            buffer.erase(0, length);
+            pending.push_back(std::async(std::launch::async, [this, chunk = std::move(chunk), line, skip_header]() {
+                return ParseChunk(chunk, line, skip_header);
+            }));
+            line += newlines;
+            skip_header = false;
+            if (pending.size() > threads) deliver();
+        }
+        while (!pending.empty()) deliver();
+        return row_count;
+    }
+
+    CsvReader::Rows CsvReader::ParseChunk(std::string_view chunk, size_t first_line, bool skip_first_line) const {
+        const size_t column_count = schema_.GetColumnCount();
+        const char delimiter = options_.delimiter;
+        Rows rows;
+        std::string unquoted;
+        size_t line = first_line;
+        size_t pos = 0;
+        bool skip = skip_first_line;
+
+        while (pos < chunk.size()) {
+            if (chunk[pos] == '\n' || chunk.compare(pos, 2, "\r\n") == 0) {
+                pos += chunk[pos] == '\n' ? 1 : 2;
+                ++line;
+                continue;
+            }
+
+            size_t row_line = line;
+            std::vector<Field> row;
+            row.reserve(column_count);
+            while (true) {
+                std::string_view text;
+                if (pos < chunk.size() && chunk[pos] == '"') {
+                    unquoted.clear();
+                    ++pos;
+                    while (true) {
+                        size_t quote = chunk.find('"', pos);
+                        if (quote == std::string_view::npos) throw LineError(row_line, "unterminated quoted field");
+                        unquoted.append(chunk.substr(pos, quote - pos));
+                        line += std::count(chunk.begin() + static_cast<std::ptrdiff_t>(pos), chunk.begin() + static_cast<std::ptrdiff_t>(quote), '\n');
+                        pos = quote + 1;
+                        if (pos < chunk.size() && chunk[pos] == '"') {
+                            unquoted.push_back('"');
+                            ++pos;
+                            continue;
+                        }
+                        break;
+                    }
+                    text = unquoted;
+                } else {
+                    size_t end = pos;
+                    while (end < chunk.size() && chunk[end] != delimiter && chunk[end] != '\n') ++end;
+                    text = chunk.substr(pos, end - pos);
+                    pos = end;
+                    if (!text.empty() && text.back() == '\r' && (pos == chunk.size() || chunk[pos] == '\n')) text.remove_suffix(1);
+                }
+
+                if (!skip) {
+                    if (row.size() == column_count) {
+                        throw LineError(row_line, "expected " + std::to_string(column_count) + " fields, found more");
+                    }
+                    ParseField(text, row.size(), row_line, row);
+                }
+
+                if (pos < chunk.size() && chunk[pos] == delimiter) {
+                    ++pos;
+                    continue;
+                }
+                if (pos < chunk.size() && chunk[pos] == '\r') ++pos;
+                if (pos < chunk.size()) {
+                    if (chunk[pos] != '\n') throw LineError(row_line, "unexpected character after quoted field");
+                    ++pos;
+                    ++line;
+                }
+                break;
+            }
+
+            if (skip) {
+                skip = false;
+                continue;
+            }
+            if (row.size() != column_count) {
+                throw LineError(row_line, "expected " + std::to_string(column_count) + " fields, found " + std::to_string(row.size()));
+            }
+            rows.push_back(std::move(row));
+        }
+        return rows;
+    }
+
+    void CsvReader::ParseField(std::string_view text, size_t column, size_t line, std::vector<Field>& row) const {
+        const Column& definition = schema_.GetColumn(column);
+        switch (definition.type) {
+            case DataType::INTEGER: {
+                int value;
+                if (!ParseNumber(text, value)) {
+                    throw LineError(line, "invalid INTEGER value '" + std::string(text) + "' for column " + definition.name);
+                }
+                row.emplace_back(value);
+                break;
+            }
+            case DataType::DOUBLE: {
+                double value;
+                if (!ParseNumber(text, value)) {
+                    throw LineError(line, "invalid DOUBLE value '" + std::string(text) + "' for column " + definition.name);
+                }
+                row.emplace_back(value);
+                break;
+            }
+            case DataType::VARCHAR:
+                row.emplace_back(std::string(text));
+                break;
+        }
+    }
+}
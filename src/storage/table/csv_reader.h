@@ -0,0 +1,47 @@
+#pragma once
+
+#include "schema.h"
+#include "tuple.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace storage {
+    struct CsvOptions {
+        char delimiter = ',';
+        // Skip the first line of the file.
+        bool header = false;
+        size_t chunk_size = 1 << 20;
+        // Parsing threads; 0 takes one per hardware thread.
+        size_t threads = 0;
+    };
+
+    /*
+     * Reads CSV files into rows of a schema: one line per row, its fields in schema order.
+     * Fields may be enclosed in double quotes, which lets them hold the delimiter, line breaks
+     * and doubled quotes (""). Empty lines are skipped and a trailing \r is dropped.
+     * The file is read in chunks that end on a line boundary outside quotes; chunks are split
+     * into fields and converted on worker threads, while the calling thread reads ahead.
+     */
+    class CsvReader {
+    public:
+        using Rows = std::vector<std::vector<Field>>;
+
+        explicit CsvReader(const Schema& schema, CsvOptions options = {});
+
+        // Hands the rows of every chunk to the consumer, in file order and on the calling thread.
+        // Returns the number of rows read. A malformed line throws, after the rows before its
+        // chunk have been handed out.
+        size_t Read(const std::string& file_name, const std::function<void(Rows& rows)>& consumer) const;
+
+        // Parses whole lines; first_line is the line number of the first one, for error messages.
+        [[nodiscard]] Rows ParseChunk(std::string_view chunk, size_t first_line, bool skip_first_line = false) const;
+
+    private:
+        const Schema& schema_;
+        CsvOptions options_;
+
+        void ParseField(std::string_view text, size_t column, size_t line, std::vector<Field>& row) const;
+    };
+}
@@ -0,0 +1,307 @@
+#include "partitioned_table.h"
+#include "crc32.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace storage {
+    namespace {
+        uint32_t HashValue(const Field& value) {
+            return std::visit([](const auto& v) -> uint32_t {
+                using ValueType = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<ValueType, std::string>) {
+                    return common::Crc32(v.data(), v.size());
+                } else if constexpr (std::is_same_v<ValueType, double>) {
+                    double normalized = v == 0.0 ? 0.0 : v;
+                    return common::Crc32(&normalized, sizeof(normalized));
+                } else {
+                    return common::Crc32(&v, sizeof(v));
+                }
+            }, value);
+        }
+
+        bool HasType(const Field& value, DataType type) {
+            switch (type) {
+                case DataType::INTEGER: return std::holds_alternative<int>(value);
+                case DataType::DOUBLE: return std::holds_alternative<double>(value);
+                case DataType::VARCHAR: return std::holds_alternative<std::string>(value);
+            }
+            return false;
+        }
+
+        void AppendString(std::string& out, const std::string& value) {
+            auto length = static_cast<uint32_t>(value.size());
+            out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            out.append(value);
+        }
+    }
+
+    std::string FormatPartitionBound(const std::optional<Field>& bound) {
+        if (!bound) return "";
+        return std::visit([](const auto& v) -> std::string {
+            using ValueType = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<ValueType, std::string>) {
+                return v;
+            } else if constexpr (std::is_same_v<ValueType, double>) {
+                char buffer[32];
+                std::snprintf(buffer, sizeof(buffer), "%.17g", v);
+                return buffer;
+            } else {
+                return std::to_string(v);
+            }
+        }, *bound);
+    }
+
+    std::optional<Field> ParsePartitionBound(const std::string& text, DataType type) {
+        if (text.empty()) return std::nullopt;
+        switch (type) {
+            case DataType::INTEGER: return Field{std::stoi(text)};
+            case DataType::DOUBLE: return Field{std::stod(text)};
+            case DataType::VARCHAR: return Field{text};
+        }
+        return std::nullopt;
+    }
+
+    void PartitionScheme::Validate(const Schema& schema) {
+        if (column_index >= schema.GetColumnCount()) throw std::out_of_range("Partition column index out of range");
+        if (partitions.empty()) throw std::invalid_argument("A partitioned table needs at least one partition");
+        if (partitions.size() > MAX_PARTITIONS) throw std::invalid_argument("Too many partitions");
+
+        DataType type = schema.GetColumn(column_index).type;
+        std::unordered_set<std::string> names;
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            auto& partition = partitions[i];
+            if (partition.name.empty()) throw std::invalid_argument("Partition name must not be empty");
+            if (!names.insert(partition.name).second) throw std::invalid_argument("Duplicate partition: " + partition.name);
+
+            auto& bound = partition.upper_bound;
+            if (strategy == PartitionStrategy::HASH) {
+                if (bound) throw std::invalid_argument("Hash partitions take no bounds");
+                continue;
+            }
+            if (!bound) {
+                if (i + 1 != partitions.size()) throw std::invalid_argument("Only the last range partition may be MAXVALUE");
+                continue;
+            }
+            if (type == DataType::DOUBLE && std::holds_alternative<int>(*bound)) bound = static_cast<double>(std::get<int>(*bound));
+            if (!HasType(*bound, type)) throw std::invalid_argument("Bound of partition " + partition.name + " does not match the column type");
+            if (type == DataType::VARCHAR && std::get<std::string>(*bound).empty()) {
+                throw std::invalid_argument("Bound of partition " + partition.name + " must not be empty");
+            }
+            if (i > 0 && !(*partitions[i - 1].upper_bound < *bound)) {
+                throw std::invalid_argument("Range partition bounds must be strictly ascending");
+            }
+        }
+    }
+
+    size_t PartitionScheme::Route(const Field& value) const {
+        if (strategy == PartitionStrategy::HASH) return HashValue(value) % partitions.size();
+
+        // Bounds ascend, so the partitions whose bound the value reaches form a prefix.
+        auto it = std::partition_point(partitions.begin(), partitions.end(), [&](const PartitionDefinition& partition) {
+            return partition.upper_bound && !(value < *partition.upper_bound);
+        });
+        if (it == partitions.end()) throw std::invalid_argument("No partition for value " + FormatPartitionBound(value));
+        return static_cast<size_t>(it - partitions.begin());
+    }
+
+    std::vector<size_t> PartitionScheme::Prune(const ColumnPredicate* predicate) const {
+        std::vector<size_t> result;
+        if (predicate && predicate->column_index == column_index && strategy == PartitionStrategy::HASH && predicate->op == "=") {
+            result.push_back(Route(predicate->value));
+            return result;
+        }
+        if (!predicate || predicate->column_index != column_index || strategy == PartitionStrategy::HASH) {
+            result.resize(partitions.size());
+            std::iota(result.begin(), result.end(), 0);
+            return result;
+        }
+
+        const Field& value = predicate->value;
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            const auto& lower = i > 0 ? partitions[i - 1].upper_bound : std::nullopt;
+            const auto& upper = partitions[i].upper_bound;
+            bool may_match = true;
+            if (predicate->op == "=") {
+                may_match = (!lower || !(value < *lower)) && (!upper || value < *upper);
+            } else if (predicate->op == "<") {
+                may_match = !lower || *lower < value;
+            } else if (predicate->op == "<=") {
+                may_match = !lower || !(value < *lower);
+            } else if (predicate->op == ">" || predicate->op == ">=") {
+                may_match = !upper || value < *upper;
+            }
+            if (may_match) result.push_back(i);
+        }
+        return result;
+    }
+
+    std::optional<size_t> PartitionScheme::FindPartition(const std::string& name) const {
+        for (size_t i = 0; i < partitions.size(); ++i) {
+            if (partitions[i].name == name) return i;
+        }
+        return std::nullopt;
+    }
+
+    void PartitionScheme::Serialize(std::string& out) const {
+        auto strategy_value = static_cast<uint8_t>(strategy);
+        auto column = static_cast<uint32_t>(column_index);
+        auto count = static_cast<uint32_t>(partitions.size());
+        out.append(reinterpret_cast<const char*>(&strategy_value), sizeof(strategy_value));
+        out.append(reinterpret_cast<const char*>(&column), sizeof(column));
+        out.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const auto& partition : partitions) {
+            AppendString(out, partition.name);
+            AppendString(out, FormatPartitionBound(partition.upper_bound));
+        }
+    }
+
+    PartitionScheme PartitionScheme::Deserialize(const std::string& data, const Schema& schema) {
+        size_t pos = 0;
+        auto take = [&](void* out, size_t size) {
+            if (pos + size > data.size()) throw std::runtime_error("Corrupted partition scheme");
+            std::memcpy(out, data.data() + pos, size);
+            pos += size;
+        };
+        auto take_string = [&]() {
+            uint32_t length;
+            take(&length, sizeof(length));
+            std::string value(length, '\0');
+            take(value.data(), length);
+            return value;
+        };
+
+        PartitionScheme scheme;
+        uint8_t strategy_value;
+        uint32_t column;
+        uint32_t count;
+        take(&strategy_value, sizeof(strategy_value));
+        take(&column, sizeof(column));
+        take(&count, sizeof(count));
+        scheme.strategy = static_cast<PartitionStrategy>(strategy_value);
+        scheme.column_index = column;
+        if (column >= schema.GetColumnCount()) throw std::runtime_error("Corrupted partition scheme");
+        DataType type = schema.GetColumn(column).type;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string name = take_string();
+            scheme.partitions.push_back({name, ParsePartitionBound(take_string(), type)});
+        }
+        return scheme;
+    }
+
+    PartitionedTable::PartitionedTable(const Schema& schema, std::string table_name, TableStorage storage, PartitionScheme scheme,
+                                       Resolver resolver, std::shared_ptr<BufferPoolManager> buffer_pool)
+            : Table(schema, std::move(buffer_pool)), storage_(storage), scheme_(std::move(scheme)), resolver_(std::move(resolver)) {
+        table_name_ = std::move(table_name);
+    }
+
+    std::shared_ptr<Table> PartitionedTable::GetPartition(size_t partition) const {
+        if (partition >= scheme_.partitions.size()) throw std::out_of_range("Partition out of range");
+        return resolver_(PartitionTableName(table_name_, scheme_.partitions[partition].name));
+    }
+
+    std::shared_ptr<Table> PartitionedTable::PartitionOf(RID rid) const {
+        size_t partition = GetRIDPartition(rid);
+        if (partition >= scheme_.partitions.size()) throw std::out_of_range("Invalid RID");
+        return GetPartition(partition);
+    }
+
+    RID PartitionedTable::InsertTuple(const std::vector<Field>& fields) {
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+        size_t partition = scheme_.Route(fields[scheme_.column_index]);
+        return MakePartitionRID(partition, GetPartition(partition)->InsertTuple(fields));
+    }
+
+    void PartitionedTable::InsertTuples(const std::vector<std::vector<Field>>& rows) {
+        std::vector<std::vector<std::vector<Field>>> parts(scheme_.partitions.size());
+        for (const auto& fields : rows) {
+            if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+            parts[scheme_.Route(fields[scheme_.column_index])].push_back(fields);
+        }
+        for (size_t partition = 0; partition < parts.size(); ++partition) {
+            if (!parts[partition].empty()) GetPartition(partition)->InsertTuples(parts[partition]);
+        }
+    }
+
+    void PartitionedTable::InsertTupleAt(RID rid, const std::vector<Field>& fields) {
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+        if (scheme_.Route(fields[scheme_.column_index]) != GetRIDPartition(rid)) {
+            throw std::invalid_argument("Row does not belong to the partition of its RID");
+        }
+        PartitionOf(rid)->InsertTupleAt(GetPartitionLocalRID(rid), fields);
+    }
+
+    bool PartitionedTable::RemoveTuple(RID rid) {
+        if (GetRIDPartition(rid) >= scheme_.partitions.size()) return false;
+        return PartitionOf(rid)->RemoveTuple(GetPartitionLocalRID(rid));
+    }
+
+    bool PartitionedTable::UpdateTuple(RID rid, const std::vector<Field>& fields) {
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+        if (GetRIDPartition(rid) >= scheme_.partitions.size()) return false;
+        if (scheme_.Route(fields[scheme_.column_index]) != GetRIDPartition(rid)) {
+            throw std::invalid_argument("Update would move the row to another partition");
+        }
+        return PartitionOf(rid)->UpdateTuple(GetPartitionLocalRID(rid), fields);
+    }
+
+    std::vector<RID> PartitionedTable::GetAllRID() const {
+        std::vector<RID> rids;
+        for (size_t partition = 0; partition < scheme_.partitions.size(); ++partition) {
+            for (RID rid : GetPartition(partition)->GetAllRID()) rids.push_back(MakePartitionRID(partition, rid));
+        }
+        return rids;
+    }
+
+    void PartitionedTable::Scan(const std::vector<size_t>& column_indexes, const ColumnPredicate* predicate,
+                                const std::function<void(const ColumnBatch&)>& consumer) const {
+        for (size_t partition : scheme_.Prune(predicate)) {
+            GetPartition(partition)->Scan(column_indexes, predicate, [&](const ColumnBatch& batch) {
+                if (partition == 0) return consumer(batch);
+                ColumnBatch tagged = batch;
+                for (RID& rid : tagged.rids) rid = MakePartitionRID(partition, rid);
+                consumer(tagged);
+            });
+        }
+    }
+
+    TableStorage PartitionedTable::GetStorage() const {
+        return storage_;
+    }
+
+    VacuumStats PartitionedTable::Vacuum() {
+        VacuumStats total;
+        for (size_t partition = 0; partition < scheme_.partitions.size(); ++partition) {
+            VacuumStats stats = GetPartition(partition)->Vacuum();
+            total.bytes_reclaimed += stats.bytes_reclaimed;
+            total.blocks_freed += stats.blocks_freed;
+            total.tuples_moved += stats.tuples_moved;
+        }
+        return total;
+    }
+
+    void PartitionedTable::BeginBulkLoad() {
+        for (size_t partition = 0; partition < scheme_.partitions.size(); ++partition) GetPartition(partition)->BeginBulkLoad();
+    }
+
+    void PartitionedTable::EndBulkLoad() {
+        for (size_t partition = 0; partition < scheme_.partitions.size(); ++partition) GetPartition(partition)->EndBulkLoad();
+    }
+
+    size_t PartitionedTable::GetRowCount() const {
+        size_t count = 0;
+        for (size_t partition = 0; partition < scheme_.partitions.size(); ++partition) count += GetPartition(partition)->GetRowCount();
+        return count;
+    }
+
+    std::vector<Field> PartitionedTable::ReadFields(RID rid) const {
+        auto tuple = PartitionOf(rid)->GetTuple(GetPartitionLocalRID(rid));
+        std::vector<Field> fields;
+        fields.reserve(schema_.GetColumnCount());
+        for (size_t i = 0; i < schema_.GetColumnCount(); ++i) fields.push_back(tuple->GetField(i));
+        return fields;
+    }
+}
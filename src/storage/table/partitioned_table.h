@@ -0,0 +1,115 @@
+#pragma once
+
+#include "table.h"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace storage {
+    enum class PartitionStrategy : uint8_t {
+        RANGE,
+        HASH
+    };
+
+    struct PartitionDefinition {
+        std::string name;
+        // RANGE: the partition holds the values below upper_bound and at or above the previous
+        // partition's bound; no bound (MAXVALUE) takes everything above. HASH: unused.
+        std::optional<Field> upper_bound;
+    };
+
+    /*
+     * How rows of a partitioned table are spread over its partitions, by the value of one column.
+     * RANGE partitions are ordered by strictly ascending bounds and only the last may be MAXVALUE.
+     * HASH partition i holds the values whose hash modulo the partition count is i; the hash only
+     * depends on the value's bytes, so rows land in the same partition across restarts.
+     */
+    struct PartitionScheme {
+        static constexpr size_t MAX_PARTITIONS = 1 << 16;
+
+        PartitionStrategy strategy = PartitionStrategy::RANGE;
+        size_t column_index = 0;
+        std::vector<PartitionDefinition> partitions;
+
+        // Checks the scheme against the table schema, converting integer bounds of a DOUBLE column.
+        void Validate(const Schema& schema);
+        // The partition a row with this partition column value belongs to.
+        [[nodiscard]] size_t Route(const Field& value) const;
+        // The partitions that may hold rows matching the predicate, in partition order.
+        [[nodiscard]] std::vector<size_t> Prune(const ColumnPredicate* predicate) const;
+        [[nodiscard]] std::optional<size_t> FindPartition(const std::string& name) const;
+
+        void Serialize(std::string& out) const;
+        static PartitionScheme Deserialize(const std::string& data, const Schema& schema);
+    };
+
+    // Text form of a RANGE bound as kept in the system tables; MAXVALUE is the empty string.
+    std::string FormatPartitionBound(const std::optional<Field>& bound);
+    std::optional<Field> ParsePartitionBound(const std::string& text, DataType type);
+
+    // A partition's own RIDs leave bits 16..31 zero (slots and rows within a group are 16-bit),
+    // so a partitioned table keeps the partition number there.
+    inline RID MakePartitionRID(size_t partition, RID rid) {
+        return rid | (static_cast<RID>(partition) << 16);
+    }
+
+    inline size_t GetRIDPartition(RID rid) {
+        return static_cast<size_t>((rid >> 16) & 0xFFFFu);
+    }
+
+    inline RID GetPartitionLocalRID(RID rid) {
+        return rid & ~(static_cast<RID>(0xFFFFu) << 16);
+    }
+
+    /*
+     * A table split into partitions that are tables of their own, named <table>.<partition>:
+     * each one is logged, checkpointed, loaded and indexed by itself, and dropping one only
+     * releases its storage. This table routes rows to them and holds no rows itself.
+     * Partitions are looked up through the resolver on first use, so partitions a query
+     * prunes are never loaded from their snapshot.
+     */
+    class PartitionedTable : public Table {
+    public:
+        using Resolver = std::function<std::shared_ptr<Table>(const std::string& table_name)>;
+
+        PartitionedTable(const Schema& schema, std::string table_name, TableStorage storage, PartitionScheme scheme,
+                         Resolver resolver, std::shared_ptr<BufferPoolManager> buffer_pool = nullptr);
+
+        static std::string PartitionTableName(const std::string& table_name, const std::string& partition_name) {
+            return table_name + "." + partition_name;
+        }
+
+        [[nodiscard]] const PartitionScheme& GetScheme() const { return scheme_; }
+        [[nodiscard]] size_t GetPartitionCount() const { return scheme_.partitions.size(); }
+        [[nodiscard]] std::shared_ptr<Table> GetPartition(size_t partition) const;
+
+        RID InsertTuple(const std::vector<Field>& fields) override;
+        // Splits the batch by partition and inserts each part as one batch.
+        void InsertTuples(const std::vector<std::vector<Field>>& rows) override;
+        void InsertTupleAt(RID rid, const std::vector<Field>& fields) override;
+        bool RemoveTuple(RID rid) override;
+        // Rows do not move between partitions: an update of the partition column must keep the row
+        // in its partition.
+        bool UpdateTuple(RID rid, const std::vector<Field>& fields) override;
+        [[nodiscard]] std::vector<RID> GetAllRID() const override;
+        // Scans the partitions the predicate does not prune, one after another.
+        void Scan(const std::vector<size_t>& column_indexes, const ColumnPredicate* predicate,
+                  const std::function<void(const ColumnBatch&)>& consumer) const override;
+        [[nodiscard]] TableStorage GetStorage() const override;
+        VacuumStats Vacuum() override;
+        void BeginBulkLoad() override;
+        void EndBulkLoad() override;
+        [[nodiscard]] size_t GetRowCount() const override;
+
+    protected:
+        [[nodiscard]] std::vector<Field> ReadFields(RID rid) const override;
+
+    private:
+        TableStorage storage_;
+        PartitionScheme scheme_;
+        Resolver resolver_;
+
+        [[nodiscard]] std::shared_ptr<Table> PartitionOf(RID rid) const;
+    };
+}
@@ -0,0 +1,131 @@
+#include "row_writer.h"
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+
+namespace storage {
+    RowWriter::RowWriter(const std::string& file_name, const Schema& schema, ExportOptions options)
+            : file_name_(file_name), options_(options), special_characters_({options.delimiter, '"', '\n', '\r'}) {
+        if (options_.delimiter == '"' || options_.delimiter == '\n' || options_.delimiter == '\r') {
+            throw std::invalid_argument("Invalid CSV delimiter");
+        }
+        for (const auto& column : schema.GetColumns()) types_.push_back(column.type);
+
+        file_.open(file_name, std::ios::binary | std::ios::trunc);
+        if (!file_) throw std::runtime_error("Cannot open file: " + file_name);
+        buffer_.reserve(BUFFER_SIZE);
+        WriteHeader(schema);
+    }
+
+    void RowWriter::WriteHeader(const Schema& schema) {
+        if (options_.format == ExportFormat::BINARY) {
+            auto column_count = static_cast<uint32_t>(types_.size());
+            buffer_.append("ROWS");
+            buffer_.append(reinterpret_cast<const char*>(&column_count), sizeof(column_count));
+            for (const auto& column : schema.GetColumns()) {
+                if (column.name.size() > UINT16_MAX) throw std::invalid_argument("Column name is too long");
+                auto type = static_cast<uint8_t>(column.type);
+                auto length = static_cast<uint16_t>(column.name.size());
+                buffer_.append(reinterpret_cast<const char*>(&type), sizeof(type));
+                buffer_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                buffer_.append(column.name);
+            }
+            return;
+        }
+        if (!options_.header) return;
+        for (size_t column = 0; column < types_.size(); ++column) {
+            Append(std::string_view(schema.GetColumn(column).name));
+            EndField(column);
+        }
+        buffer_.push_back('\n');
+    }
+
+    void RowWriter::WriteBatch(const ColumnBatch& batch) {
+        if (batch.columns.size() != types_.size()) throw std::invalid_argument("Batch columns do not match the export schema");
+        for (size_t row = 0; row < batch.Size(); ++row) {
+            for (size_t column = 0; column < batch.columns.size(); ++column) {
+                std::visit([&](const auto& values) {
+                    using VectorType = std::decay_t<decltype(values)>;
+                    if constexpr (std::is_same_v<VectorType, DictionaryVector>) {
+                        Append(values.dictionary->values[values.codes[row]]);
+                    } else {
+                        Append(values[row]);
+                    }
+                }, batch.columns[column]);
+                EndField(column);
+            }
+            EndRow();
+        }
+    }
+
+    void RowWriter::WriteTuple(const Tuple& tuple) {
+        if (tuple.GetSchema().GetColumnCount() != types_.size()) throw std::invalid_argument("Tuple does not match the export schema");
+        for (size_t column = 0; column < types_.size(); ++column) {
+            std::visit([&](const auto& value) { Append(value); }, tuple.GetField(column));
+            EndField(column);
+        }
+        EndRow();
+    }
+
+    void RowWriter::Close() {
+        Flush();
+        file_.close();
+        if (file_.fail()) throw std::runtime_error("Failed to write file: " + file_name_);
+    }
+
+    void RowWriter::Append(int value) {
+        if (options_.format == ExportFormat::BINARY) {
+            buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            return;
+        }
+        char text[16];
+        auto [end, error] = std::to_chars(text, text + sizeof(text), value);
+        buffer_.append(text, end);
+    }
+
+    void RowWriter::Append(double value) {
+        if (options_.format == ExportFormat::BINARY) {
+            buffer_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            return;
+        }
+        char text[32];
+        auto [end, error] = std::to_chars(text, text + sizeof(text), value);
+        buffer_.append(text, end);
+    }
+
+    void RowWriter::Append(std::string_view value) {
+        if (options_.format == ExportFormat::BINARY) {
+            if (value.size() > UINT16_MAX) throw std::invalid_argument("VARCHAR value is too long");
+            auto length = static_cast<uint16_t>(value.size());
+            buffer_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            buffer_.append(value);
+            return;
+        }
+        if (value.find_first_of(special_characters_) == std::string_view::npos) {
+            buffer_.append(value);
+            return;
+        }
+        buffer_.push_back('"');
+        for (char c : value) {
+            if (c == '"') buffer_.push_back('"');
+            buffer_.push_back(c);
+        }
+        buffer_.push_back('"');
+    }
+
+    void RowWriter::EndField(size_t column) {
+        if (options_.format == ExportFormat::CSV && column + 1 < types_.size()) buffer_.push_back(options_.delimiter);
+    }
+
+    void RowWriter::EndRow() {
+        if (options_.format == ExportFormat::CSV) buffer_.push_back('\n');
+        ++row_count_;
+        if (buffer_.size() >= BUFFER_SIZE) Flush();
+    }
+
+    void RowWriter::Flush() {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+        if (!file_) throw std::runtime_error("Failed to write file: " + file_name_);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "column_batch.h"
+#include "schema.h"
+#include "tuple.h"
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace storage {
+    enum class ExportFormat : uint8_t {
+        CSV,
+        BINARY
+    };
+
+    struct ExportOptions {
+        ExportFormat format = ExportFormat::CSV;
+        char delimiter = ',';
+        // CSV only: start with a line of column names.
+        bool header = false;
+    };
+
+    /*
+     * Streams rows into a file through one large buffer that is written out whenever it fills up,
+     * so exports run in constant memory however many rows they hold. Numbers are formatted with
+     * to_chars, doubles in the shortest form that reads back to the same value.
+     * CSV strings are quoted only when they hold the delimiter, a quote or a line break.
+     * BINARY starts with "ROWS", the column count (32-bit) and every column's type (8-bit) and
+     * name (16-bit length and bytes); the rows follow back to back, fields encoded as by
+     * TupleSerializer.
+     */
+    class RowWriter {
+    public:
+        static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+        RowWriter(const std::string& file_name, const Schema& schema, ExportOptions options = {});
+
+        // Writes every row of a batch whose columns are the schema's columns, in order.
+        void WriteBatch(const ColumnBatch& batch);
+        void WriteTuple(const Tuple& tuple);
+        // Writes out the buffer and closes the file; throws if any write failed.
+        void Close();
+
+        [[nodiscard]] size_t GetRowCount() const { return row_count_; }
+
+    private:
+        std::string file_name_;
+        std::vector<DataType> types_;
+        ExportOptions options_;
+        // Characters that make a CSV string quoted.
+        std::string special_characters_;
+        std::ofstream file_;
+        std::string buffer_;
+        size_t row_count_ = 0;
+
+        void WriteHeader(const Schema& schema);
+        void Append(int value);
+        void Append(double value);
+        void Append(std::string_view value);
+        void EndField(size_t column);
+        void EndRow();
+        void Flush();
+    };
+}
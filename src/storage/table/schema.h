@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,4 +51,30 @@ namespace storage {
     private:
         std::vector<Column> columns_;
     };
+
+    // Schemas are immutable once built, and tuples share them through a SchemaRef.
+    using SchemaRef = std::shared_ptr<const Schema>;
+
+    // Returns the single shared instance of schemas with these columns, so every table and operator
+    // producing the same columns hands out one object. An instance is freed once nothing refers to it.
+    inline SchemaRef InternSchema(const Schema& schema) {
+        using Key = std::vector<std::pair<std::string, DataType>>;
+        static std::mutex mutex;
+        static std::map<Key, std::weak_ptr<const Schema>> interned;
+
+        Key key;
+        key.reserve(schema.GetColumnCount());
+        for (const auto& column : schema.GetColumns()) key.emplace_back(column.name, column.type);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = interned.find(key); it != interned.end()) {
+            if (auto existing = it->second.lock()) return existing;
+        }
+        for (auto it = interned.begin(); it != interned.end();) {
+            it = it->second.expired() ? interned.erase(it) : std::next(it);
+        }
+        auto created = std::make_shared<const Schema>(schema);
+        interned[std::move(key)] = created;
+        return created;
+    }
 }
@@ -12,6 +12,7 @@ namespace storage {
     struct TableRecord {
         int table_id;
         std::string table_name;
+        int storage;
     };
 
     struct ColumnRecord {
@@ -25,6 +26,10 @@ namespace storage {
         int index_id;
         std::string index_name;
         int table_id;
+        // An IndexType value.
+        int index_type;
+        // The index columns at ordinal positions past this one are included columns rather than key columns.
+        int key_column_count;
     };
 
     struct IndexColumnRecord {
@@ -33,10 +38,25 @@ namespace storage {
         int ordinal_position;
     };
 
+    struct PartitionedTableRecord {
+        int table_id;
+        int strategy;
+        int column_id;
+    };
+
+    // A partition is a table of its own; table_id is the partition's, parent_table_id the partitioned table's.
+    struct PartitionRecord {
+        int table_id;
+        int parent_table_id;
+        std::string partition_name;
+        int ordinal_position;
+        std::string upper_bound;
+    };
+
     template<typename RecordType>
     class GenericSystemTable : public SystemTable {
     public:
-        explicit GenericSystemTable(const Schema& schema);
+        explicit GenericSystemTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool = nullptr);
         ~GenericSystemTable() = default;
 
         RID AddRecord(const RecordType& record);
@@ -51,8 +71,8 @@ namespace storage {
     };
 
     template<typename RecordType>
-    GenericSystemTable<RecordType>::GenericSystemTable(const Schema& schema)
-            : SystemTable(schema) {}
+    GenericSystemTable<RecordType>::GenericSystemTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool)
+            : SystemTable(schema, std::move(buffer_pool)) {}
 
     template<typename RecordType>
     RID GenericSystemTable<RecordType>::AddRecord(const RecordType &record) {
@@ -73,6 +93,8 @@ namespace storage {
                 return (r.index_id == record.index_id &&
                         r.column_id == record.column_id &&
                         r.ordinal_position == record.ordinal_position);
+            } else if constexpr (std::is_same_v<RecordType, PartitionedTableRecord> || std::is_same_v<RecordType, PartitionRecord>) {
+                return r.table_id == record.table_id;
             } else {
                 return false;
             }
@@ -82,8 +104,8 @@ namespace storage {
     template<typename RecordType>
     bool GenericSystemTable<RecordType>::RemoveRecords(const std::function<bool(const RecordType&)>& predicate) {
         std::vector<RID> rids_to_delete;
-        for (const auto& [rid, tuple] : tuples_) {
-            RecordType rec = FieldsToRecord(tuple);
+        for (RID rid : GetAllRID()) {
+            RecordType rec = FieldsToRecord(GetTuple(rid));
             if (predicate(rec)) {
                 rids_to_delete.push_back(rid);
             }
@@ -101,8 +123,8 @@ namespace storage {
     template<typename RecordType>
     std::vector<RecordType> GenericSystemTable<RecordType>::GetAllRecords() const {
         std::vector<RecordType> records;
-        for (const auto& [rid, tuple] : tuples_) {
-            records.push_back(FieldsToRecord(tuple));
+        for (RID rid : GetAllRID()) {
+            records.push_back(FieldsToRecord(GetTuple(rid)));
         }
         return records;
     }
@@ -110,8 +132,8 @@ namespace storage {
     template<typename RecordType>
     std::vector<RecordType> GenericSystemTable<RecordType>::FindRecords(const std::function<bool(const RecordType&)>& predicate) const {
         std::vector<RecordType> records;
-        for (const auto& [rid, tuple] : tuples_) {
-            RecordType record = FieldsToRecord(tuple);
+        for (RID rid : GetAllRID()) {
+            RecordType record = FieldsToRecord(GetTuple(rid));
             if (predicate(record)) {
                 records.push_back(record);
             }
@@ -121,7 +143,7 @@ namespace storage {
 
     template<>
     inline std::vector<Field> GenericSystemTable<TableRecord>::RecordToFields(const TableRecord& record) const {
-        return {record.table_id, record.table_name};
+        return {record.table_id, record.table_name, record.storage};
     }
 
     template<>
@@ -129,6 +151,7 @@ namespace storage {
         TableRecord record;
         record.table_id = std::get<int>(tuple->GetField(0));
         record.table_name = std::get<std::string>(tuple->GetField(1));
+        record.storage = std::get<int>(tuple->GetField(2));
         return record;
     }
 
@@ -149,7 +172,7 @@ namespace storage {
 
     template<>
     inline std::vector<Field> GenericSystemTable<IndexRecord>::RecordToFields(const IndexRecord& record) const {
-        return {record.index_id, record.index_name, record.table_id};
+        return {record.index_id, record.index_name, record.table_id, record.index_type, record.key_column_count};
     }
 
     template<>
@@ -158,6 +181,8 @@ namespace storage {
         record.index_id = std::get<int>(tuple->GetField(0));
         record.index_name = std::get<std::string>(tuple->GetField(1));
         record.table_id = std::get<int>(tuple->GetField(2));
+        record.index_type = std::get<int>(tuple->GetField(3));
+        record.key_column_count = std::get<int>(tuple->GetField(4));
         return record;
     }
 
@@ -175,4 +200,33 @@ namespace storage {
         return record;
     }
 
+    template<>
+    inline std::vector<Field> GenericSystemTable<PartitionedTableRecord>::RecordToFields(const PartitionedTableRecord& record) const {
+        return {record.table_id, record.strategy, record.column_id};
+    }
+
+    template<>
+    inline PartitionedTableRecord GenericSystemTable<PartitionedTableRecord>::FieldsToRecord(const std::shared_ptr<Tuple>& tuple) const {
+        PartitionedTableRecord record;
+        record.table_id = std::get<int>(tuple->GetField(0));
+        record.strategy = std::get<int>(tuple->GetField(1));
+        record.column_id = std::get<int>(tuple->GetField(2));
+        return record;
+    }
+
+    template<>
+    inline std::vector<Field> GenericSystemTable<PartitionRecord>::RecordToFields(const PartitionRecord& record) const {
+        return {record.table_id, record.parent_table_id, record.partition_name, record.ordinal_position, record.upper_bound};
+    }
+
+    template<>
+    inline PartitionRecord GenericSystemTable<PartitionRecord>::FieldsToRecord(const std::shared_ptr<Tuple>& tuple) const {
+        PartitionRecord record;
+        record.table_id = std::get<int>(tuple->GetField(0));
+        record.parent_table_id = std::get<int>(tuple->GetField(1));
+        record.partition_name = std::get<std::string>(tuple->GetField(2));
+        record.ordinal_position = std::get<int>(tuple->GetField(3));
+        record.upper_bound = std::get<std::string>(tuple->GetField(4));
+        return record;
+    }
 }
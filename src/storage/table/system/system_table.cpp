@@ -2,7 +2,8 @@
 
 namespace storage {
 
-    SystemTable::SystemTable(const Schema& schema) : Table(schema) {}
+    SystemTable::SystemTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool)
+            : Table(schema, std::move(buffer_pool)) {}
 
     RID SystemTable::InsertTuple(const std::vector<Field>& fields) {
         throw std::runtime_error("Cannot insert into system table directly");
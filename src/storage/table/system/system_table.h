@@ -5,7 +5,7 @@
 namespace storage {
     class SystemTable : public Table {
     public:
-        explicit SystemTable(const Schema& schema);
+        explicit SystemTable(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool = nullptr);
         ~SystemTable() = default;
 
         RID InsertTuple(const std::vector<Field> &fields) override;
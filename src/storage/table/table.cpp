@@ -1,33 +1,177 @@
 #include "table.h"
 #include "schema.h"
+#include "tuple_serializer.h"
+#include "table_file.h"
+#include "parallel_sort.h"
 #include <stdexcept>
 #include <iostream>
+#include <numeric>
 
 namespace storage {
-    template<typename KeyType>
-    void Table::CreateIndex(const std::string &name, size_t column_index, int degree) {
-        if (indexes_.find(name) != indexes_.end()) throw std::invalid_argument("Index with the given name already exists");
-        if (column_index >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+    namespace {
+        // Index is BPlusIndex or HashIndex; both take the same Insert and Remove.
+        template<template<typename> class Index, typename KeyType>
+        void InsertEntry(Index<KeyType>& index, const Field& key, RID rid) {
+            index.Insert(std::get<KeyType>(key), rid);
+        }
 
-        DataType data_type = schema_.GetColumn(column_index).type;
-        if ((data_type == DataType::INTEGER && !std::is_same<KeyType, int>::value) ||
-            (data_type == DataType::DOUBLE && !std::is_same<KeyType, double>::value) ||
-            (data_type == DataType::VARCHAR && !std::is_same<KeyType, std::string>::value)) {
-            throw std::invalid_argument("KeyType does not match column data type");
+        template<template<typename> class Index, typename KeyType>
+        void RemoveEntry(Index<KeyType>& index, const Field& key, RID rid) {
+            index.Remove(std::get<KeyType>(key), rid);
+        }
+
+        // Calls apply with the row's entry key in an index on columns, without copying a single-column key.
+        template<typename Apply>
+        void WithIndexKey(const std::vector<size_t>& columns, const std::vector<Field>& fields, Apply&& apply) {
+            if (columns.size() == 1) apply(fields[columns.front()]);
+            else apply(MakeIndexKey(columns, fields));
         }
 
-        auto index = std::make_shared<BPlusIndex<KeyType>>(degree);
+        template<typename KeyType>
+        IndexVariant MakeIndex(IndexType type, int degree, const std::vector<std::pair<KeyType, RID>>& entries) {
+            if (type == IndexType::HASH) {
+                auto index = std::make_shared<HashIndex<KeyType>>();
+                index->BulkLoad(entries);
+                return IndexVariant{std::in_place_type<std::shared_ptr<HashIndex<KeyType>>>, index};
+            }
+            auto index = std::make_shared<BPlusIndex<KeyType>>(degree);
+            index->BulkLoad(entries);
+            return IndexVariant{std::in_place_type<std::shared_ptr<BPlusIndex<KeyType>>>, index};
+        }
+    }
 
-        for (const auto& [rid, tuple] : tuples_) {
-            const Field& field = tuple->GetField(column_index);
-            KeyType key = std::get<KeyType>(field);
-            index->Insert(key, rid);
+    Table::Table(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool)
+            : shared_schema_(InternSchema(schema)), schema_(*shared_schema_), buffer_pool_(std::move(buffer_pool)), tuple_count_(0) {
+        if (!buffer_pool_) {
+            buffer_pool_ = std::make_shared<BufferPoolManager>(PRIVATE_BUFFER_POOL_SIZE, std::make_shared<DiskManager>(""));
+        }
+    }
+
+    Table::~Table() {
+        for (PageId page_id : page_ids_) buffer_pool_->DeletePage(page_id);
+    }
+
+    DataType Table::IndexKeyType(const std::vector<size_t> &column_indexes) const {
+        return column_indexes.size() == 1 ? schema_.GetColumn(column_indexes.front()).type : DataType::VARCHAR;
+    }
+
+    void Table::CreateIndex(const std::string &name, const std::vector<size_t> &key_columns, int degree, IndexType type,
+                            const std::vector<size_t> &include_columns) {
+        if (key_columns.empty()) throw std::invalid_argument("Index needs at least one column");
+        // A hash index is probed with the whole key, which included values would be part of.
+        if (type == IndexType::HASH && !include_columns.empty()) throw std::invalid_argument("Only B+tree indexes can include columns");
+        std::vector<size_t> column_indexes = key_columns;
+        column_indexes.insert(column_indexes.end(), include_columns.begin(), include_columns.end());
+        for (size_t i = 0; i < column_indexes.size(); ++i) {
+            if (column_indexes[i] >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+            if (std::find(column_indexes.begin(), column_indexes.begin() + i, column_indexes[i]) != column_indexes.begin() + i) {
+                throw std::invalid_argument("Column appears twice in index: " + schema_.GetColumn(column_indexes[i]).name);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            if (indexes_.find(name) != indexes_.end() || building_indexes_.find(name) != building_indexes_.end()) {
+                throw std::invalid_argument("Index with the given name already exists");
+            }
+            building_indexes_[name] = IndexBuild{column_indexes, {}};
+        }
+        try {
+            switch (IndexKeyType(column_indexes)) {
+                case DataType::INTEGER:
+                    BuildIndex<int>(name, column_indexes, key_columns.size(), degree, type);
+                    break;
+                case DataType::DOUBLE:
+                    BuildIndex<double>(name, column_indexes, key_columns.size(), degree, type);
+                    break;
+                case DataType::VARCHAR:
+                    BuildIndex<std::string>(name, column_indexes, key_columns.size(), degree, type);
+                    break;
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(latch_);
+            building_indexes_.erase(name);
+            throw;
         }
-        IndexVariant index_variant{std::in_place_type<std::shared_ptr<BPlusIndex<KeyType>>>, index};
-        IndexInfo index_info{column_index, data_type, index_variant};
+    }
+
+    template<typename KeyType>
+    void Table::BuildIndex(const std::string &name, const std::vector<size_t> &column_indexes, size_t key_column_count, int degree,
+                           IndexType type) {
+        // The entries are read with a column scan; a B+tree sorts them on all cores and is packed bottom-up.
+        std::vector<std::pair<KeyType, RID>> entries;
+        entries.reserve(GetRowCount());
+        Scan(column_indexes, nullptr, [&entries](const ColumnBatch& batch) {
+            if (batch.columns.size() > 1) {
+                if constexpr (std::is_same_v<KeyType, std::string>) {
+                    std::string key;
+                    for (size_t row = 0; row < batch.Size(); ++row) {
+                        key.clear();
+                        for (const auto& column : batch.columns) {
+                            std::visit([&](const auto& values) {
+                                if constexpr (std::is_same_v<std::decay_t<decltype(values)>, DictionaryVector>) {
+                                    index_key::Append(values.dictionary->values[values.codes[row]], key);
+                                } else {
+                                    index_key::Append(values[row], key);
+                                }
+                            }, column);
+                        }
+                        entries.emplace_back(key, batch.rids[row]);
+                    }
+                }
+                return;
+            }
+            std::visit([&](const auto& values) {
+                using VectorType = std::decay_t<decltype(values)>;
+                for (size_t row = 0; row < batch.Size(); ++row) {
+                    if constexpr (std::is_same_v<VectorType, DictionaryVector>) {
+                        if constexpr (std::is_same_v<KeyType, std::string>) {
+                            entries.emplace_back(values.dictionary->values[values.codes[row]], batch.rids[row]);
+                        }
+                    } else if constexpr (std::is_same_v<typename VectorType::value_type, KeyType>) {
+                        entries.emplace_back(values[row], batch.rids[row]);
+                    }
+                }
+            }, batch.columns.front());
+        });
+        if (type == IndexType::BTREE) common::ParallelSort(entries);
+        IndexVariant index_variant = MakeIndex(type, degree, entries);
+
+        // A row the scan saw may also have a collected change, so an added entry replaces any equal one.
+        std::lock_guard<std::mutex> lock(latch_);
+        auto build = building_indexes_.find(name);
+        std::visit([&](const auto& index) {
+            for (const auto& change : build->second.changes) {
+                RemoveEntry(*index, change.key, change.rid);
+                if (change.inserted) InsertEntry(*index, change.key, change.rid);
+            }
+        }, index_variant);
+        building_indexes_.erase(build);
+        IndexInfo index_info{column_indexes, key_column_count, IndexKeyType(column_indexes), degree, type, index_variant};
         indexes_[name] = index_info;
     }
 
+    template<typename KeyType>
+    void Table::RestoreIndex(const TableFileIndex &definition, const std::vector<std::pair<KeyType, RID>> &sorted_entries) {
+        auto columns = definition.StoredColumns();
+        if (definition.column_indexes.empty() || *std::max_element(columns.begin(), columns.end()) >= schema_.GetColumnCount() ||
+            IndexKeyType(columns) != definition.data_type) {
+            throw std::runtime_error("Index definition does not match the table schema");
+        }
+        std::lock_guard<std::mutex> lock(latch_);
+        if (indexes_.find(definition.name) != indexes_.end()) throw std::invalid_argument("Index with the given name already exists");
+
+        IndexVariant index_variant = MakeIndex(definition.type, definition.degree, sorted_entries);
+        indexes_[definition.name] = IndexInfo{columns, definition.column_indexes.size(), definition.data_type, definition.degree,
+                                              definition.type, index_variant};
+    }
+
+    TableFileIndex Table::IndexDefinition(const std::string &name, const IndexInfo &index_info) {
+        auto key_end = index_info.column_indexes.begin() + static_cast<std::ptrdiff_t>(index_info.key_column_count);
+        return {name, {index_info.column_indexes.begin(), key_end}, index_info.data_type, index_info.degree, index_info.type,
+                {key_end, index_info.column_indexes.end()}};
+    }
+
     template<typename KeyType>
     std::shared_ptr<BPlusIndex<KeyType>> Table::GetIndex(const std::string &name) const {
         auto it = indexes_.find(name);
@@ -39,251 +183,563 @@ namespace storage {
             (data_type == DataType::VARCHAR && !std::is_same<KeyType, std::string>::value)) {
             throw std::invalid_argument("KeyType does not match index data type");
         }
+        if (it->second.type != IndexType::BTREE) throw std::invalid_argument("Index is not a B+tree index: " + name);
 
         return std::get<std::shared_ptr<BPlusIndex<KeyType>>>(it->second.index);
     }
 
+    template<typename KeyType>
+    std::shared_ptr<HashIndex<KeyType>> Table::GetHashIndex(const std::string &name) const {
+        auto it = indexes_.find(name);
+        if (it == indexes_.end()) throw std::invalid_argument("Index not found");
+        if (it->second.type != IndexType::HASH) throw std::invalid_argument("Index is not a hash index: " + name);
+
+        auto index = std::get_if<std::shared_ptr<HashIndex<KeyType>>>(&it->second.index);
+        if (!index) throw std::invalid_argument("KeyType does not match index data type");
+        return *index;
+    }
+
+    IndexType Table::GetIndexType(const std::string &name) const {
+        auto it = indexes_.find(name);
+        if (it == indexes_.end()) throw std::invalid_argument("Index not found");
+        return it->second.type;
+    }
+
+    const std::vector<size_t>& Table::GetIndexColumns(const std::string &name) const {
+        auto it = indexes_.find(name);
+        if (it == indexes_.end()) throw std::invalid_argument("Index not found");
+        return it->second.column_indexes;
+    }
+
+    size_t Table::GetIndexKeyColumnCount(const std::string &name) const {
+        auto it = indexes_.find(name);
+        if (it == indexes_.end()) throw std::invalid_argument("Index not found");
+        return it->second.key_column_count;
+    }
+
+    std::vector<TableFileIndex> Table::GetIndexDefinitions() const {
+        std::lock_guard<std::mutex> lock(latch_);
+        std::vector<TableFileIndex> definitions;
+        for (const auto& [name, index_info] : indexes_) {
+            definitions.push_back(IndexDefinition(name, index_info));
+        }
+        return definitions;
+    }
+
+    void Table::BeginBulkLoad() {
+        std::lock_guard<std::mutex> lock(latch_);
+        bulk_loading_ = true;
+    }
+
+    void Table::EndBulkLoad() {
+        std::lock_guard<std::mutex> lock(latch_);
+        bulk_loading_ = false;
+        for (auto& [name, entries] : bulk_index_entries_) {
+            auto it = indexes_.find(name);
+            if (it == indexes_.end()) continue;
+            std::sort(entries.begin(), entries.end());
+            std::visit([&](const auto& index) {
+                for (const auto& [key, rid] : entries) InsertEntry(*index, key, rid);
+            }, it->second.index);
+        }
+        bulk_index_entries_.clear();
+    }
+
     const Schema &Table::GetSchema() const {
         return schema_;
     }
 
     RID Table::InsertTuple(const std::vector<Field> &fields) {
-        RID rid = next_rid_++;
-        tuples_[rid] = std::make_shared<Tuple>(schema_, fields);
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
 
-        for (const auto& [name, index_info] : indexes_) {
-            size_t column_index = index_info.column_index;
-            const Field& field = fields[column_index];
-            DataType data_type = index_info.data_type;
-
-            if (data_type == DataType::INTEGER) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<int>>>(index_info.index);
-                int key = std::get<int>(field);
-                index->Insert(key, rid);
-            } else if (data_type == DataType::DOUBLE) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<double>>>(index_info.index);
-                double key = std::get<double>(field);
-                index->Insert(key, rid);
-            } else if (data_type == DataType::VARCHAR) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<std::string>>>(index_info.index);
-                std::string key = std::get<std::string>(field);
-                index->Insert(key, rid);
-            }
-        }
+        std::string buffer;
+        TupleSerializer::Serialize(schema_, fields, buffer);
+        if (buffer.size() > TablePage::MaxTupleSize()) throw std::invalid_argument("Tuple is too large to fit in a page");
+
+        std::lock_guard<std::mutex> lock(latch_);
+        RID rid = AppendTuple(buffer.data(), static_cast<uint16_t>(buffer.size()));
+        PageZone(GetRIDPageNumber(rid)).Add(fields);
+        InsertIntoIndexes(fields, rid);
+        Log(LogRecordType::INSERT, rid, std::move(buffer));
         return rid;
     }
 
-    std::shared_ptr<Tuple> Table::GetTuple(RID rid) const {
-        auto it = tuples_.find(rid);
-        if (it == tuples_.end()) throw std::out_of_range("Invalid RID");
-        return it->second;
+    void Table::InsertTuples(const std::vector<std::vector<Field>>& rows) {
+        std::vector<std::string> buffers(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+            TupleSerializer::Serialize(schema_, rows[i], buffers[i]);
+            if (buffers[i].size() > TablePage::MaxTupleSize()) throw std::invalid_argument("Tuple is too large to fit in a page");
+        }
+
+        std::lock_guard<std::mutex> lock(latch_);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            RID rid = AppendTuple(buffers[i].data(), static_cast<uint16_t>(buffers[i].size()));
+            PageZone(GetRIDPageNumber(rid)).Add(rows[i]);
+            InsertIntoIndexes(rows[i], rid);
+            Log(LogRecordType::INSERT, rid, std::move(buffers[i]));
+        }
     }
 
-    bool Table::RemoveTuple(RID rid) {
-        auto it = tuples_.find(rid);
-        if (it == tuples_.end()) return false;
+    void Table::InsertTupleAt(RID rid, const std::vector<Field> &fields) {
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
 
-        for (const auto& [name, index_info] : indexes_) {
-            size_t column_index = index_info.column_index;
-            const Field& field = it->second->GetField(column_index);
-            DataType data_type = index_info.data_type;
-
-            if (data_type == DataType::INTEGER) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<int>>>(index_info.index);
-                int key = std::get<int>(field);
-                index->Remove(key, rid);
-            } else if (data_type == DataType::DOUBLE) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<double>>>(index_info.index);
-                double key = std::get<double>(field);
-                index->Remove(key, rid);
-            } else if (data_type == DataType::VARCHAR) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<std::string>>>(index_info.index);
-                std::string key = std::get<std::string>(field);
-                index->Remove(key, rid);
+        std::string buffer;
+        TupleSerializer::Serialize(schema_, fields, buffer);
+        if (buffer.size() > TablePage::MaxTupleSize()) throw std::invalid_argument("Tuple is too large to fit in a page");
+
+        std::lock_guard<std::mutex> lock(latch_);
+        RestoreTuple(rid, buffer.data(), static_cast<uint16_t>(buffer.size()), &fields);
+        InsertIntoIndexes(fields, rid);
+        Log(LogRecordType::INSERT, rid, std::move(buffer));
+    }
+
+    void Table::InsertIntoIndexes(const std::vector<Field> &fields, RID rid) {
+        RecordBuildingIndexChanges(fields, rid, true);
+        if (bulk_loading_) {
+            for (const auto& [name, index_info] : indexes_) {
+                bulk_index_entries_[name].emplace_back(MakeIndexKey(index_info.column_indexes, fields), rid);
             }
+            return;
         }
-        tuples_.erase(it);
+        for (const auto& [name, index_info] : indexes_) {
+            WithIndexKey(index_info.column_indexes, fields, [&](const Field& key) {
+                std::visit([&](const auto& index) { InsertEntry(*index, key, rid); }, index_info.index);
+            });
+        }
+    }
+
+    void Table::RemoveFromIndexes(const std::vector<Field> &fields, RID rid) {
+        RecordBuildingIndexChanges(fields, rid, false);
+        for (const auto& [name, index_info] : indexes_) {
+            WithIndexKey(index_info.column_indexes, fields, [&](const Field& key) {
+                std::visit([&](const auto& index) { RemoveEntry(*index, key, rid); }, index_info.index);
+            });
+        }
+    }
+
+    void Table::RecordBuildingIndexChanges(const std::vector<Field> &fields, RID rid, bool inserted) {
+        for (auto& [name, build] : building_indexes_) {
+            WithIndexKey(build.column_indexes, fields, [&](const Field& key) { build.changes.push_back({inserted, key, rid}); });
+        }
+    }
+
+    RID Table::AppendTuple(const char *data, uint16_t size) {
+        SlotId slot;
+        size_t page_number;
+        if (auto hole = FindPageWithSpace(size, page_ids_.size())) {
+            page_number = *hole;
+            PageGuard guard = FetchTablePage(page_number);
+            PreserveForSnapshot(page_number, guard.GetData());
+            TablePage page(guard.GetData());
+            if (!page.InsertTuple(data, size, slot)) throw std::logic_error("Free space map is out of date");
+            guard.MarkDirty();
+            UpdateFreeSpace(page_number, page);
+        } else {
+            PageId page_id;
+            PageGuard guard = buffer_pool_->NewPageGuarded(page_id);
+            TablePage page(guard.GetData());
+            page.Init();
+            page.InsertTuple(data, size, slot);
+            guard.MarkDirty();
+            page_ids_.push_back(page_id);
+            page_number = page_ids_.size() - 1;
+            UpdateFreeSpace(page_number, page);
+        }
+        ++tuple_count_;
+        return MakeRID(page_number, slot);
+    }
+
+    void Table::RestoreTuple(RID rid, const char *data, uint16_t size, const std::vector<Field> *fields) {
+        size_t page_number = GetRIDPageNumber(rid);
+        while (page_ids_.size() <= page_number) {
+            PageId page_id;
+            PageGuard guard = buffer_pool_->NewPageGuarded(page_id);
+            TablePage new_page(guard.GetData());
+            new_page.Init();
+            guard.MarkDirty();
+            page_ids_.push_back(page_id);
+            UpdateFreeSpace(page_ids_.size() - 1, new_page);
+        }
+
+        PageGuard guard = FetchTablePage(page_number);
+        PreserveForSnapshot(page_number, guard.GetData());
+        TablePage page(guard.GetData());
+        if (!page.InsertTupleAt(GetRIDSlot(rid), data, size)) {
+            throw std::runtime_error("Tuple cannot be placed at its RID");
+        }
+        guard.MarkDirty();
+        UpdateFreeSpace(page_number, page);
+        // A snapshot load has no fields; it widens the zones from the column arrays of each block instead.
+        if (fields) PageZone(page_number).Add(*fields);
+        ++tuple_count_;
+    }
+
+    void Table::PreserveForSnapshot(size_t page_number, const char *page_data) {
+        if (!snapshot_ || page_number < snapshot_->pages_written || page_number >= snapshot_->page_count) return;
+        snapshot_->preserved_pages.try_emplace(page_number, page_data, PAGE_SIZE);
+    }
+
+    ZoneMap& Table::PageZone(size_t page_number) {
+        if (page_zones_.size() <= page_number) page_zones_.resize(page_number + 1);
+        return page_zones_[page_number];
+    }
+
+    void Table::UpdateFreeSpace(size_t page_number, const TablePage &page) {
+        if (page_free_space_.size() <= page_number) page_free_space_.resize(page_number + 1, 0);
+        pages_by_free_space_.erase({page_free_space_[page_number], page_number});
+        page_free_space_[page_number] = page.GetUsableSpace();
+        pages_by_free_space_.emplace(page_free_space_[page_number], page_number);
+    }
+
+    std::optional<size_t> Table::FindPageWithSpace(size_t size, size_t exclude) const {
+        for (auto it = pages_by_free_space_.lower_bound({size, 0}); it != pages_by_free_space_.end(); ++it) {
+            if (it->second != exclude) return it->second;
+        }
+        return std::nullopt;
+    }
+
+    PageGuard Table::FetchTablePage(size_t page_number) const {
+        if (page_number >= page_ids_.size()) throw std::out_of_range("Invalid RID");
+        return buffer_pool_->FetchPageGuarded(page_ids_[page_number]);
+    }
+
+    std::vector<Field> Table::ReadFields(RID rid) const {
+        PageGuard guard = FetchTablePage(GetRIDPageNumber(rid));
+        const char* data;
+        uint16_t size;
+        if (!TablePage(guard.GetData()).GetTuple(GetRIDSlot(rid), data, size)) throw std::out_of_range("Invalid RID");
+        return TupleSerializer::Deserialize(schema_, data, size);
+    }
+
+    std::shared_ptr<Tuple> Table::GetTuple(RID rid) const {
+        return std::make_shared<Tuple>(shared_schema_, ReadFields(rid), TYPE_CHECKED);
+    }
+
+    bool Table::RemoveTuple(RID rid) {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (GetRIDPageNumber(rid) >= page_ids_.size()) return false;
+        PageGuard guard = FetchTablePage(GetRIDPageNumber(rid));
+        TablePage page(guard.GetData());
+        if (!page.IsLive(GetRIDSlot(rid))) return false;
+        std::vector<Field> old_fields = ReadFields(rid);
+
+        RemoveFromIndexes(old_fields, rid);
+        PreserveForSnapshot(GetRIDPageNumber(rid), guard.GetData());
+        page.RemoveTuple(GetRIDSlot(rid));
+        guard.MarkDirty();
+        UpdateFreeSpace(GetRIDPageNumber(rid), page);
+        --tuple_count_;
+
+        if (page.GetTupleCount() == 0) PageZone(GetRIDPageNumber(rid)) = ZoneMap();
+        Log(LogRecordType::DELETE, rid);
         return true;
     }
 
     bool Table::UpdateTuple(RID rid, const std::vector<Field> &fields) {
-        auto it = tuples_.find(rid);
-        if (it == tuples_.end()) return false;
-
-        for (const auto& [name, index_info] : indexes_) {
-            size_t column_index = index_info.column_index;
-            const Field& old_field = it->second->GetField(column_index);
-            const Field& new_field = fields[column_index];
-            DataType data_type = index_info.data_type;
-
-            if (data_type == DataType::INTEGER) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<int>>>(index_info.index);
-                int old_key = std::get<int>(old_field);
-                int new_key = std::get<int>(new_field);
-                index->Remove(old_key, rid);
-                index->Insert(new_key, rid);
-            } else if (data_type == DataType::DOUBLE) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<double>>>(index_info.index);
-                double old_key = std::get<double>(old_field);
-                double new_key = std::get<double>(new_field);
-                index->Remove(old_key, rid);
-                index->Insert(new_key, rid);
-            } else if (data_type == DataType::VARCHAR) {
-                auto index = std::get<std::shared_ptr<BPlusIndex<std::string>>>(index_info.index);
-                std::string old_key = std::get<std::string>(old_field);
-                std::string new_key = std::get<std::string>(new_field);
-                index->Remove(old_key, rid);
-                index->Insert(new_key, rid);
-            }
+        std::lock_guard<std::mutex> lock(latch_);
+        if (GetRIDPageNumber(rid) >= page_ids_.size()) return false;
+        PageGuard guard = FetchTablePage(GetRIDPageNumber(rid));
+        TablePage page(guard.GetData());
+        if (!page.IsLive(GetRIDSlot(rid))) return false;
+        if (fields.size() != schema_.GetColumnCount()) throw std::invalid_argument("Number of fields doesn't match schema");
+        std::string buffer;
+        TupleSerializer::Serialize(schema_, fields, buffer);
+        if (buffer.size() > TablePage::MaxTupleSize()) throw std::invalid_argument("Tuple is too large to fit in a page");
+        std::vector<Field> old_fields = ReadFields(rid);
+
+        size_t page_number = GetRIDPageNumber(rid);
+        auto size = static_cast<uint16_t>(buffer.size());
+        PreserveForSnapshot(page_number, guard.GetData());
+        if (page.UpdateTuple(GetRIDSlot(rid), buffer.data(), size)) {
+            guard.MarkDirty();
+            UpdateFreeSpace(page_number, page);
+            guard.Release();
+            PageZone(page_number).Add(fields);
+
+            RemoveFromIndexes(old_fields, rid);
+            InsertIntoIndexes(fields, rid);
+            Log(LogRecordType::UPDATE, rid, std::move(buffer));
+            return true;
         }
-        it->second = std::make_shared<Tuple>(schema_, fields);
+
+        // The longer row does not fit in its page, so it moves to another one under a new RID, as in Vacuum.
+        page.RemoveTuple(GetRIDSlot(rid));
+        guard.MarkDirty();
+        UpdateFreeSpace(page_number, page);
+        if (page.GetTupleCount() == 0) PageZone(page_number) = ZoneMap();
+        guard.Release();
+        --tuple_count_;
+        RID new_rid = AppendTuple(buffer.data(), size);
+        PageZone(GetRIDPageNumber(new_rid)).Add(fields);
+
+        RemoveFromIndexes(old_fields, rid);
+        InsertIntoIndexes(fields, new_rid);
+        Log(LogRecordType::DELETE, rid);
+        Log(LogRecordType::INSERT, new_rid, std::move(buffer));
         return true;
     }
 
     std::vector<RID> Table::GetAllRID() const {
         std::vector<RID> rids;
-        for (const auto& [rid, tuple] : tuples_) rids.push_back(rid);
+        rids.reserve(tuple_count_);
+        for (size_t page_number = 0; page_number < page_ids_.size(); ++page_number) {
+            PageGuard guard = FetchTablePage(page_number);
+            TablePage page(guard.GetData());
+            for (SlotId slot = 0; slot < page.GetSlotCount(); ++slot) {
+                if (page.IsLive(slot)) rids.push_back(MakeRID(page_number, slot));
+            }
+        }
         return rids;
     }
 
-    size_t Table::GetRowCount() const {
-        return tuples_.size();
-    }
+    void Table::Scan(const std::vector<size_t> &column_indexes, const ColumnPredicate *predicate,
+                     const std::function<void(const ColumnBatch &)> &consumer) const {
+        // The predicate column is read as one more batch column and dropped before handing the batch out.
+        std::vector<size_t> scan_columns = column_indexes;
+        if (predicate) scan_columns.push_back(predicate->column_index);
+        for (size_t column_index : scan_columns) {
+            if (column_index >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+        }
 
-    void Table::SaveToFile(const std::string& file_name) const {
-        std::ofstream out(file_name);
-        if (!out) throw std::ios_base::failure("Failed to open file for writing");
-
-        out << "SCHEMA\n";
-        for (const auto& column : schema_.GetColumns()) out << column.name << "," << static_cast<int>(column.type) << "\n";
-
-        out << "DATA\n";
-        for (const auto& [rid, tuple] : tuples_) {
-            out << rid << ",";
-            for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
-                const Field& field = tuple->GetField(i);
-                if (std::holds_alternative<int>(field)) out << std::get<int>(field);
-                else if (std::holds_alternative<double>(field)) out << std::get<double>(field);
-                else if (std::holds_alternative<std::string>(field)) {
-                    std::string value = std::get<std::string>(field);
-                    if (value.find('"') != std::string::npos) {
-                        size_t pos = 0;
-                        while ((pos = value.find('"', pos)) != std::string::npos) {
-                            value.insert(pos, 1, '"');
-                            pos += 2;
-                        }
+        // Rows are stored whole, so every field up to the last scanned one has to be walked.
+        size_t fields_to_read = 0;
+        for (size_t column_index : scan_columns) fields_to_read = std::max(fields_to_read, column_index + 1);
+        std::vector<std::vector<size_t>> outputs(fields_to_read);
+        for (size_t i = 0; i < scan_columns.size(); ++i) outputs[scan_columns[i]].push_back(i);
+
+        // The latch is taken per page, as in Vacuum, so writers interleave with the scan; the consumer runs without it.
+        ColumnBatch batch;
+        std::vector<uint32_t> rows;
+        for (size_t page_number = 0;; ++page_number) {
+            std::unique_lock<std::mutex> lock(latch_);
+            if (page_number >= page_ids_.size()) break;
+            if (predicate) {
+                // A page without a zone map has never held a row.
+                if (page_number >= page_zones_.size() || page_zones_[page_number].columns.empty()) continue;
+                if (!predicate->MayMatch(page_zones_[page_number].columns[predicate->column_index])) continue;
+            }
+            batch.rids.clear();
+            batch.columns.clear();
+            for (size_t column_index : scan_columns) {
+                switch (schema_.GetColumn(column_index).type) {
+                    case DataType::INTEGER: batch.columns.emplace_back(std::vector<int>()); break;
+                    case DataType::DOUBLE: batch.columns.emplace_back(std::vector<double>()); break;
+                    case DataType::VARCHAR: batch.columns.emplace_back(std::vector<std::string>()); break;
+                }
+            }
+
+            PageGuard guard = FetchTablePage(page_number);
+            TablePage page(guard.GetData());
+            for (SlotId slot = 0; slot < page.GetSlotCount(); ++slot) {
+                const char* data;
+                uint16_t size;
+                if (!page.GetTuple(slot, data, size)) continue;
+                batch.rids.push_back(MakeRID(page_number, slot));
+                const char* end = data + size;
+                for (size_t column_index = 0; column_index < fields_to_read; ++column_index) {
+                    Field field = TupleSerializer::ReadField(schema_.GetColumn(column_index).type, data, end);
+                    for (size_t output : outputs[column_index]) {
+                        std::visit([&](auto& values) {
+                            using VectorType = std::decay_t<decltype(values)>;
+                            if constexpr (!std::is_same_v<VectorType, DictionaryVector>) {
+                                values.push_back(std::get<typename VectorType::value_type>(field));
+                            }
+                        }, batch.columns[output]);
                     }
-                    if (value.find(',') != std::string::npos || value.find('"') != std::string::npos) out << "\"" << value << "\"";
-                    else out << value;
                 }
-                if (i < schema_.GetColumnCount() - 1) out << ",";
             }
-            out << "\n";
+            guard.Release();
+            lock.unlock();
+            if (predicate) {
+                rows.resize(batch.Size());
+                std::iota(rows.begin(), rows.end(), 0);
+                predicate->Select(batch.columns.back(), rows);
+                batch.Retain(rows);
+                batch.columns.pop_back();
+            }
+            if (batch.Size() > 0) consumer(batch);
         }
+    }
 
-        out << "INDEXES\n";
-        for (const auto& [name, index_info] : indexes_) {
-            out << name << ",";
-            out << index_info.column_index << ",";
-            out << static_cast<int>(index_info.data_type) << "\n";
-        }
+    TableStorage Table::GetStorage() const {
+        return TableStorage::ROW;
+    }
 
-        out.close();
+    size_t Table::GetRowCount() const {
+        return tuple_count_;
     }
 
-    void Table::LoadFromFile(const std::string& file_name) {
-        std::ifstream in(file_name);
-        if (!in) throw std::ios_base::failure("Failed to open file for reading");
+    void Table::SetLogManager(std::shared_ptr<LogManager> log_manager, const std::string &table_name) {
+        log_manager_ = std::move(log_manager);
+        table_name_ = table_name;
+    }
+
+    void Table::Log(LogRecordType type, RID rid, std::string payload) {
+        if (!log_manager_) return;
+        LogRecord record;
+        record.type = type;
+        record.table_name = table_name_;
+        record.rid = rid;
+        record.payload = std::move(payload);
+        log_manager_->Append(record);
+    }
+
+    VacuumStats Table::Vacuum() {
+        VacuumStats stats;
+        for (size_t page_number = 0;; ++page_number) {
+            std::lock_guard<std::mutex> lock(latch_);
+            if (page_number >= page_ids_.size()) break;
+            PageGuard guard = FetchTablePage(page_number);
+            PreserveForSnapshot(page_number, guard.GetData());
+            TablePage page(guard.GetData());
+            stats.bytes_reclaimed += page.Vacuum();
+            guard.MarkDirty();
+            UpdateFreeSpace(page_number, page);
+        }
+
+        while (true) {
+            std::lock_guard<std::mutex> lock(latch_);
+            // A snapshot being written still reads pages by number, so none may go away under it.
+            if (snapshot_ || page_ids_.empty()) break;
+            size_t last = page_ids_.size() - 1;
+            PageGuard guard = FetchTablePage(last);
+            PreserveForSnapshot(last, guard.GetData());
+            TablePage page(guard.GetData());
+
+            for (SlotId slot = 0; slot < page.GetSlotCount(); ++slot) {
+                const char* data;
+                uint16_t size;
+                if (!page.GetTuple(slot, data, size)) continue;
+                auto target = FindPageWithSpace(size, last);
+                if (!target) break;
+
+                std::string payload(data, size);
+                std::vector<Field> fields = TupleSerializer::Deserialize(schema_, data, size);
+                PageGuard target_guard = FetchTablePage(*target);
+                PreserveForSnapshot(*target, target_guard.GetData());
+                TablePage target_page(target_guard.GetData());
+                SlotId target_slot;
+                if (!target_page.InsertTuple(payload.data(), size, target_slot)) throw std::logic_error("Free space map is out of date");
+                target_guard.MarkDirty();
+                UpdateFreeSpace(*target, target_page);
+                PageZone(*target).Add(fields);
+
+                RID old_rid = MakeRID(last, slot);
+                RID new_rid = MakeRID(*target, target_slot);
+                page.RemoveTuple(slot);
+                RemoveFromIndexes(fields, old_rid);
+                InsertIntoIndexes(fields, new_rid);
+                Log(LogRecordType::DELETE, old_rid);
+                Log(LogRecordType::INSERT, new_rid, std::move(payload));
+                ++stats.tuples_moved;
+            }
+            guard.MarkDirty();
+            if (page.GetTupleCount() > 0) {
+                UpdateFreeSpace(last, page);
+                break;
+            }
 
-        std::string line;
-        bool reading_schema = false;
-        bool reading_data = false;
-        bool reading_indexes = false;
+            guard.Release();
+            buffer_pool_->DeletePage(page_ids_.back());
+            page_ids_.pop_back();
+            if (page_zones_.size() > last) page_zones_.resize(last);
+            pages_by_free_space_.erase({page_free_space_[last], last});
+            page_free_space_.resize(last);
+            ++stats.blocks_freed;
+        }
+        return stats;
+    }
 
-        tuples_.clear();
+    void Table::Clear() {
+        for (PageId page_id : page_ids_) buffer_pool_->DeletePage(page_id);
+        page_ids_.clear();
+        page_zones_.clear();
+        page_free_space_.clear();
+        pages_by_free_space_.clear();
+        tuple_count_ = 0;
         indexes_.clear();
-        next_rid_ = 0;
+    }
 
-        Schema file_schema;
+    void Table::SaveToFile(const std::string& file_name) const {
+        BeginSnapshot();
+        try {
+            WriteSnapshot(file_name);
+        } catch (...) {
+            EndSnapshot();
+            throw;
+        }
+        EndSnapshot();
+    }
 
-        while (std::getline(in, line)) {
-            if (line == "SCHEMA") {
-                reading_schema = true;
-                reading_data = false;
-                reading_indexes = false;
-                continue;
-            } else if (line == "DATA") {
-                reading_schema = false;
-                reading_data = true;
-                reading_indexes = false;
-                continue;
-            } else if (line == "INDEXES") {
-                reading_schema = false;
-                reading_data = false;
-                reading_indexes = true;
-                continue;
-            }
+    lsn_t Table::BeginSnapshot() const {
+        std::unique_lock<std::mutex> lock(latch_);
+        snapshot_done_.wait(lock, [this] { return !snapshot_; });
 
-            if (reading_schema) {
-                std::istringstream ss(line);
-                std::string name;
-                std::string type_str;
-                if (std::getline(ss, name, ',') && std::getline(ss, type_str)) {
-                    DataType type = static_cast<DataType>(std::stoi(type_str));
-                    file_schema.InsertColumn(name, type);
-                }
-            } else if (reading_data) {
-                std::istringstream ss(line);
-                std::string rid_str;
-                if (!std::getline(ss, rid_str, ',')) continue;
-                RID rid = std::stoull(rid_str);
-
-                std::vector<Field> fields;
-                size_t column_index = 0;
-                std::string token;
-                while (column_index < file_schema.GetColumnCount()) {
-                    if (!std::getline(ss, token, ',')) throw std::runtime_error("Insufficient data fields in row");
-
-                    if (!token.empty() && token.front() == '"') {
-                        while (!token.empty() && token.back() != '"') {
-                            std::string next_token;
-                            if (!std::getline(ss, next_token, ',')) throw std::runtime_error("Unmatched quotes in string field");
-                            token += "," + next_token;
-                        }
-                        token = token.substr(1, token.size() - 2);
-                        size_t pos = 0;
-                        while ((pos = token.find("\"\"", pos)) != std::string::npos) {
-                            token.replace(pos, 2, "\"");
-                            ++pos;
-                        }
-                    }
+        auto state = std::make_unique<SnapshotState>();
+        state->page_count = page_ids_.size();
+        state->pages_written = 0;
+        state->lsn = log_manager_ ? log_manager_->GetLastLsn() : INVALID_LSN;
+        for (const auto& [name, index_info] : indexes_) {
+            state->indexes.push_back(IndexDefinition(name, index_info));
+        }
+        snapshot_ = std::move(state);
+        PrepareSnapshot();
+        return snapshot_->lsn;
+    }
 
-                    const auto& column = file_schema.GetColumn(column_index);
-                    if (column.type == DataType::INTEGER) fields.emplace_back(std::stoi(token));
-                    else if (column.type == DataType::DOUBLE) fields.emplace_back(std::stod(token));
-                    else if (column.type == DataType::VARCHAR) fields.emplace_back(token);
-                    ++column_index;
-                }
-                if (fields.size() != schema_.GetColumnCount()) throw std::runtime_error("Mismatch in number of fields while loading data");
-                if (rid >= next_rid_) next_rid_ = rid + 1;
-                tuples_[rid] = std::make_shared<Tuple>(schema_, fields);
-            } else if (reading_indexes) {
-                std::istringstream ss(line);
-                std::string name;
-                std::string column_index_str;
-                std::string data_type_str;
-                if (std::getline(ss, name, ',') && std::getline(ss, column_index_str, ',') && std::getline(ss, data_type_str)) {
-                    size_t column_index = std::stoul(column_index_str);
-                    DataType data_type = static_cast<DataType>(std::stoi(data_type_str));
-
-                    if (data_type == DataType::INTEGER) CreateIndex<int>(name, column_index, 3);
-                    else if (data_type == DataType::DOUBLE) CreateIndex<double>(name, column_index, 3);
-                    else if (data_type == DataType::VARCHAR) CreateIndex<std::string>(name, column_index, 3);
+    void Table::WriteSnapshot(const std::string& file_name) const {
+        size_t page_count;
+        lsn_t lsn;
+        std::vector<TableFileIndex> indexes;
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            if (!snapshot_) throw std::logic_error("No snapshot in progress");
+            page_count = snapshot_->page_count;
+            lsn = snapshot_->lsn;
+            indexes = snapshot_->indexes;
+        }
+
+        TableFileWriter writer(file_name, schema_, indexes);
+        std::string page_image;
+        for (size_t page_number = 0; page_number < page_count; ++page_number) {
+            {
+                // Only the page copy happens under the latch; decoding it does not block writers.
+                std::lock_guard<std::mutex> lock(latch_);
+                auto preserved = snapshot_->preserved_pages.find(page_number);
+                if (preserved != snapshot_->preserved_pages.end()) {
+                    page_image = std::move(preserved->second);
+                    snapshot_->preserved_pages.erase(preserved);
+                } else {
+                    PageGuard guard = FetchTablePage(page_number);
+                    page_image.assign(guard.GetData(), PAGE_SIZE);
                 }
+                snapshot_->pages_written = page_number + 1;
+            }
+
+            TablePage page(page_image.data());
+            for (SlotId slot = 0; slot < page.GetSlotCount(); ++slot) {
+                const char* data;
+                uint16_t size;
+                if (page.GetTuple(slot, data, size)) writer.AppendRow(MakeRID(page_number, slot), data, size);
             }
         }
-        in.close();
+        writer.Finish(lsn);
+    }
+
+    void Table::EndSnapshot() const {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            ReleaseSnapshot();
+            snapshot_.reset();
+        }
+        snapshot_done_.notify_all();
+    }
 
+    lsn_t Table::LoadFromFile(const std::string& file_name) {
+        TableFileReader reader(file_name);
+
+        const Schema& file_schema = reader.GetSchema();
         if (file_schema.GetColumnCount() != schema_.GetColumnCount()) throw std::runtime_error("Schema mismatch: different number of columns");
         for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
             const auto& table_column = schema_.GetColumn(i);
@@ -292,14 +748,43 @@ namespace storage {
                 throw std::runtime_error("Schema mismatch: column definitions do not match");
             }
         }
-    }
 
+        {
+            std::unique_lock<std::mutex> lock(latch_);
+            snapshot_done_.wait(lock, [this] { return !snapshot_; });
+            Clear();
+            std::function<void(size_t, const ZoneMap&)> add_zone;
+            if (GetStorage() == TableStorage::ROW) {
+                add_zone = [this](size_t page_number, const ZoneMap& zone) { PageZone(page_number).Add(zone); };
+            }
+            for (size_t block = 0; block < reader.GetBlockCount(); ++block) {
+                reader.ReadBlock(block, [this](RID rid, const char* data, size_t size) {
+                    RestoreTuple(rid, data, static_cast<uint16_t>(size), nullptr);
+                }, add_zone);
+            }
+            FinishRestore();
+        }
+
+        const auto& indexes = reader.GetIndexes();
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            const auto& index = indexes[i];
+            if (!reader.HasIndexRuns()) {
+                CreateIndex(index.name, index.column_indexes, index.degree, index.type, index.include_column_indexes);
+                continue;
+            }
+            if (index.data_type == DataType::INTEGER) RestoreIndex(index, reader.ReadIndexRun<int>(i));
+            else if (index.data_type == DataType::DOUBLE) RestoreIndex(index, reader.ReadIndexRun<double>(i));
+            else if (index.data_type == DataType::VARCHAR) RestoreIndex(index, reader.ReadIndexRun<std::string>(i));
+        }
+        return reader.GetSnapshotLsn();
+    }
 
-    template void Table::CreateIndex<int>(const std::string &name, size_t column_index, int degree);
-    template void Table::CreateIndex<double>(const std::string &name, size_t column_index, int degree);
-    template void Table::CreateIndex<std::string>(const std::string &name, size_t column_index, int degree);
 
     template std::shared_ptr<BPlusIndex<int>> Table::GetIndex<int>(const std::string &name) const;
     template std::shared_ptr<BPlusIndex<double>> Table::GetIndex<double>(const std::string &name) const;
     template std::shared_ptr<BPlusIndex<std::string>> Table::GetIndex<std::string>(const std::string &name) const;
+
+    template std::shared_ptr<HashIndex<int>> Table::GetHashIndex<int>(const std::string &name) const;
+    template std::shared_ptr<HashIndex<double>> Table::GetHashIndex<double>(const std::string &name) const;
+    template std::shared_ptr<HashIndex<std::string>> Table::GetHashIndex<std::string>(const std::string &name) const;
 }
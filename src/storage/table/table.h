@@ -3,54 +3,223 @@
 #include "schema.h"
 #include "tuple.h"
 #include "bplus_index.h"
+#include "hash_index.h"
+#include "index_key.h"
+#include "page.h"
+#include "table_page.h"
+#include "buffer_pool_manager.h"
+#include "log_manager.h"
+#include "table_file.h"
+#include "column_batch.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <utility>
 #include <vector>
 #include <unordered_map>
-#include <fstream>
-#include <sstream>
 #include <algorithm>
 
 namespace storage {
     using IndexVariant = std::variant<
             std::shared_ptr<BPlusIndex<int>>,
             std::shared_ptr<BPlusIndex<double>>,
-            std::shared_ptr<BPlusIndex<std::string>>
+            std::shared_ptr<BPlusIndex<std::string>>,
+            std::shared_ptr<HashIndex<int>>,
+            std::shared_ptr<HashIndex<double>>,
+            std::shared_ptr<HashIndex<std::string>>
     >;
 
+    // The high half of a RID is the page number within the table, not the buffer pool page id.
+    inline RID MakeRID(size_t page_number, SlotId slot) {
+        return (static_cast<RID>(page_number) << 32) | slot;
+    }
+
+    inline size_t GetRIDPageNumber(RID rid) {
+        return static_cast<size_t>(rid >> 32);
+    }
+
+    inline SlotId GetRIDSlot(RID rid) {
+        return static_cast<SlotId>(rid & 0xFFFFFFFFu);
+    }
+
+    enum class TableStorage : uint8_t {
+        ROW,
+        COLUMN
+    };
+
+    struct VacuumStats {
+        // Space of removed and shrunk tuples that became usable again.
+        size_t bytes_reclaimed = 0;
+        // Storage blocks (pages or row groups) given back once they held no live row.
+        size_t blocks_freed = 0;
+        size_t tuples_moved = 0;
+    };
+
     struct IndexInfo {
-        size_t column_index;
+        // Key columns in key order, then the included columns. An index on several columns is keyed by the
+        // encoded tuple (see MakeIndexKey), so the included values ride along in the entries after the key.
+        std::vector<size_t> column_indexes;
+        size_t key_column_count;
+        // Type of the entry keys: the column's type, or VARCHAR for several columns.
         DataType data_type;
+        int degree;
+        IndexType type;
         IndexVariant index;
     };
 
     class Table {
     public:
-        explicit Table(const Schema&  schema) : schema_(schema), next_rid_(0) {};
-        ~Table() = default;
+        explicit Table(const Schema& schema, std::shared_ptr<BufferPoolManager> buffer_pool = nullptr);
+        virtual ~Table();
+
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
 
         virtual RID InsertTuple(const std::vector<Field>& fields);
+        // Inserts rows like InsertTuple, taking the latch once for the whole batch.
+        virtual void InsertTuples(const std::vector<std::vector<Field>>& rows);
+        // Places a tuple at a known RID, e.g. when replaying the write-ahead log over a snapshot.
+        virtual void InsertTupleAt(RID rid, const std::vector<Field>& fields);
         [[nodiscard]] std::shared_ptr<Tuple> GetTuple(RID rid) const;
         virtual bool RemoveTuple(RID rid);
+        // A row that grows past the free space of its page is moved to another page under a new RID.
         virtual bool UpdateTuple(RID rid, const std::vector<Field>& fields);
-        [[nodiscard]] std::vector<RID> GetAllRID() const;
+        [[nodiscard]] virtual std::vector<RID> GetAllRID() const;
+        // Hands out the table in batches; columns[i] of every batch holds column column_indexes[i].
+        // With a predicate, only rows that satisfy it are handed out. Each block is read under the latch,
+        // so writers on other threads interleave with the scan between blocks.
+        virtual void Scan(const std::vector<size_t>& column_indexes, const ColumnPredicate* predicate,
+                          const std::function<void(const ColumnBatch&)>& consumer) const;
+        [[nodiscard]] virtual TableStorage GetStorage() const;
+        /*
+         * Compacts every page, then moves the tuples of the last page into free space of earlier
+         * pages and releases it, for as long as they fit. Index entries of a moved tuple are rewritten
+         * and the move is logged. The latch is taken per page, so other statements and a running
+         * checkpoint interleave; pages are only released while no snapshot is being written.
+         */
+        virtual VacuumStats Vacuum();
 
-        template<typename KeyType>
-        void CreateIndex(const std::string& name, size_t column_index, int degree);
+        // include_columns are stored in the entries, so a lookup that needs no other column skips the rows.
+        void CreateIndex(const std::string& name, const std::vector<size_t>& column_indexes, int degree,
+                         IndexType type = IndexType::BTREE, const std::vector<size_t>& include_columns = {});
 
         template<typename KeyType>
         std::shared_ptr<BPlusIndex<KeyType>> GetIndex(const std::string& name) const;
+        template<typename KeyType>
+        std::shared_ptr<HashIndex<KeyType>> GetHashIndex(const std::string& name) const;
+        [[nodiscard]] IndexType GetIndexType(const std::string& name) const;
+        // The key columns followed by the included ones.
+        [[nodiscard]] const std::vector<size_t>& GetIndexColumns(const std::string& name) const;
+        [[nodiscard]] size_t GetIndexKeyColumnCount(const std::string& name) const;
+        [[nodiscard]] std::vector<TableFileIndex> GetIndexDefinitions() const;
+        /*
+         * Between BeginBulkLoad and EndBulkLoad inserts leave the indexes alone and collect their
+         * entries instead; EndBulkLoad sorts them and adds them to each index in key order.
+         * Only meant for inserts: index lookups miss the collected rows until EndBulkLoad.
+         */
+        virtual void BeginBulkLoad();
+        virtual void EndBulkLoad();
 
-        [[nodiscard]] size_t GetRowCount() const;
+        [[nodiscard]] virtual size_t GetRowCount() const;
 
         const Schema& GetSchema() const;
+        [[nodiscard]] const SchemaRef& GetSchemaRef() const { return shared_schema_; }
 
         void SaveToFile(const std::string& file_name) const;
-        void LoadFromFile(const std::string& file_name);
+        // Returns the log position the loaded snapshot reflects.
+        lsn_t LoadFromFile(const std::string& file_name);
+
+        /*
+         * Snapshots are copy-on-write at page granularity: once BeginSnapshot returns,
+         * a writer copies a page aside before its first change to it, so WriteSnapshot
+         * sees the table as of BeginSnapshot while inserts, updates and deletes go on.
+         */
+        lsn_t BeginSnapshot() const;
+        virtual void WriteSnapshot(const std::string& file_name) const;
+        void EndSnapshot() const;
+
+        // Once attached, every insert, update and delete is appended to the write-ahead log.
+        void SetLogManager(std::shared_ptr<LogManager> log_manager, const std::string& table_name);
 
     protected:
-        const Schema schema_;
-        std::unordered_map<RID, std::shared_ptr<Tuple>> tuples_;
-        RID next_rid_;
+        const SchemaRef shared_schema_;
+        const Schema& schema_;
+        std::shared_ptr<BufferPoolManager> buffer_pool_;
+        std::vector<PageId> page_ids_;
+        // Zone map of every page, for scans to skip pages their predicate cannot match.
+        std::vector<ZoneMap> page_zones_;
+        // Usable space of every page, and the pages ordered by it for inserts to find a hole.
+        std::vector<size_t> page_free_space_;
+        std::set<std::pair<size_t, size_t>> pages_by_free_space_;
+        size_t tuple_count_;
         std::unordered_map<std::string, IndexInfo> indexes_;
+        bool bulk_loading_ = false;
+        std::unordered_map<std::string, std::vector<std::pair<Field, RID>>> bulk_index_entries_;
+        // Indexes being built from a scan, by name. They are registered before the scan and collect the
+        // entries writers add and remove meanwhile, which are applied once the built index is installed.
+        struct IndexChange {
+            bool inserted;
+            Field key;
+            RID rid;
+        };
+        struct IndexBuild {
+            std::vector<size_t> column_indexes;
+            std::vector<IndexChange> changes;
+        };
+        std::unordered_map<std::string, IndexBuild> building_indexes_;
+        std::shared_ptr<LogManager> log_manager_;
+        std::string table_name_;
+
+        struct SnapshotState {
+            size_t page_count;
+            size_t pages_written;
+            lsn_t lsn;
+            std::vector<TableFileIndex> indexes;
+            std::unordered_map<size_t, std::string> preserved_pages;
+        };
+
+        // Serializes writers against each other, a concurrent snapshot and the block reads of a scan.
+        mutable std::mutex latch_;
+        mutable std::condition_variable snapshot_done_;
+        mutable std::unique_ptr<SnapshotState> snapshot_;
+
+        // Storage hooks for other layouts. The latch is held while they run.
+        // fields is the decoded row when the caller already has it, or null.
+        virtual void RestoreTuple(RID rid, const char* data, uint16_t size, const std::vector<Field>* fields);
+        // Runs once a snapshot file has been restored tuple by tuple.
+        virtual void FinishRestore() {}
+        [[nodiscard]] virtual std::vector<Field> ReadFields(RID rid) const;
+        virtual void Clear();
+        virtual void PrepareSnapshot() const {}
+        virtual void ReleaseSnapshot() const {}
+
+        // Reads the key of every row with a column scan and installs the index built from them, together
+        // with the changes collected for it in building_indexes_ while the scan ran.
+        template<typename KeyType>
+        void BuildIndex(const std::string& name, const std::vector<size_t>& column_indexes, size_t key_column_count, int degree,
+                        IndexType type);
+        [[nodiscard]] DataType IndexKeyType(const std::vector<size_t>& column_indexes) const;
+        // Installs an index saved in a snapshot from its entries in key order, without reading any rows.
+        template<typename KeyType>
+        void RestoreIndex(const TableFileIndex& definition, const std::vector<std::pair<KeyType, RID>>& sorted_entries);
+        [[nodiscard]] static TableFileIndex IndexDefinition(const std::string& name, const IndexInfo& index_info);
+        void InsertIntoIndexes(const std::vector<Field>& fields, RID rid);
+        void RemoveFromIndexes(const std::vector<Field>& fields, RID rid);
+        void RecordBuildingIndexChanges(const std::vector<Field>& fields, RID rid, bool inserted);
+        void Log(LogRecordType type, RID rid, std::string payload = {});
+
+    private:
+        static constexpr size_t PRIVATE_BUFFER_POOL_SIZE = 64;
+
+        RID AppendTuple(const char* data, uint16_t size);
+        void PreserveForSnapshot(size_t page_number, const char* page_data);
+        [[nodiscard]] PageGuard FetchTablePage(size_t page_number) const;
+        ZoneMap& PageZone(size_t page_number);
+        void UpdateFreeSpace(size_t page_number, const TablePage& page);
+        // The page with the least usable space that still fits size bytes, other than exclude.
+        [[nodiscard]] std::optional<size_t> FindPageWithSpace(size_t size, size_t exclude) const;
     };
 }
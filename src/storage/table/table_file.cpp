@@ -0,0 +1,522 @@
+#include "table_file.h"
+#include "crc32.h"
+#include "column_encoding.h"
+#include "tuple_serializer.h"
+#include "index_key.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+
+namespace storage {
+    namespace {
+        constexpr char TABLE_FILE_MAGIC[8] = {'V', 'V', 'Q', 'T', 'A', 'B', 'L', 'E'};
+
+        struct FileHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t column_count;
+            uint64_t row_count;
+            uint64_t snapshot_lsn;
+            uint64_t metadata_offset;
+            uint64_t metadata_size;
+            uint64_t directory_offset;
+            uint32_t block_count;
+            uint32_t metadata_crc;
+            uint32_t header_crc;
+            uint32_t reserved;
+        };
+
+        size_t AlignUp(size_t value) {
+            return (value + 7) & ~static_cast<size_t>(7);
+        }
+
+        template<typename T>
+        void AppendValue(std::string& out, const T& value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void AppendString(std::string& out, const std::string& value) {
+            AppendValue(out, static_cast<uint16_t>(value.size()));
+            out.append(value);
+        }
+
+        ColumnVector ToColumnVector(DataType type, const std::string& data) {
+            if (type == INTEGER) {
+                std::vector<int> values(data.size() / sizeof(int32_t));
+                std::memcpy(values.data(), data.data(), values.size() * sizeof(int32_t));
+                return values;
+            }
+            std::vector<double> values(data.size() / sizeof(double));
+            std::memcpy(values.data(), data.data(), values.size() * sizeof(double));
+            return values;
+        }
+
+        // Widens zone to rows [begin, end) of a fixed-width column array.
+        template<typename T>
+        void AddToZone(ColumnZone& zone, const char* values, size_t begin, size_t end) {
+            std::optional<T> min;
+            std::optional<T> max;
+            for (size_t row = begin; row < end; ++row) {
+                T value;
+                std::memcpy(&value, values + row * sizeof(T), sizeof(T));
+                if constexpr (std::is_floating_point_v<T>) {
+                    if (std::isnan(value)) continue;
+                }
+                if (!min || value < *min) min = value;
+                if (!max || *max < value) max = value;
+            }
+            if (!min) return;
+            zone.Add(*min);
+            zone.Add(*max);
+        }
+
+        // The same for a VARCHAR column, given as end offsets of its values in heap.
+        void AddStringsToZone(ColumnZone& zone, const char* offsets, const char* heap, size_t begin, size_t end) {
+            auto value_at = [&](size_t row) {
+                uint32_t first = 0;
+                uint32_t last;
+                if (row > 0) std::memcpy(&first, offsets + (row - 1) * sizeof(uint32_t), sizeof(first));
+                std::memcpy(&last, offsets + row * sizeof(uint32_t), sizeof(last));
+                return std::string_view(heap + first, last - first);
+            };
+            std::string_view min = value_at(begin);
+            std::string_view max = min;
+            for (size_t row = begin + 1; row < end; ++row) {
+                std::string_view value = value_at(row);
+                if (value < min) min = value;
+                if (max < value) max = value;
+            }
+            zone.Add(std::string(min));
+            zone.Add(std::string(max));
+        }
+
+        class MetadataReader {
+        public:
+            MetadataReader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+            template<typename T>
+            T Read() {
+                T value;
+                Take(&value, sizeof(value));
+                return value;
+            }
+
+            std::string ReadString() {
+                auto length = Read<uint16_t>();
+                if (pos_ + length > end_) throw std::runtime_error("Corrupted table file metadata");
+                std::string value(pos_, length);
+                pos_ += length;
+                return value;
+            }
+
+        private:
+            const char* pos_;
+            const char* end_;
+
+            void Take(void* out, size_t size) {
+                if (pos_ + size > end_) throw std::runtime_error("Corrupted table file metadata");
+                std::memcpy(out, pos_, size);
+                pos_ += size;
+            }
+        };
+    }
+
+    TableFileWriter::TableFileWriter(std::string file_name, const Schema& schema, std::vector<TableFileIndex> indexes)
+            : file_name_(std::move(file_name)), temp_file_name_(file_name_ + ".tmp"), schema_(schema),
+              fd_(-1), offset_(0), row_count_(0), block_rows_(0),
+              columns_(schema.GetColumnCount()), heaps_(schema.GetColumnCount()),
+              indexes_(std::move(indexes)), index_entries_(indexes_.size()), index_fields_(0), finished_(false) {
+        for (const auto& index : indexes_) {
+            index_columns_.push_back(index.StoredColumns());
+            for (size_t column : index_columns_.back()) {
+                if (column >= schema_.GetColumnCount()) throw std::out_of_range("Column index out of range");
+                index_fields_ = std::max(index_fields_, column + 1);
+            }
+        }
+        fd_ = open(temp_file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw std::ios_base::failure("Failed to open file for writing");
+
+        FileHeader header{};
+        Write(&header, sizeof(header));
+    }
+
+    TableFileWriter::~TableFileWriter() {
+        if (fd_ >= 0) close(fd_);
+        if (!finished_) unlink(temp_file_name_.c_str());
+    }
+
+    void TableFileWriter::Write(const void *data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = write(fd_, bytes + done, size - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::ios_base::failure("Failed to write table file");
+            }
+            done += static_cast<size_t>(n);
+        }
+        offset_ += size;
+    }
+
+    void TableFileWriter::AppendRow(RID rid, const char *data, size_t size) {
+        AppendValue(rids_, rid);
+        const char* pos = data;
+        const char* end = data + size;
+        for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
+            switch (schema_.GetColumn(i).type) {
+                case INTEGER:
+                    if (pos + sizeof(int32_t) > end) throw std::runtime_error("Corrupted tuple data");
+                    columns_[i].append(pos, sizeof(int32_t));
+                    pos += sizeof(int32_t);
+                    break;
+                case DOUBLE:
+                    if (pos + sizeof(double) > end) throw std::runtime_error("Corrupted tuple data");
+                    columns_[i].append(pos, sizeof(double));
+                    pos += sizeof(double);
+                    break;
+                case VARCHAR: {
+                    uint16_t length;
+                    if (pos + sizeof(length) > end) throw std::runtime_error("Corrupted tuple data");
+                    std::memcpy(&length, pos, sizeof(length));
+                    pos += sizeof(length);
+                    if (pos + length > end) throw std::runtime_error("Corrupted tuple data");
+                    heaps_[i].append(pos, length);
+                    pos += length;
+                    AppendValue(columns_[i], static_cast<uint32_t>(heaps_[i].size()));
+                    break;
+                }
+            }
+        }
+        if (!indexes_.empty()) {
+            const char* field = data;
+            fields_.clear();
+            for (size_t column = 0; column < index_fields_; ++column) {
+                fields_.push_back(TupleSerializer::ReadField(schema_.GetColumn(column).type, field, end));
+            }
+            for (size_t i = 0; i < indexes_.size(); ++i) {
+                index_entries_[i].emplace_back(MakeIndexKey(index_columns_[i], fields_), rid);
+            }
+        }
+        ++row_count_;
+        if (++block_rows_ == TABLE_FILE_ROWS_PER_BLOCK) FlushBlock();
+    }
+
+    TableFileIndexRun TableFileWriter::WriteIndexRun(std::vector<std::pair<Field, RID>> &entries) {
+        std::sort(entries.begin(), entries.end());
+        std::string run;
+        for (const auto& [key, rid] : entries) {
+            std::visit([&run](const auto& value) {
+                using ValueType = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<ValueType, std::string>) AppendString(run, value);
+                else AppendValue(run, value);
+            }, key);
+            AppendValue(run, rid);
+        }
+        run.resize(AlignUp(run.size()), '\0');
+
+        TableFileIndexRun index_run{offset_, run.size(), entries.size(), common::Crc32(run.data(), run.size()), 0};
+        Write(run.data(), run.size());
+        entries.clear();
+        entries.shrink_to_fit();
+        return index_run;
+    }
+
+    void TableFileWriter::FlushBlock() {
+        if (block_rows_ == 0) return;
+
+        std::string block;
+        block.append(rids_);
+        rids_.clear();
+        std::string encoded;
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            block.resize(AlignUp(block.size()), '\0');
+            DataType type = schema_.GetColumn(i).type;
+            if (type == VARCHAR) {
+                block.append(columns_[i]);
+                block.append(heaps_[i]);
+            } else {
+                encoded.clear();
+                EncodedColumn::Encode(ToColumnVector(type, columns_[i])).Serialize(encoded);
+                AppendValue(block, static_cast<uint32_t>(encoded.size()));
+                block.append(encoded);
+            }
+            columns_[i].clear();
+            heaps_[i].clear();
+        }
+        block.resize(AlignUp(block.size()), '\0');
+
+        directory_.push_back({offset_, static_cast<uint32_t>(block.size()), block_rows_,
+                              common::Crc32(block.data(), block.size()), 0});
+        Write(block.data(), block.size());
+        block_rows_ = 0;
+    }
+
+    void TableFileWriter::Finish(uint64_t snapshot_lsn) {
+        FlushBlock();
+        std::vector<TableFileIndexRun> runs;
+        for (auto& entries : index_entries_) runs.push_back(WriteIndexRun(entries));
+
+        std::string metadata;
+        for (const auto& column : schema_.GetColumns()) {
+            AppendValue(metadata, static_cast<uint8_t>(column.type));
+            AppendString(metadata, column.name);
+        }
+        AppendValue(metadata, static_cast<uint32_t>(indexes_.size()));
+        for (size_t i = 0; i < indexes_.size(); ++i) {
+            AppendString(metadata, indexes_[i].name);
+            AppendValue(metadata, static_cast<uint32_t>(indexes_[i].column_indexes.size()));
+            for (size_t column : indexes_[i].column_indexes) AppendValue(metadata, static_cast<uint32_t>(column));
+            AppendValue(metadata, static_cast<uint8_t>(indexes_[i].data_type));
+            AppendValue(metadata, static_cast<int32_t>(indexes_[i].degree));
+            AppendValue(metadata, static_cast<uint8_t>(indexes_[i].type));
+            AppendValue(metadata, static_cast<uint32_t>(indexes_[i].include_column_indexes.size()));
+            for (size_t column : indexes_[i].include_column_indexes) AppendValue(metadata, static_cast<uint32_t>(column));
+            AppendValue(metadata, runs[i]);
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic));
+        header.version = TABLE_FILE_VERSION;
+        header.column_count = static_cast<uint32_t>(schema_.GetColumnCount());
+        header.row_count = row_count_;
+        header.snapshot_lsn = snapshot_lsn;
+        header.metadata_offset = offset_;
+        header.metadata_size = metadata.size();
+        Write(metadata.data(), metadata.size());
+
+        header.directory_offset = offset_;
+        header.block_count = static_cast<uint32_t>(directory_.size());
+        Write(directory_.data(), directory_.size() * sizeof(TableFileBlock));
+
+        header.metadata_crc = common::Crc32(metadata.data(), metadata.size());
+        header.metadata_crc = common::Crc32(directory_.data(), directory_.size() * sizeof(TableFileBlock), header.metadata_crc);
+        header.header_crc = common::Crc32(&header, sizeof(header));
+
+        if (pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || fsync(fd_) != 0) {
+            throw std::ios_base::failure("Failed to write table file");
+        }
+        close(fd_);
+        fd_ = -1;
+        if (rename(temp_file_name_.c_str(), file_name_.c_str()) != 0) throw std::ios_base::failure("Failed to replace table file");
+        finished_ = true;
+    }
+
+    TableFileReader::TableFileReader(const std::string &file_name) : data_(nullptr), size_(0), version_(0), row_count_(0), snapshot_lsn_(0) {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) throw std::ios_base::failure("Failed to open file for reading");
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::ios_base::failure("Failed to open file for reading");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ < sizeof(FileHeader)) {
+            close(fd);
+            throw std::runtime_error("Table file is truncated");
+        }
+        void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) throw std::ios_base::failure("Failed to map table file");
+        data_ = static_cast<const char*>(mapped);
+
+        try {
+            FileHeader header;
+            std::memcpy(&header, data_, sizeof(header));
+            if (std::memcmp(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic)) != 0) throw std::runtime_error("Not a table file");
+            if (header.version < 2 || header.version > TABLE_FILE_VERSION) throw std::runtime_error("Unsupported table file version");
+            version_ = header.version;
+
+            uint32_t header_crc = header.header_crc;
+            header.header_crc = 0;
+            if (common::Crc32(&header, sizeof(header)) != header_crc) throw std::runtime_error("Table file header checksum mismatch");
+
+            size_t directory_size = static_cast<size_t>(header.block_count) * sizeof(TableFileBlock);
+            if (header.metadata_offset + header.metadata_size > size_ ||
+                header.directory_offset + directory_size > size_) {
+                throw std::runtime_error("Table file is truncated");
+            }
+            uint32_t metadata_crc = common::Crc32(data_ + header.metadata_offset, header.metadata_size);
+            metadata_crc = common::Crc32(data_ + header.directory_offset, directory_size, metadata_crc);
+            if (metadata_crc != header.metadata_crc) throw std::runtime_error("Table file metadata checksum mismatch");
+
+            MetadataReader reader(data_ + header.metadata_offset, header.metadata_size);
+            for (uint32_t i = 0; i < header.column_count; ++i) {
+                auto type = static_cast<DataType>(reader.Read<uint8_t>());
+                std::string name = reader.ReadString();
+                schema_.InsertColumn(name, type);
+            }
+            auto index_count = reader.Read<uint32_t>();
+            for (uint32_t i = 0; i < index_count; ++i) {
+                TableFileIndex index;
+                index.name = reader.ReadString();
+                auto column_count = version_ >= 6 ? reader.Read<uint32_t>() : 1;
+                for (uint32_t column = 0; column < column_count; ++column) index.column_indexes.push_back(reader.Read<uint32_t>());
+                index.data_type = static_cast<DataType>(reader.Read<uint8_t>());
+                index.degree = reader.Read<int32_t>();
+                index.type = version_ >= 5 ? static_cast<IndexType>(reader.Read<uint8_t>()) : IndexType::BTREE;
+                auto include_count = version_ >= 7 ? reader.Read<uint32_t>() : 0;
+                for (uint32_t column = 0; column < include_count; ++column) index.include_column_indexes.push_back(reader.Read<uint32_t>());
+                if (version_ >= 4) {
+                    auto run = reader.Read<TableFileIndexRun>();
+                    if (run.offset + run.size > size_) throw std::runtime_error("Table file is truncated");
+                    index_runs_.push_back(run);
+                }
+                indexes_.push_back(std::move(index));
+            }
+
+            directory_.resize(header.block_count);
+            if (directory_size > 0) std::memcpy(directory_.data(), data_ + header.directory_offset, directory_size);
+            row_count_ = header.row_count;
+            snapshot_lsn_ = header.snapshot_lsn;
+        } catch (...) {
+            munmap(const_cast<char*>(data_), size_);
+            throw;
+        }
+    }
+
+    TableFileReader::~TableFileReader() {
+        if (data_) munmap(const_cast<char*>(data_), size_);
+    }
+
+    void TableFileReader::ReadBlock(size_t block, const std::function<void(RID, const char*, size_t)> &consumer,
+                                    const std::function<void(size_t, const ZoneMap&)> &zones) const {
+        const TableFileBlock& entry = directory_.at(block);
+        if (entry.offset + entry.size > size_) throw std::runtime_error("Table file is truncated");
+        const char* base = data_ + entry.offset;
+        if (common::Crc32(base, entry.size) != entry.crc) throw std::runtime_error("Table file block checksum mismatch");
+
+        size_t rows = entry.row_count;
+        std::vector<const char*> values(schema_.GetColumnCount());
+        std::vector<const char*> heaps(schema_.GetColumnCount(), nullptr);
+        std::vector<ColumnVector> decoded(schema_.GetColumnCount());
+        const char* rids = base;
+        size_t pos = rows * sizeof(RID);
+        for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
+            pos = AlignUp(pos);
+            values[i] = base + pos;
+            DataType type = schema_.GetColumn(i).type;
+            if (version_ >= 3 && type != VARCHAR) {
+                uint32_t encoded_size;
+                if (pos + sizeof(encoded_size) > entry.size) throw std::runtime_error("Corrupted table file block");
+                std::memcpy(&encoded_size, base + pos, sizeof(encoded_size));
+                pos += sizeof(encoded_size);
+                if (pos + encoded_size > entry.size) throw std::runtime_error("Corrupted table file block");
+                EncodedColumn column = EncodedColumn::Deserialize(type, base + pos, encoded_size);
+                if (column.Size() != rows) throw std::runtime_error("Corrupted table file block");
+                column.Decode(decoded[i]);
+                if (auto integers = std::get_if<std::vector<int>>(&decoded[i])) values[i] = reinterpret_cast<const char*>(integers->data());
+                else values[i] = reinterpret_cast<const char*>(std::get<std::vector<double>>(decoded[i]).data());
+                pos += encoded_size;
+                continue;
+            }
+            switch (type) {
+                case INTEGER:
+                    pos += rows * sizeof(int32_t);
+                    break;
+                case DOUBLE:
+                    pos += rows * sizeof(double);
+                    break;
+                case VARCHAR: {
+                    pos += rows * sizeof(uint32_t);
+                    if (pos > entry.size) throw std::runtime_error("Corrupted table file block");
+                    heaps[i] = base + pos;
+                    uint32_t heap_size = 0;
+                    if (rows > 0) std::memcpy(&heap_size, base + pos - sizeof(uint32_t), sizeof(heap_size));
+                    pos += heap_size;
+                    break;
+                }
+            }
+            if (pos > entry.size) throw std::runtime_error("Corrupted table file block");
+        }
+
+        std::string row;
+        for (size_t r = 0; r < rows; ++r) {
+            row.clear();
+            for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
+                switch (schema_.GetColumn(i).type) {
+                    case INTEGER:
+                        row.append(values[i] + r * sizeof(int32_t), sizeof(int32_t));
+                        break;
+                    case DOUBLE:
+                        row.append(values[i] + r * sizeof(double), sizeof(double));
+                        break;
+                    case VARCHAR: {
+                        uint32_t begin = 0;
+                        uint32_t end;
+                        if (r > 0) std::memcpy(&begin, values[i] + (r - 1) * sizeof(uint32_t), sizeof(begin));
+                        std::memcpy(&end, values[i] + r * sizeof(uint32_t), sizeof(end));
+                        if (begin > end || end - begin > UINT16_MAX) throw std::runtime_error("Corrupted table file block");
+                        AppendValue(row, static_cast<uint16_t>(end - begin));
+                        row.append(heaps[i] + begin, end - begin);
+                        break;
+                    }
+                }
+            }
+            RID rid;
+            std::memcpy(&rid, rids + r * sizeof(RID), sizeof(rid));
+            consumer(rid, row.data(), row.size());
+        }
+        if (!zones) return;
+
+        // The rows were checked above. Rows are written in RID order, so a page usually forms one run.
+        auto page_of = [rids](size_t r) {
+            RID rid;
+            std::memcpy(&rid, rids + r * sizeof(RID), sizeof(rid));
+            return static_cast<size_t>(rid >> 32);
+        };
+        for (size_t begin = 0, end; begin < rows; begin = end) {
+            size_t page_number = page_of(begin);
+            for (end = begin + 1; end < rows && page_of(end) == page_number; ++end) {}
+            ZoneMap zone;
+            zone.columns.resize(schema_.GetColumnCount());
+            for (size_t i = 0; i < schema_.GetColumnCount(); ++i) {
+                switch (schema_.GetColumn(i).type) {
+                    case INTEGER:
+                        AddToZone<int32_t>(zone.columns[i], values[i], begin, end);
+                        break;
+                    case DOUBLE:
+                        AddToZone<double>(zone.columns[i], values[i], begin, end);
+                        break;
+                    case VARCHAR:
+                        AddStringsToZone(zone.columns[i], values[i], heaps[i], begin, end);
+                        break;
+                }
+            }
+            zones(page_number, zone);
+        }
+    }
+
+    template<typename KeyType>
+    std::vector<std::pair<KeyType, RID>> TableFileReader::ReadIndexRun(size_t index) const {
+        const TableFileIndexRun& run = index_runs_.at(index);
+        const char* pos = data_ + run.offset;
+        const char* end = pos + run.size;
+        if (common::Crc32(pos, run.size) != run.crc) throw std::runtime_error("Table file index checksum mismatch");
+
+        DataType type = indexes_[index].data_type;
+        std::vector<std::pair<KeyType, RID>> entries;
+        entries.reserve(run.entry_count);
+        for (uint64_t i = 0; i < run.entry_count; ++i) {
+            Field key = TupleSerializer::ReadField(type, pos, end);
+            if (!std::holds_alternative<KeyType>(key) || pos + sizeof(RID) > end) throw std::runtime_error("Corrupted table file index");
+            RID rid;
+            std::memcpy(&rid, pos, sizeof(rid));
+            pos += sizeof(rid);
+            entries.emplace_back(std::move(std::get<KeyType>(key)), rid);
+        }
+        return entries;
+    }
+
+    template std::vector<std::pair<int, RID>> TableFileReader::ReadIndexRun<int>(size_t index) const;
+    template std::vector<std::pair<double, RID>> TableFileReader::ReadIndexRun<double>(size_t index) const;
+    template std::vector<std::pair<std::string, RID>> TableFileReader::ReadIndexRun<std::string>(size_t index) const;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "schema.h"
+#include "tuple.h"
+#include "index.h"
+#include "column_batch.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace storage {
+    /*
+     * Binary table snapshot, version 7:
+     *  | header | blocks ... | index runs ... | metadata (schema, indexes) | block directory |
+     * Each block holds up to ROWS_PER_BLOCK rows stored column by column: the RIDs
+     * first, then INTEGER and DOUBLE columns as a length-prefixed EncodedColumn, the
+     * encoding picked per block when it is flushed, and VARCHAR columns as an offset
+     * array into a string heap. Every index has a run of its (key, RID) entries in key
+     * order, keys encoded as by TupleSerializer, so loading builds it bottom-up instead
+     * of inserting every row. Every block, index run, the metadata and the header carry
+     * a CRC-32. The header records the log position the snapshot reflects, so recovery
+     * knows which log records are already contained in it. Version 2 files, with
+     * fixed-width numeric arrays, version 3 files, without index runs, version 4
+     * files, without index types (all B+trees), version 5 files, with single-column
+     * indexes only, and version 6 files, without included columns, are still read.
+     */
+    static constexpr uint32_t TABLE_FILE_VERSION = 7;
+    static constexpr uint32_t TABLE_FILE_ROWS_PER_BLOCK = 4096;
+
+    struct TableFileBlock {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t row_count;
+        uint32_t crc;
+        uint32_t reserved;
+    };
+
+    struct TableFileIndex {
+        std::string name;
+        std::vector<size_t> column_indexes;
+        // Type of the entry keys; see IndexInfo.
+        DataType data_type;
+        int degree;
+        IndexType type = IndexType::BTREE;
+        // Columns carried in the entries after the key columns, for index-only scans.
+        std::vector<size_t> include_column_indexes;
+
+        // The columns an entry key is made from: the key columns, then the included ones.
+        [[nodiscard]] std::vector<size_t> StoredColumns() const {
+            std::vector<size_t> columns = column_indexes;
+            columns.insert(columns.end(), include_column_indexes.begin(), include_column_indexes.end());
+            return columns;
+        }
+    };
+
+    struct TableFileIndexRun {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t entry_count;
+        uint32_t crc;
+        uint32_t reserved;
+    };
+
+    class TableFileWriter {
+    public:
+        // Rows appended are also collected into a sorted run for every index.
+        TableFileWriter(std::string file_name, const Schema& schema, std::vector<TableFileIndex> indexes = {});
+        ~TableFileWriter();
+
+        TableFileWriter(const TableFileWriter&) = delete;
+        TableFileWriter& operator=(const TableFileWriter&) = delete;
+
+        // Takes a row in the TupleSerializer wire format.
+        void AppendRow(RID rid, const char* data, size_t size);
+        void Finish(uint64_t snapshot_lsn);
+
+    private:
+        std::string file_name_;
+        std::string temp_file_name_;
+        const Schema& schema_;
+        int fd_;
+        uint64_t offset_;
+        uint64_t row_count_;
+        uint32_t block_rows_;
+        std::string rids_;
+        std::vector<std::string> columns_;
+        std::vector<std::string> heaps_;
+        std::vector<TableFileBlock> directory_;
+        std::vector<TableFileIndex> indexes_;
+        std::vector<std::vector<std::pair<Field, RID>>> index_entries_;
+        // The columns the entry keys of each index are made from.
+        std::vector<std::vector<size_t>> index_columns_;
+        // Leading fields of a row the index keys are made from, and a buffer for them.
+        size_t index_fields_;
+        std::vector<Field> fields_;
+        bool finished_;
+
+        void FlushBlock();
+        TableFileIndexRun WriteIndexRun(std::vector<std::pair<Field, RID>>& entries);
+        void Write(const void* data, size_t size);
+    };
+
+    class TableFileReader {
+    public:
+        explicit TableFileReader(const std::string& file_name);
+        ~TableFileReader();
+
+        TableFileReader(const TableFileReader&) = delete;
+        TableFileReader& operator=(const TableFileReader&) = delete;
+
+        [[nodiscard]] const Schema& GetSchema() const { return schema_; }
+        [[nodiscard]] uint64_t GetRowCount() const { return row_count_; }
+        [[nodiscard]] uint64_t GetSnapshotLsn() const { return snapshot_lsn_; }
+        [[nodiscard]] size_t GetBlockCount() const { return directory_.size(); }
+        [[nodiscard]] const std::vector<TableFileIndex>& GetIndexes() const { return indexes_; }
+        // Files before version 4 only record index definitions; their indexes are rebuilt from the rows.
+        [[nodiscard]] bool HasIndexRuns() const { return version_ >= 4; }
+
+        /*
+         * Verifies the block checksum and hands every row over in the TupleSerializer wire format. With zones,
+         * it then hands over the zone map of every run of rows on one page (the high half of their RIDs, see
+         * MakeRID), taken from the block's column arrays without decoding rows.
+         */
+        void ReadBlock(size_t block, const std::function<void(RID, const char*, size_t)>& consumer,
+                       const std::function<void(size_t, const ZoneMap&)>& zones = nullptr) const;
+        // Verifies the run checksum and returns the entries of an index in key order.
+        template<typename KeyType>
+        [[nodiscard]] std::vector<std::pair<KeyType, RID>> ReadIndexRun(size_t index) const;
+
+    private:
+        const char* data_;
+        size_t size_;
+        uint32_t version_;
+        Schema schema_;
+        uint64_t row_count_;
+        uint64_t snapshot_lsn_;
+        std::vector<TableFileIndex> indexes_;
+        std::vector<TableFileIndexRun> index_runs_;
+        std::vector<TableFileBlock> directory_;
+    };
+}
@@ -11,14 +11,21 @@ namespace storage {
     using RID = uint64_t;
     using Field = std::variant<int, double, std::string>;
 
+    // Passed by producers whose fields already have the types of the schema (table reads, and
+    // operators deriving their output from typed input) to skip checking every field.
+    struct TypeCheckedTag {};
+    inline constexpr TypeCheckedTag TYPE_CHECKED{};
+
     class Tuple {
     public:
-        Tuple(const Schema& schema, std::vector<Field>  fields) : schema_(schema), fields_(std::move(fields)) {
-            if (fields_.size() != schema_.GetColumnCount()) {
+        Tuple(SchemaRef schema, std::vector<Field> fields, TypeCheckedTag) : schema_(std::move(schema)), fields_(std::move(fields)) {}
+
+        Tuple(SchemaRef schema, std::vector<Field>  fields) : schema_(std::move(schema)), fields_(std::move(fields)) {
+            if (fields_.size() != schema_->GetColumnCount()) {
                 throw std::invalid_argument("Number of fields doesn't match schema");
             }
             for (size_t i = 0; i < fields_.size(); ++i) {
-                const Column& column = schema_.GetColumn(i);
+                const Column& column = schema_->GetColumn(i);
                 const Field& field = fields_[i];
 
                 switch (column.type) {
@@ -51,14 +58,18 @@ namespace storage {
         }
 
         size_t GetFieldIndex(const std::string& column_name) const {
-            return schema_.GetColumnIndex(column_name);
+            return schema_->GetColumnIndex(column_name);
         }
 
         const Schema& GetSchema() const {
+            return *schema_;
+        }
+
+        const SchemaRef& GetSchemaRef() const {
             return schema_;
         }
     private:
-        Schema schema_;
+        SchemaRef schema_;
         std::vector<Field> fields_;
     };
 }
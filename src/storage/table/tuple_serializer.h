@@ -0,0 +1,92 @@
+#pragma once
+
+#include "schema.h"
+#include "tuple.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace storage {
+    /*
+     * Packs tuple fields back to back without per-field tags: the schema already
+     * knows the types. INTEGER and DOUBLE are stored raw, VARCHAR as a 16-bit
+     * length followed by the bytes.
+     */
+    class TupleSerializer {
+    public:
+        static void Serialize(const Schema& schema, const std::vector<Field>& fields, std::string& out) {
+            out.clear();
+            for (size_t i = 0; i < schema.GetColumnCount(); ++i) {
+                const Field& field = fields[i];
+                switch (schema.GetColumn(i).type) {
+                    case INTEGER: {
+                        if (!std::holds_alternative<int>(field)) throw std::invalid_argument("Field type mismatch: expected INTEGER");
+                        int value = std::get<int>(field);
+                        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                        break;
+                    }
+                    case DOUBLE: {
+                        if (!std::holds_alternative<double>(field)) throw std::invalid_argument("Field type mismatch: expected DOUBLE");
+                        double value = std::get<double>(field);
+                        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                        break;
+                    }
+                    case VARCHAR: {
+                        if (!std::holds_alternative<std::string>(field)) throw std::invalid_argument("Field type mismatch: expected VARCHAR");
+                        const auto& value = std::get<std::string>(field);
+                        if (value.size() > UINT16_MAX) throw std::invalid_argument("VARCHAR value is too long");
+                        auto length = static_cast<uint16_t>(value.size());
+                        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                        out.append(value);
+                        break;
+                    }
+                    default:
+                        throw std::invalid_argument("Unknown column type in schema");
+                }
+            }
+        }
+
+        static std::vector<Field> Deserialize(const Schema& schema, const char* data, size_t size) {
+            std::vector<Field> fields;
+            fields.reserve(schema.GetColumnCount());
+            const char* pos = data;
+            const char* end = data + size;
+            for (const auto& column : schema.GetColumns()) {
+                fields.push_back(ReadField(column.type, pos, end));
+            }
+            return fields;
+        }
+
+        static Field ReadField(DataType type, const char*& pos, const char* end) {
+            switch (type) {
+                case INTEGER: {
+                    int value;
+                    Read(pos, end, &value, sizeof(value));
+                    return value;
+                }
+                case DOUBLE: {
+                    double value;
+                    Read(pos, end, &value, sizeof(value));
+                    return value;
+                }
+                case VARCHAR: {
+                    uint16_t length;
+                    Read(pos, end, &length, sizeof(length));
+                    if (pos + length > end) throw std::runtime_error("Corrupted tuple data");
+                    std::string value(pos, length);
+                    pos += length;
+                    return value;
+                }
+                default:
+                    throw std::invalid_argument("Unknown column type in schema");
+            }
+        }
+
+    private:
+        static void Read(const char*& pos, const char* end, void* out, size_t size) {
+            if (pos + size > end) throw std::runtime_error("Corrupted tuple data");
+            std::memcpy(out, pos, size);
+            pos += size;
+        }
+    };
+}